@@ -0,0 +1,107 @@
+#include <Babylon/Graphics.h>
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    constexpr const char* USAGE{
+        "Usage: FrameLoopBenchmark [--seconds <count>]\n"
+        "\n"
+        "Runs the frame loop of the X11 Playground with bgfx's no-op renderer and nothing requested by JavaScript,\n"
+        "as for a static scene, once with idle frame skipping disabled and once with it enabled. Reports the frames\n"
+        "rendered and the CPU time used by each. Needs no GPU or window.\n"
+        "\n"
+        "  seconds  Duration of each run. Defaults to 5.\n"};
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Result
+    {
+        uint32_t Frames{};
+        double CpuMs{};
+        double WallMs{};
+    };
+
+    Result Run(Babylon::Graphics& graphics, bool idleFrameSkipping, std::chrono::seconds duration)
+    {
+        if (idleFrameSkipping)
+        {
+            graphics.EnableIdleFrameSkipping();
+        }
+        else
+        {
+            graphics.DisableIdleFrameSkipping();
+        }
+
+        const uint32_t firstFrame{graphics.GetFrameStatistics().FrameNumber};
+        const std::clock_t cpuStart{std::clock()};
+        const auto wallStart{Clock::now()};
+
+        while (Clock::now() - wallStart < duration)
+        {
+            graphics.FinishRenderingCurrentFrame();
+            graphics.StartRenderingCurrentFrame();
+            graphics.WaitForPendingFrameWork(std::chrono::milliseconds{16});
+        }
+
+        Result result{};
+        result.Frames = graphics.GetFrameStatistics().FrameNumber - firstFrame;
+        result.CpuMs = 1000.0 * (std::clock() - cpuStart) / CLOCKS_PER_SEC;
+        result.WallMs = std::chrono::duration<double, std::milli>(Clock::now() - wallStart).count();
+        return result;
+    }
+
+    void Print(const char* name, const Result& result)
+    {
+        std::printf("%-10s %10u %12.1f %12.1f %10.1f%%\n", name, result.Frames, result.CpuMs, result.WallMs, 100.0 * result.CpuMs / result.WallMs);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::chrono::seconds duration{5};
+
+    try
+    {
+        for (int index = 1; index < argc; ++index)
+        {
+            const std::string argument{argv[index]};
+            if (argument == "--seconds" && index + 1 < argc)
+            {
+                duration = std::chrono::seconds{std::stoul(argv[++index])};
+            }
+            else
+            {
+                std::cerr << USAGE;
+                return 1;
+            }
+        }
+    }
+    catch (const std::exception&)
+    {
+        std::cerr << USAGE;
+        return 1;
+    }
+
+    auto graphics{Babylon::Graphics::CreateGraphics<void*, size_t, size_t>(nullptr, 1280, 720)};
+    graphics->SetRenderer(Babylon::Graphics::Renderer::Noop);
+    graphics->StartRenderingCurrentFrame();
+
+    // The no-op renderer does not wait for vsync, so the run without skipping is an upper bound of the cost of
+    // presenting identical frames.
+    const Result busy{Run(*graphics, false, duration)};
+    const Result idle{Run(*graphics, true, duration)};
+
+    graphics->FinishRenderingCurrentFrame();
+
+    std::printf("%-10s %10s %12s %12s %11s\n", "Skipping", "Frames", "CPU (ms)", "Wall (ms)", "CPU");
+    Print("disabled", busy);
+    Print("enabled", idle);
+
+    return 0;
+}
@@ -105,6 +105,9 @@ namespace
         auto height = static_cast<size_t>(rect.bottom - rect.top);
 
         graphics = Babylon::Graphics::CreateGraphics<void*>(hWnd, width, height);
+
+        // Stop presenting identical frames once the scene stops requesting animation frames.
+        graphics->EnableIdleFrameSkipping();
         graphics->StartRenderingCurrentFrame();
 
         runtime = std::make_unique<Babylon::AppRuntime>();
@@ -204,6 +207,12 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
             {
                 graphics->FinishRenderingCurrentFrame();
                 graphics->StartRenderingCurrentFrame();
+
+                // Returns immediately unless idle frame skipping is enabled. The timeout keeps window messages flowing.
+                if (!PeekMessage(&msg, nullptr, 0, 0, PM_NOREMOVE))
+                {
+                    graphics->WaitForPendingFrameWork(std::chrono::milliseconds{16});
+                }
             }
 
             result = PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE) && msg.message != WM_QUIT;
@@ -64,6 +64,9 @@ namespace
 
         // Separately call reset and make_unique to ensure prior state is destroyed before new one is created.
         graphics = Babylon::Graphics::CreateGraphics((void*)(uintptr_t)window, static_cast<size_t>(width), static_cast<size_t>(height));
+
+        // Stop presenting identical frames once the scene stops requesting animation frames.
+        graphics->EnableIdleFrameSkipping();
         graphics->StartRenderingCurrentFrame();
         
         runtime = std::make_unique<Babylon::AppRuntime>();
@@ -198,6 +201,9 @@ int main(int _argc, const char* const* _argv)
         {
             graphics->FinishRenderingCurrentFrame();
             graphics->StartRenderingCurrentFrame();
+
+            // Returns immediately unless idle frame skipping is enabled. The timeout keeps X events flowing.
+            graphics->WaitForPendingFrameWork(std::chrono::milliseconds{16});
         }
         else
         {
@@ -0,0 +1,162 @@
+#define DIFFUSE
+#define DIFFUSEDIRECTUV 0
+#define NORMAL
+#define UV1
+#define NUM_BONE_INFLUENCERS 4
+#define BonesPerMesh 32
+#define LIGHT0
+#define DIRLIGHT0
+#define SHADOW0
+#define SHADOWPCF0
+#define LIGHT1
+#define POINTLIGHT1
+#define FOG
+
+precision highp float;
+
+uniform vec4 vEyePosition;
+uniform vec4 vDiffuseColor;
+uniform vec4 vSpecularColor;
+uniform vec3 vEmissiveColor;
+uniform vec3 vAmbientColor;
+uniform float visibility;
+uniform vec2 vDiffuseInfos;
+
+uniform vec4 vLightData0;
+uniform vec4 vLightDiffuse0;
+uniform vec4 vLightSpecular0;
+uniform vec4 shadowsInfo0;
+uniform vec4 vLightData1;
+uniform vec4 vLightDiffuse1;
+uniform vec4 vLightSpecular1;
+
+uniform vec4 vFogInfos;
+uniform vec3 vFogColor;
+
+uniform sampler2D diffuseSampler;
+uniform sampler2D shadowSampler0;
+
+in vec3 vPositionW;
+in vec3 vNormalW;
+in vec2 vDiffuseUV;
+in vec3 vFogDistance;
+in vec4 vPositionFromLight0;
+in float vDepthMetric0;
+
+out vec4 glFragColor;
+
+struct lightingInfo {
+    vec3 diffuse;
+    vec3 specular;
+};
+
+lightingInfo computeLighting(vec3 viewDirectionW, vec3 vNormal, vec4 lightData, vec3 diffuseColor, vec3 specularColor, float range, float glossiness) {
+    lightingInfo result;
+    vec3 lightVectorW;
+    float attenuation = 1.0;
+    if (lightData.w == 0.) {
+        vec3 direction = lightData.xyz - vPositionW;
+        attenuation = max(0., 1.0 - length(direction) / range);
+        lightVectorW = normalize(direction);
+    } else {
+        lightVectorW = normalize(-lightData.xyz);
+    }
+
+    float ndl = max(0., dot(vNormal, lightVectorW));
+    result.diffuse = ndl * diffuseColor * attenuation;
+
+    vec3 angleW = normalize(viewDirectionW + lightVectorW);
+    float specComp = max(0., dot(vNormal, angleW));
+    specComp = pow(specComp, max(1., glossiness));
+    result.specular = specComp * specularColor * attenuation;
+    return result;
+}
+
+float unpack(vec4 color) {
+    const vec4 bit_shift = vec4(1.0 / (255.0 * 255.0 * 255.0), 1.0 / (255.0 * 255.0), 1.0 / 255.0, 1.0);
+    return dot(color, bit_shift);
+}
+
+float computeFallOff(float value, vec2 clipSpace, float frustumEdgeFalloff) {
+    float mask = smoothstep(1.0 - frustumEdgeFalloff, 1.00000012, clamp(dot(clipSpace, clipSpace), 0., 1.));
+    return mix(value, 1.0, mask);
+}
+
+float computeShadowWithPoissonSampling0() {
+    vec3 clipSpace = vPositionFromLight0.xyz / vPositionFromLight0.w;
+    vec2 uv = 0.5 * clipSpace.xy + vec2(0.5);
+    if (uv.x < 0. || uv.x > 1.0 || uv.y < 0. || uv.y > 1.0) {
+        return 1.0;
+    }
+
+    float shadowPixelDepth = clamp(vDepthMetric0, 0., 1.0);
+    vec2 poissonDisk[4] = vec2[](
+        vec2(-0.94201624, -0.39906216),
+        vec2(0.94558609, -0.76890725),
+        vec2(-0.094184101, -0.92938870),
+        vec2(0.34495938, 0.29387760));
+
+    float lit = 1.;
+    for (int i = 0; i < 4; i++) {
+        if (unpack(texture(shadowSampler0, uv + poissonDisk[i] * shadowsInfo0.y)) < shadowPixelDepth) {
+            lit -= 0.25;
+        }
+    }
+
+    return computeFallOff(min(1.0, lit + shadowsInfo0.x), clipSpace.xy, shadowsInfo0.z);
+}
+
+float CalcFogFactor() {
+    float fogDistance = length(vFogDistance);
+    float fogCoeff = 1.0;
+    float fogStart = vFogInfos.y;
+    float fogEnd = vFogInfos.z;
+    float fogDensity = vFogInfos.w;
+    if (vFogInfos.x == 1.0) {
+        fogCoeff = 1.0 / pow(2.71828, fogDistance * fogDensity);
+    } else if (vFogInfos.x == 2.0) {
+        fogCoeff = 1.0 / pow(2.71828, fogDistance * fogDistance * fogDensity * fogDensity);
+    } else if (vFogInfos.x == 3.0) {
+        fogCoeff = (fogEnd - fogDistance) / (fogEnd - fogStart);
+    }
+
+    return clamp(fogCoeff, 0.0, 1.0);
+}
+
+void main(void) {
+    vec3 viewDirectionW = normalize(vEyePosition.xyz - vPositionW);
+    vec4 baseColor = vec4(1., 1., 1., 1.);
+    vec3 diffuseColor = vDiffuseColor.rgb;
+    float alpha = vDiffuseColor.a;
+    vec3 normalW = normalize(vNormalW);
+
+    baseColor = texture(diffuseSampler, vDiffuseUV);
+    baseColor.rgb *= vDiffuseInfos.y;
+
+    vec3 baseAmbientColor = vec3(1., 1., 1.);
+    float glossiness = vSpecularColor.a;
+    vec3 diffuseBase = vec3(0., 0., 0.);
+    vec3 specularBase = vec3(0., 0., 0.);
+    float shadow = 1.;
+    lightingInfo info;
+
+    info = computeLighting(viewDirectionW, normalW, vLightData0, vLightDiffuse0.rgb, vLightSpecular0.rgb, vLightDiffuse0.a, glossiness);
+    shadow = computeShadowWithPoissonSampling0();
+    diffuseBase += info.diffuse * shadow;
+    specularBase += info.specular * shadow;
+
+    info = computeLighting(viewDirectionW, normalW, vLightData1, vLightDiffuse1.rgb, vLightSpecular1.rgb, vLightDiffuse1.a, glossiness);
+    diffuseBase += info.diffuse;
+    specularBase += info.specular;
+
+    vec3 finalDiffuse = clamp(diffuseBase * diffuseColor + vEmissiveColor + vAmbientColor, 0.0, 1.0) * baseColor.rgb;
+    vec3 finalSpecular = specularBase * vSpecularColor.rgb;
+    vec4 color = vec4(finalDiffuse * baseAmbientColor + finalSpecular, alpha * baseColor.a);
+    color = max(color, 0.0);
+
+    float fog = CalcFogFactor();
+    color.rgb = mix(vFogColor, color.rgb, fog);
+
+    color.a *= visibility;
+    glFragColor = color;
+}
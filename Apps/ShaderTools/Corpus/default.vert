@@ -0,0 +1,64 @@
+#define DIFFUSE
+#define DIFFUSEDIRECTUV 0
+#define NORMAL
+#define UV1
+#define NUM_BONE_INFLUENCERS 4
+#define BonesPerMesh 32
+#define LIGHT0
+#define DIRLIGHT0
+#define SHADOW0
+#define SHADOWPCF0
+#define LIGHT1
+#define POINTLIGHT1
+#define FOG
+
+precision highp float;
+
+in vec3 position;
+in vec3 normal;
+in vec2 uv;
+in vec4 matricesIndices;
+in vec4 matricesWeights;
+
+uniform mat4 world;
+uniform mat4 view;
+uniform mat4 viewProjection;
+uniform mat4 diffuseMatrix;
+uniform mat4 mBones[BonesPerMesh];
+uniform mat4 lightMatrix0;
+uniform vec2 depthValues0;
+
+out vec3 vPositionW;
+out vec3 vNormalW;
+out vec2 vDiffuseUV;
+out vec3 vFogDistance;
+out vec4 vPositionFromLight0;
+out float vDepthMetric0;
+
+void main(void) {
+    vec3 positionUpdated = position;
+    vec3 normalUpdated = normal;
+    vec2 uvUpdated = uv;
+
+    mat4 finalWorld = world;
+    mat4 influence;
+    influence = mBones[int(matricesIndices[0])] * matricesWeights[0];
+    influence += mBones[int(matricesIndices[1])] * matricesWeights[1];
+    influence += mBones[int(matricesIndices[2])] * matricesWeights[2];
+    influence += mBones[int(matricesIndices[3])] * matricesWeights[3];
+    finalWorld = finalWorld * influence;
+
+    vec4 worldPos = finalWorld * vec4(positionUpdated, 1.0);
+    gl_Position = viewProjection * worldPos;
+    vPositionW = vec3(worldPos);
+
+    mat3 normalWorld = mat3(finalWorld);
+    vNormalW = normalize(normalWorld * normalUpdated);
+
+    vDiffuseUV = vec2(diffuseMatrix * vec4(uvUpdated, 1.0, 0.0));
+
+    vFogDistance = (view * worldPos).xyz;
+
+    vPositionFromLight0 = lightMatrix0 * worldPos;
+    vDepthMetric0 = ((vPositionFromLight0.z + depthValues0.x) / depthValues0.y);
+}
@@ -0,0 +1,19 @@
+#define ALPHATEST
+
+precision highp float;
+
+in vec2 vUV;
+
+uniform sampler2D textureSampler;
+uniform vec4 color;
+
+out vec4 glFragColor;
+
+void main(void) {
+    vec4 baseColor = texture(textureSampler, vUV);
+    if (baseColor.a < 0.4) {
+        discard;
+    }
+
+    glFragColor = baseColor * color;
+}
@@ -0,0 +1,18 @@
+#define BLENDMULTIPLYMODE 0
+#define BILLBOARD
+
+precision highp float;
+
+in vec2 vUV;
+in vec4 vColor;
+
+uniform vec4 textureMask;
+uniform sampler2D diffuseSampler;
+
+out vec4 glFragColor;
+
+void main(void) {
+    vec4 textureColor = texture(diffuseSampler, vUV);
+    vec4 baseColor = (textureColor * textureMask + (vec4(1., 1., 1., 1.) - textureMask)) * vColor;
+    glFragColor = baseColor;
+}
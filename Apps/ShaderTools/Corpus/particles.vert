@@ -0,0 +1,34 @@
+#define BLENDMULTIPLYMODE 0
+#define BILLBOARD
+
+precision highp float;
+
+in vec3 position;
+in vec4 color;
+in float angle;
+in vec2 size;
+in vec2 offset;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform mat4 textureMatrix;
+uniform vec2 translationPivot;
+
+out vec2 vUV;
+out vec4 vColor;
+
+void main(void) {
+    vec2 cornerPos = (vec2(offset.x - 0.5, offset.y - 0.5) - translationPivot) * size;
+
+    vec3 rotatedCorner;
+    rotatedCorner.x = cornerPos.x * cos(angle) - cornerPos.y * sin(angle);
+    rotatedCorner.y = cornerPos.x * sin(angle) + cornerPos.y * cos(angle);
+    rotatedCorner.z = 0.;
+    rotatedCorner.xy += translationPivot;
+
+    vec3 viewPos = (view * vec4(position, 1.0)).xyz + rotatedCorner;
+    gl_Position = projection * vec4(viewPos, 1.0);
+
+    vColor = color;
+    vUV = (textureMatrix * vec4(offset, 0.0, 1.0)).xy;
+}
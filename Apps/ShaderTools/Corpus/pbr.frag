@@ -0,0 +1,264 @@
+#define PBR
+#define ALBEDO
+#define ALBEDODIRECTUV 0
+#define METALLICWORKFLOW
+#define REFLECTIVITY
+#define METALLNESSSTOREINMETALMAPBLUE
+#define ROUGHNESSSTOREINMETALMAPGREEN
+#define BUMP
+#define BUMPDIRECTUV 0
+#define NORMAL
+#define UV1
+#define REFLECTION
+#define REFLECTIONMAP_3D
+#define REFLECTIONMAP_CUBIC
+#define USESPHERICALFROMREFLECTIONMAP
+#define USESPHERICALINVERTEX
+#define ENVIRONMENTBRDF
+#define LIGHT0
+#define DIRLIGHT0
+#define IMAGEPROCESSING
+#define TONEMAPPING
+#define CONTRAST
+#define EXPOSURE
+
+precision highp float;
+
+#define RECIPROCAL_PI 0.3183098861837907
+#define PI 3.1415926535897932384626433832795
+#define LinearEncodePowerApprox 2.2
+#define GammaEncodePowerApprox 0.45454545454545454545454545454545
+#define Epsilon 0.0000001
+#define MINIMUMVARIANCE 0.0005
+
+uniform vec4 vEyePosition;
+uniform vec3 vReflectionColor;
+uniform vec4 vAlbedoColor;
+uniform vec4 vLightingIntensity;
+uniform vec4 vReflectivityColor;
+uniform vec4 vMetallicReflectanceFactors;
+uniform vec3 vEmissiveColor;
+uniform float visibility;
+uniform vec2 vAlbedoInfos;
+uniform vec3 vBumpInfos;
+uniform vec2 vTangentSpaceParams;
+uniform vec2 vReflectionInfos;
+uniform vec3 vReflectionMicrosurfaceInfos;
+uniform mat4 reflectionMatrix;
+
+uniform vec4 vLightData0;
+uniform vec4 vLightDiffuse0;
+uniform vec4 vLightSpecular0;
+
+uniform float exposureLinear;
+uniform float contrast;
+
+uniform sampler2D albedoSampler;
+uniform sampler2D reflectivitySampler;
+uniform sampler2D bumpSampler;
+uniform samplerCube reflectionSampler;
+uniform sampler2D environmentBrdfSampler;
+
+in vec3 vPositionW;
+in vec3 vNormalW;
+in vec2 vAlbedoUV;
+in vec2 vBumpUV;
+in vec3 vEnvironmentIrradiance;
+
+out vec4 glFragColor;
+
+struct lightingInfo {
+    vec3 diffuse;
+    vec3 specular;
+};
+
+float square(float value) {
+    return value * value;
+}
+
+float saturate(float x) {
+    return clamp(x, 0.0, 1.0);
+}
+
+vec3 saturate(vec3 x) {
+    return clamp(x, 0.0, 1.0);
+}
+
+float absEps(float x) {
+    return abs(x) + Epsilon;
+}
+
+vec3 toLinearSpace(vec3 color) {
+    return pow(color, vec3(LinearEncodePowerApprox));
+}
+
+vec3 toGammaSpace(vec3 color) {
+    return pow(color, vec3(GammaEncodePowerApprox));
+}
+
+mat3 cotangent_frame(vec3 normal, vec3 p, vec2 uv, vec2 tangentSpaceParams) {
+    vec3 dp1 = dFdx(p);
+    vec3 dp2 = dFdy(p);
+    vec2 duv1 = dFdx(uv);
+    vec2 duv2 = dFdy(uv);
+
+    vec3 dp2perp = cross(dp2, normal);
+    vec3 dp1perp = cross(normal, dp1);
+    vec3 tangent = dp2perp * duv1.x + dp1perp * duv2.x;
+    vec3 bitangent = dp2perp * duv1.y + dp1perp * duv2.y;
+
+    tangent *= tangentSpaceParams.x;
+    bitangent *= tangentSpaceParams.y;
+
+    float invmax = inversesqrt(max(dot(tangent, tangent), dot(bitangent, bitangent)));
+    return mat3(tangent * invmax, bitangent * invmax, normal);
+}
+
+vec3 perturbNormal(mat3 cotangentFrame, vec3 textureSample, float scale) {
+    textureSample = textureSample * 2.0 - 1.0;
+    textureSample = normalize(textureSample * vec3(scale, scale, 1.0));
+    return normalize(cotangentFrame * textureSample);
+}
+
+float convertRoughnessToAverageSlope(float roughness) {
+    return square(roughness) + MINIMUMVARIANCE;
+}
+
+float getLodFromAlphaG(float cubeMapDimensionPixels, float microsurfaceAverageSlope) {
+    float microsurfaceAverageSlopeTexels = cubeMapDimensionPixels * microsurfaceAverageSlope;
+    return log2(microsurfaceAverageSlopeTexels);
+}
+
+float normalDistributionFunction_TrowbridgeReitzGGX(float NdotH, float alphaG) {
+    float a2 = square(alphaG);
+    float d = NdotH * NdotH * (a2 - 1.0) + 1.0;
+    return a2 / (PI * d * d);
+}
+
+float smithVisibility_GGXCorrelated(float NdotL, float NdotV, float alphaG) {
+    float a2 = alphaG * alphaG;
+    float GGXV = NdotL * sqrt(NdotV * (NdotV - a2 * NdotV) + a2);
+    float GGXL = NdotV * sqrt(NdotL * (NdotL - a2 * NdotL) + a2);
+    return 0.5 / (GGXV + GGXL);
+}
+
+vec3 fresnelSchlickGGX(float VdotH, vec3 reflectance0, vec3 reflectance90) {
+    return reflectance0 + (reflectance90 - reflectance0) * pow(1.0 - VdotH, 5.0);
+}
+
+vec3 getEnergyConservationFactor(vec3 specularEnvironmentR0, vec3 environmentBrdf) {
+    return 1.0 + specularEnvironmentR0 * (1.0 / environmentBrdf.y - 1.0);
+}
+
+vec3 getReflectanceFromBRDFLookup(vec3 specularEnvironmentR0, vec3 specularEnvironmentR90, vec3 environmentBrdf) {
+    return (specularEnvironmentR90 - specularEnvironmentR0) * environmentBrdf.x + specularEnvironmentR0 * environmentBrdf.y;
+}
+
+lightingInfo computeDirectionalLighting(vec3 N, vec3 V, vec3 L, vec3 diffuseColor, vec3 specularColor, float alphaG, vec3 reflectance0, vec3 reflectance90) {
+    lightingInfo result;
+    vec3 H = normalize(V + L);
+    float NdotL = clamp(dot(N, L), 0.000000000001, 1.0);
+    float NdotV = absEps(dot(N, V));
+    float NdotH = saturate(dot(N, H));
+    float VdotH = saturate(dot(V, H));
+
+    vec3 fresnel = fresnelSchlickGGX(VdotH, reflectance0, reflectance90);
+    float distribution = normalDistributionFunction_TrowbridgeReitzGGX(NdotH, alphaG);
+    float smithVisibility = smithVisibility_GGXCorrelated(NdotL, NdotV, alphaG);
+
+    result.diffuse = diffuseColor * NdotL;
+    result.specular = fresnel * distribution * smithVisibility * NdotL * specularColor;
+    return result;
+}
+
+vec3 applyImageProcessing(vec3 rgb) {
+    rgb *= exposureLinear;
+
+    const float tonemappingCalibration = 1.590579;
+    rgb = 1.0 - exp2(-tonemappingCalibration * rgb);
+
+    rgb = toGammaSpace(rgb);
+    rgb = saturate(rgb);
+
+    vec3 resultHighContrast = rgb * rgb * (3.0 - 2.0 * rgb);
+    if (contrast < 1.0) {
+        rgb = mix(vec3(0.5, 0.5, 0.5), rgb, contrast);
+    } else {
+        rgb = mix(rgb, resultHighContrast, contrast - 1.0);
+    }
+
+    return rgb;
+}
+
+void main(void) {
+    vec3 viewDirectionW = normalize(vEyePosition.xyz - vPositionW);
+    vec3 normalW = normalize(vNormalW);
+
+    mat3 TBN = cotangent_frame(normalW, vPositionW, vBumpUV, vTangentSpaceParams);
+    normalW = perturbNormal(TBN, texture(bumpSampler, vBumpUV).xyz, vBumpInfos.y);
+    normalW = gl_FrontFacing ? normalW : -normalW;
+
+    vec3 surfaceAlbedo = vAlbedoColor.rgb;
+    float alpha = vAlbedoColor.a;
+    vec4 albedoTexture = texture(albedoSampler, vAlbedoUV);
+    surfaceAlbedo *= toLinearSpace(albedoTexture.rgb);
+    surfaceAlbedo *= vAlbedoInfos.y;
+    alpha *= albedoTexture.a;
+
+    vec2 metallicRoughness = vReflectivityColor.rg;
+    vec4 surfaceMetallicColorMap = texture(reflectivitySampler, vAlbedoUV);
+    metallicRoughness.r *= surfaceMetallicColorMap.b;
+    metallicRoughness.g *= surfaceMetallicColorMap.g;
+
+    float metallic = metallicRoughness.r;
+    float roughness = clamp(metallicRoughness.g, 0.0, 1.0);
+    vec3 dielectricF0 = vMetallicReflectanceFactors.rgb;
+    vec3 baseColor = surfaceAlbedo;
+    vec3 surfaceReflectivityColor = mix(dielectricF0, baseColor, metallic);
+    surfaceAlbedo = mix(baseColor * (1.0 - dielectricF0.r), vec3(0., 0., 0.), metallic);
+
+    float alphaG = convertRoughnessToAverageSlope(roughness);
+    float NdotV = absEps(dot(normalW, viewDirectionW));
+
+    vec3 reflectionVector = reflect(-viewDirectionW, normalW);
+    reflectionVector = vec3(reflectionMatrix * vec4(reflectionVector, 0.0));
+    float reflectionLOD = getLodFromAlphaG(vReflectionMicrosurfaceInfos.x, alphaG);
+    reflectionLOD = reflectionLOD * vReflectionMicrosurfaceInfos.y + vReflectionMicrosurfaceInfos.z;
+    vec4 environmentRadiance = textureLod(reflectionSampler, reflectionVector, reflectionLOD);
+    environmentRadiance.rgb = toLinearSpace(environmentRadiance.rgb);
+    environmentRadiance.rgb *= vReflectionInfos.x;
+    environmentRadiance.rgb *= vReflectionColor;
+    vec3 environmentIrradiance = vEnvironmentIrradiance * vReflectionColor;
+
+    vec3 environmentBrdf = texture(environmentBrdfSampler, vec2(NdotV, roughness)).rgb;
+    vec3 specularEnvironmentR0 = surfaceReflectivityColor;
+    vec3 specularEnvironmentR90 = vec3(vMetallicReflectanceFactors.a);
+    vec3 energyConservationFactor = getEnergyConservationFactor(specularEnvironmentR0, environmentBrdf);
+
+    vec3 diffuseBase = vec3(0., 0., 0.);
+    vec3 specularBase = vec3(0., 0., 0.);
+    lightingInfo info = computeDirectionalLighting(normalW, viewDirectionW, normalize(-vLightData0.xyz), vLightDiffuse0.rgb, vLightSpecular0.rgb, alphaG, specularEnvironmentR0, specularEnvironmentR90);
+    diffuseBase += info.diffuse;
+    specularBase += info.specular;
+
+    vec3 specularEnvironmentReflectance = getReflectanceFromBRDFLookup(specularEnvironmentR0, specularEnvironmentR90, environmentBrdf);
+
+    vec3 finalSpecular = max(specularBase, 0.0) * energyConservationFactor;
+    vec3 finalDiffuse = max(diffuseBase * surfaceAlbedo, 0.0);
+    vec3 finalIrradiance = environmentIrradiance * surfaceAlbedo;
+    vec3 finalRadianceScaled = environmentRadiance.rgb * specularEnvironmentReflectance * vLightingIntensity.z * energyConservationFactor;
+    vec3 finalEmissive = vEmissiveColor * vLightingIntensity.y;
+
+    vec4 finalColor = vec4(
+        finalDiffuse * vLightingIntensity.x +
+        finalIrradiance * vLightingIntensity.z +
+        finalSpecular * vLightingIntensity.x * vLightingIntensity.w +
+        finalRadianceScaled +
+        finalEmissive,
+        alpha);
+    finalColor = max(finalColor, 0.0);
+
+    finalColor.rgb = applyImageProcessing(finalColor.rgb);
+    finalColor.a *= visibility;
+    glFragColor = finalColor;
+}
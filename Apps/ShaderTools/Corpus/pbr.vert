@@ -0,0 +1,83 @@
+#define PBR
+#define ALBEDO
+#define ALBEDODIRECTUV 0
+#define METALLICWORKFLOW
+#define REFLECTIVITY
+#define METALLNESSSTOREINMETALMAPBLUE
+#define ROUGHNESSSTOREINMETALMAPGREEN
+#define BUMP
+#define BUMPDIRECTUV 0
+#define NORMAL
+#define UV1
+#define REFLECTION
+#define REFLECTIONMAP_3D
+#define REFLECTIONMAP_CUBIC
+#define USESPHERICALFROMREFLECTIONMAP
+#define USESPHERICALINVERTEX
+#define ENVIRONMENTBRDF
+#define LIGHT0
+#define DIRLIGHT0
+#define IMAGEPROCESSING
+#define TONEMAPPING
+#define CONTRAST
+#define EXPOSURE
+
+precision highp float;
+
+in vec3 position;
+in vec3 normal;
+in vec2 uv;
+
+uniform mat4 world;
+uniform mat4 viewProjection;
+uniform mat4 albedoMatrix;
+uniform mat4 bumpMatrix;
+uniform mat4 reflectionMatrix;
+
+uniform vec3 vSphericalL00;
+uniform vec3 vSphericalL1_1;
+uniform vec3 vSphericalL10;
+uniform vec3 vSphericalL11;
+uniform vec3 vSphericalL2_2;
+uniform vec3 vSphericalL2_1;
+uniform vec3 vSphericalL20;
+uniform vec3 vSphericalL21;
+uniform vec3 vSphericalL22;
+
+out vec3 vPositionW;
+out vec3 vNormalW;
+out vec2 vAlbedoUV;
+out vec2 vBumpUV;
+out vec3 vEnvironmentIrradiance;
+
+vec3 computeEnvironmentIrradiance(vec3 normal) {
+    return vSphericalL00
+        + vSphericalL1_1 * (normal.y)
+        + vSphericalL10 * (normal.z)
+        + vSphericalL11 * (normal.x)
+        + vSphericalL2_2 * (normal.y * normal.x)
+        + vSphericalL2_1 * (normal.y * normal.z)
+        + vSphericalL20 * ((3.0 * normal.z * normal.z) - 1.0)
+        + vSphericalL21 * (normal.z * normal.x)
+        + vSphericalL22 * (normal.x * normal.x - (normal.y * normal.y));
+}
+
+void main(void) {
+    vec3 positionUpdated = position;
+    vec3 normalUpdated = normal;
+    vec2 uvUpdated = uv;
+
+    vec4 worldPos = world * vec4(positionUpdated, 1.0);
+    vPositionW = vec3(worldPos);
+
+    mat3 normalWorld = mat3(world);
+    vNormalW = normalize(normalWorld * normalUpdated);
+
+    vec3 reflectionVector = vec3(reflectionMatrix * vec4(vNormalW, 0.0)).xyz;
+    vEnvironmentIrradiance = computeEnvironmentIrradiance(reflectionVector);
+
+    gl_Position = viewProjection * worldPos;
+
+    vAlbedoUV = vec2(albedoMatrix * vec4(uvUpdated, 1.0, 0.0));
+    vBumpUV = vec2(bumpMatrix * vec4(uvUpdated, 1.0, 0.0));
+}
@@ -0,0 +1,27 @@
+#define SM_FLOAT 0
+#define SM_ESM 0
+#define SM_DEPTHTEXTURE 0
+#define SM_NORMALBIAS 1
+#define SM_DIRECTIONINLIGHTDATA 1
+#define SM_USEDISTANCE 0
+#define SM_SOFTTRANSPARENTSHADOW 0
+#define NORMAL
+
+precision highp float;
+
+in float vDepthMetricSM;
+
+out vec4 glFragColor;
+
+vec4 pack(float depth) {
+    const vec4 bit_shift = vec4(255.0 * 255.0 * 255.0, 255.0 * 255.0, 255.0, 1.0);
+    const vec4 bit_mask = vec4(0.0, 1.0 / 255.0, 1.0 / 255.0, 1.0 / 255.0);
+    vec4 res = fract(depth * bit_shift);
+    res -= res.xxyz * bit_mask;
+    return res;
+}
+
+void main(void) {
+    float depthSM = clamp(vDepthMetricSM, 0.0, 1.0);
+    glFragColor = pack(depthSM);
+}
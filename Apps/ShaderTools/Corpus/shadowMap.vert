@@ -0,0 +1,40 @@
+#define SM_FLOAT 0
+#define SM_ESM 0
+#define SM_DEPTHTEXTURE 0
+#define SM_NORMALBIAS 1
+#define SM_DIRECTIONINLIGHTDATA 1
+#define SM_USEDISTANCE 0
+#define SM_SOFTTRANSPARENTSHADOW 0
+#define NORMAL
+
+precision highp float;
+
+in vec3 position;
+in vec3 normal;
+
+uniform mat4 world;
+uniform mat4 viewProjection;
+uniform vec3 biasAndScaleSM;
+uniform vec2 depthValuesSM;
+uniform vec3 lightDataSM;
+
+out float vDepthMetricSM;
+
+void main(void) {
+    vec3 positionUpdated = position;
+    vec3 normalUpdated = normal;
+    mat4 finalWorld = world;
+
+    vec4 worldPos = finalWorld * vec4(positionUpdated, 1.0);
+
+    mat3 normWorldSM = mat3(finalWorld);
+    vec3 worldNor = normalize(normWorldSM * normalUpdated);
+    vec3 worldLightDirSM = normalize(-lightDataSM.xyz);
+    float ndlSM = dot(worldNor, worldLightDirSM);
+    float sinNLSM = sqrt(1.0 - ndlSM * ndlSM);
+    float normalBiasSM = biasAndScaleSM.y * sinNLSM;
+    worldPos.xyz -= worldNor * normalBiasSM;
+
+    gl_Position = viewProjection * worldPos;
+    vDepthMetricSM = ((gl_Position.z + depthValuesSM.x) / depthValuesSM.y) + biasAndScaleSM.x;
+}
@@ -0,0 +1,334 @@
+#include "ShaderCorpus.h"
+
+#include <Babylon/ThreadPool.h>
+#include <GraphicsPlatform.h>
+#include <ShaderCache.h>
+#include <ShaderCompiler.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+// Counts the allocations made on each thread, so that phases can report how many they cost.
+namespace
+{
+    thread_local uint64_t s_allocationCount{0};
+}
+
+void* operator new(std::size_t size)
+{
+    ++s_allocationCount;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+    constexpr const char* USAGE{
+        "Usage: ShaderCompilerBenchmark [--iterations <count>] [--renderer <name>] [--threads <count>] [<input>...]\n"
+        "\n"
+        "Compiles Babylon.js shader programs with this platform's shader compiler backends and reports the time and\n"
+        "allocations spent in each phase of the compilation. Needs no GPU.\n"
+        "\n"
+        "  iterations  Number of measured passes over the corpus, after one warm-up pass. Defaults to 5.\n"
+        "  renderer    bgfx renderer to compile for: opengl, opengles, direct3d11, direct3d12, metal or vulkan.\n"
+        "              Defaults to the renderer the platform initializes bgfx with.\n"
+        "  threads     Also compiles the corpus through ShaderCache::FindOrCompile on a pool of this many worker\n"
+        "              threads, as createProgramAsync does, and reports the speedup over the serial passes.\n"
+        "  input       A directory of <name>.vert and <name>.frag source pairs, or a manifest file recorded with\n"
+        "              Babylon::Plugins::NativeEngine::EnableShaderManifest, for instance while running a scene\n"
+        "              in the Playground. Defaults to the corpus in Apps/ShaderTools/Corpus: the standard (default),\n"
+        "              PBR, shadow map, particle and layer (fullscreen GUI) programs as Babylon.js sends them.\n"};
+
+    using Clock = std::chrono::steady_clock;
+
+    class PhaseRecorder final : public Babylon::ShaderCompiler::PhaseObserver
+    {
+    public:
+        struct Totals
+        {
+            std::chrono::nanoseconds Duration{};
+            uint64_t Allocations{};
+        };
+
+        void OnPhaseStart(Babylon::ShaderCompiler::Phase phase) override
+        {
+            auto& start{m_starts[static_cast<size_t>(phase)]};
+            start.Time = Clock::now();
+            start.Allocations = s_allocationCount;
+        }
+
+        void OnPhaseEnd(Babylon::ShaderCompiler::Phase phase) override
+        {
+            const auto& start{m_starts[static_cast<size_t>(phase)]};
+            auto& totals{m_totals[static_cast<size_t>(phase)]};
+            totals.Duration += Clock::now() - start.Time;
+            totals.Allocations += s_allocationCount - start.Allocations;
+        }
+
+        const Totals& GetTotals(Babylon::ShaderCompiler::Phase phase) const
+        {
+            return m_totals[static_cast<size_t>(phase)];
+        }
+
+    private:
+        struct Start
+        {
+            Clock::time_point Time{};
+            uint64_t Allocations{};
+        };
+
+        std::array<Start, Babylon::ShaderCompiler::PHASE_COUNT> m_starts{};
+        std::array<Totals, Babylon::ShaderCompiler::PHASE_COUNT> m_totals{};
+    };
+
+    double ToMilliseconds(std::chrono::nanoseconds duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    // Compiles every program through a fresh cache on the pool, so that each one misses, and returns the
+    // wall-clock time until all of them completed. Rethrows the first compilation error.
+    std::chrono::nanoseconds CompileInParallel(Babylon::ThreadPool& pool, const std::vector<ShaderCorpus::Program>& programs, bgfx::RendererType::Enum renderer)
+    {
+        Babylon::ShaderCache cache{programs.size()};
+        std::mutex mutex{};
+        std::condition_variable completed{};
+        size_t remaining{programs.size()};
+        std::exception_ptr error{};
+
+        const auto start{Clock::now()};
+        for (const auto& program : programs)
+        {
+            pool.Enqueue([&cache, &program, &mutex, &completed, &remaining, &error, renderer]() {
+                std::exception_ptr failure{};
+                try
+                {
+                    const auto key{Babylon::ShaderCache::ComputeKey(program.VertexSource, program.FragmentSource, renderer)};
+                    cache.FindOrCompile(key, program.VertexSource, program.FragmentSource, renderer);
+                }
+                catch (...)
+                {
+                    failure = std::current_exception();
+                }
+
+                std::scoped_lock lock{mutex};
+                if (failure && !error)
+                {
+                    error = failure;
+                }
+
+                if (--remaining == 0)
+                {
+                    completed.notify_one();
+                }
+            });
+        }
+
+        std::unique_lock lock{mutex};
+        completed.wait(lock, [&remaining]() { return remaining == 0; });
+        const auto duration{Clock::now() - start};
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+
+        return duration;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t iterations{5};
+    size_t threads{0};
+    bgfx::RendererType::Enum renderer{Babylon::BgfxDefaultRendererType};
+    std::vector<ShaderCorpus::Program> programs{};
+    bool hasInput{false};
+
+    try
+    {
+        for (int index = 1; index < argc; ++index)
+        {
+            const std::string argument{argv[index]};
+            if (argument == "--iterations" && index + 1 < argc)
+            {
+                iterations = std::max<size_t>(std::stoul(argv[++index]), 1);
+            }
+            else if (argument == "--threads" && index + 1 < argc)
+            {
+                threads = std::max<size_t>(std::stoul(argv[++index]), 1);
+            }
+            else if (argument == "--renderer" && index + 1 < argc)
+            {
+                const auto parsed{ShaderCorpus::ParseRenderer(argv[++index])};
+                if (!parsed || !Babylon::ShaderCompiler::IsRendererSupported(parsed.value()))
+                {
+                    throw std::runtime_error{std::string{"Unknown or unsupported renderer "} + argv[index]};
+                }
+
+                renderer = parsed.value();
+            }
+            else
+            {
+                auto loaded{ShaderCorpus::Load(argument)};
+                programs.insert(programs.end(), std::make_move_iterator(loaded.begin()), std::make_move_iterator(loaded.end()));
+                hasInput = true;
+            }
+        }
+
+        if (!hasInput)
+        {
+            programs = ShaderCorpus::Load(SHADER_CORPUS_DIRECTORY);
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << "\n\n" << USAGE;
+        return 1;
+    }
+
+    if (programs.empty())
+    {
+        std::cerr << USAGE;
+        return 1;
+    }
+
+    Babylon::ShaderCompiler compiler{};
+    PhaseRecorder recorder{};
+    std::vector<std::chrono::nanoseconds> programDurations(programs.size());
+    std::chrono::nanoseconds totalDuration{};
+    uint64_t totalAllocations{0};
+    uint64_t generatedBytes{0};
+
+    for (size_t iteration = 0; iteration <= iterations; ++iteration)
+    {
+        // The first pass warms up glslang's process-wide state and the allocator, and is not measured.
+        const bool measured{iteration > 0};
+
+        for (size_t index = 0; index < programs.size(); ++index)
+        {
+            const auto& program{programs[index]};
+            const auto allocations{s_allocationCount};
+            const auto start{Clock::now()};
+
+            try
+            {
+                const auto shaderInfo{compiler.Compile(program.VertexSource, program.FragmentSource, renderer, measured ? &recorder : nullptr)};
+                if (iteration == 0)
+                {
+                    generatedBytes += shaderInfo.VertexBytes.size() + shaderInfo.FragmentBytes.size();
+                }
+            }
+            catch (const std::exception& ex)
+            {
+                std::cerr << program.Name << ": " << ex.what() << std::endl;
+                return 1;
+            }
+
+            if (measured)
+            {
+                const auto duration{Clock::now() - start};
+                programDurations[index] += duration;
+                totalDuration += duration;
+                totalAllocations += s_allocationCount - allocations;
+            }
+        }
+    }
+
+    const double compilations{static_cast<double>(programs.size() * iterations)};
+
+    std::printf("%zu program(s) for %s, %zu measured iteration(s), SPIR-V optimizer %s\n", programs.size(), bgfx::getRendererName(renderer), iterations, Babylon::ShaderCompiler::OPTIMIZE_SPIRV ? "on" : "off");
+    std::printf("%.0f generated bytes per program\n\n", static_cast<double>(generatedBytes) / static_cast<double>(programs.size()));
+    std::printf("%-44s %12s %12s %8s %14s\n", "Phase", "Total ms", "ms/program", "Share", "Allocs/program");
+    for (size_t phaseIndex = 0; phaseIndex < Babylon::ShaderCompiler::PHASE_COUNT; ++phaseIndex)
+    {
+        const auto phase{static_cast<Babylon::ShaderCompiler::Phase>(phaseIndex)};
+        const auto& totals{recorder.GetTotals(phase)};
+        if (totals.Duration.count() == 0 && totals.Allocations == 0)
+        {
+            continue;
+        }
+
+        std::printf("%-44s %12.2f %12.3f %7.1f%% %14.0f\n",
+            Babylon::ShaderCompiler::GetPhaseName(phase),
+            ToMilliseconds(totals.Duration),
+            ToMilliseconds(totals.Duration) / compilations,
+            100.0 * ToMilliseconds(totals.Duration) / ToMilliseconds(totalDuration),
+            static_cast<double>(totals.Allocations) / compilations);
+    }
+
+    std::printf("%-44s %12.2f %12.3f %7.1f%% %14.0f\n\n", "Compile", ToMilliseconds(totalDuration), ToMilliseconds(totalDuration) / compilations, 100.0, static_cast<double>(totalAllocations) / compilations);
+
+    std::vector<size_t> slowest(programs.size());
+    for (size_t index = 0; index < slowest.size(); ++index)
+    {
+        slowest[index] = index;
+    }
+
+    std::sort(slowest.begin(), slowest.end(), [&](size_t left, size_t right) { return programDurations[left] > programDurations[right]; });
+    slowest.resize(std::min<size_t>(slowest.size(), 10));
+
+    std::printf("Slowest programs (ms/compile)\n");
+    for (const auto index : slowest)
+    {
+        std::printf("  %10.3f  %s\n", ToMilliseconds(programDurations[index]) / static_cast<double>(iterations), programs[index].Name.c_str());
+    }
+
+    if (threads > 0)
+    {
+        Babylon::ThreadPool pool{threads};
+        std::chrono::nanoseconds parallelDuration{};
+
+        for (size_t iteration = 0; iteration <= iterations; ++iteration)
+        {
+            // As above, the first pass warms up the compilers, which each worker thread owns, and is not measured.
+            try
+            {
+                const auto duration{CompileInParallel(pool, programs, renderer)};
+                if (iteration > 0)
+                {
+                    parallelDuration += duration;
+                }
+            }
+            catch (const std::exception& ex)
+            {
+                std::cerr << ex.what() << std::endl;
+                return 1;
+            }
+        }
+
+        const double serialMs{ToMilliseconds(totalDuration) / static_cast<double>(iterations)};
+        const double parallelMs{ToMilliseconds(parallelDuration) / static_cast<double>(iterations)};
+
+        std::printf("\nShaderCache::FindOrCompile on %zu thread(s) (ms/pass over the corpus)\n", threads);
+        std::printf("  %10.2f  serial\n", serialMs);
+        std::printf("  %10.2f  parallel\n", parallelMs);
+        std::printf("  %10.2fx speedup\n", serialMs / parallelMs);
+    }
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include "ShaderCorpus.h"
+
+#include <ShaderManifest.h>
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace ShaderCorpus
+{
+    namespace
+    {
+        std::string ReadFile(const std::filesystem::path& path)
+        {
+            std::ifstream file{path, std::ios::binary};
+            if (!file)
+            {
+                throw std::runtime_error{"Unable to read " + path.string()};
+            }
+
+            std::ostringstream stream{};
+            stream << file.rdbuf();
+            return stream.str();
+        }
+    }
+
+    std::vector<Program> Load(const std::filesystem::path& input)
+    {
+        std::vector<Program> programs{};
+
+        if (!std::filesystem::is_directory(input))
+        {
+            const auto entries{Babylon::ShaderManifest::ReadEntries(input.string())};
+            if (entries.empty())
+            {
+                throw std::runtime_error{input.string() + " is neither a directory nor a shader manifest"};
+            }
+
+            for (size_t index = 0; index < entries.size(); ++index)
+            {
+                programs.push_back({input.string() + "#" + std::to_string(index), entries[index].first, entries[index].second});
+            }
+
+            return programs;
+        }
+
+        for (const auto& entry : std::filesystem::directory_iterator{input})
+        {
+            const auto& vertexPath{entry.path()};
+            if (vertexPath.extension() != ".vert")
+            {
+                continue;
+            }
+
+            auto fragmentPath{vertexPath};
+            fragmentPath.replace_extension(".frag");
+            if (!std::filesystem::exists(fragmentPath))
+            {
+                throw std::runtime_error{vertexPath.string() + " has no matching " + fragmentPath.filename().string()};
+            }
+
+            programs.push_back({vertexPath.stem().string(), ReadFile(vertexPath), ReadFile(fragmentPath)});
+        }
+
+        // Directory iteration order is unspecified; sorting keeps output and reports stable across runs.
+        std::sort(programs.begin(), programs.end(), [](const Program& left, const Program& right) { return left.Name < right.Name; });
+        return programs;
+    }
+
+    std::optional<bgfx::RendererType::Enum> ParseRenderer(const std::string& name)
+    {
+        static const std::map<std::string, bgfx::RendererType::Enum> renderers{
+            {"opengl", bgfx::RendererType::OpenGL},
+            {"opengles", bgfx::RendererType::OpenGLES},
+            {"direct3d11", bgfx::RendererType::Direct3D11},
+            {"direct3d12", bgfx::RendererType::Direct3D12},
+            {"metal", bgfx::RendererType::Metal},
+            {"vulkan", bgfx::RendererType::Vulkan},
+        };
+
+        const auto it{renderers.find(name)};
+        if (it == renderers.end())
+        {
+            return {};
+        }
+
+        return it->second;
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <bgfx/bgfx.h>
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ShaderCorpus
+{
+    struct Program
+    {
+        std::string Name{};
+        std::string VertexSource{};
+        std::string FragmentSource{};
+    };
+
+    // Loads the programs of an input: a directory of <name>.vert and <name>.frag source pairs, or a manifest
+    // file recorded with Babylon::Plugins::NativeEngine::EnableShaderManifest. Throws if neither applies.
+    std::vector<Program> Load(const std::filesystem::path& input);
+
+    // Parses a renderer name given on the command line: opengl, opengles, direct3d11, direct3d12, metal or vulkan.
+    std::optional<bgfx::RendererType::Enum> ParseRenderer(const std::string& name);
+}
@@ -0,0 +1,81 @@
+#include "ShaderCorpus.h"
+
+#include <ShaderCache.h>
+#include <ShaderCompiler.h>
+#include <ShaderPack.h>
+
+#include <iostream>
+
+namespace
+{
+    constexpr const char* USAGE{
+        "Usage: ShaderPacker <renderer> <output> <input>...\n"
+        "\n"
+        "Compiles Babylon.js shader programs for a renderer and writes them into a shader pack that\n"
+        "Babylon::Plugins::NativeEngine::LoadShaderPack serves programs from.\n"
+        "\n"
+        "  renderer  bgfx renderer the pack is loaded with: opengl, opengles, direct3d11, direct3d12, metal or vulkan.\n"
+        "            Only the renderers of this platform's shader compiler backends can be targeted.\n"
+        "  input     A directory of <name>.vert and <name>.frag source pairs, or a manifest file recorded with\n"
+        "            Babylon::Plugins::NativeEngine::EnableShaderManifest.\n"};
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        std::cerr << USAGE;
+        return 1;
+    }
+
+    const auto renderer{ShaderCorpus::ParseRenderer(argv[1])};
+    if (!renderer || !Babylon::ShaderCompiler::IsRendererSupported(renderer.value()))
+    {
+        std::cerr << "Unknown or unsupported renderer " << argv[1] << "\n\n" << USAGE;
+        return 1;
+    }
+
+    const std::string output{argv[2]};
+
+    try
+    {
+        Babylon::ShaderCompiler compiler{};
+
+        std::vector<Babylon::ShaderPack::Entry> entries{};
+        size_t failures{0};
+        for (int index = 3; index < argc; ++index)
+        {
+            for (const auto& program : ShaderCorpus::Load(argv[index]))
+            {
+                try
+                {
+                    const uint64_t key{Babylon::ShaderCache::ComputeKey(program.VertexSource, program.FragmentSource, renderer.value())};
+                    entries.push_back({key, Babylon::ShaderCache::Serialize(key, compiler.Compile(program.VertexSource, program.FragmentSource, renderer.value()))});
+                }
+                catch (const std::exception& ex)
+                {
+                    std::cerr << program.Name << ": " << ex.what() << std::endl;
+                    ++failures;
+                }
+            }
+        }
+
+        // A partial pack would silently fall back to compiling on the device, so fail the build instead.
+        if (failures > 0)
+        {
+            std::cerr << failures << " program(s) failed to compile; " << output << " was not written." << std::endl;
+            return 1;
+        }
+
+        const size_t programCount{entries.size()};
+        Babylon::ShaderPack::Write(output, std::move(entries));
+        std::cout << "Packed " << programCount << " program(s) into " << output << std::endl;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,186 @@
+#include <MipGenerator.h>
+
+#include <Babylon/ThreadPool.h>
+
+#include <bimg/bimg.h>
+#include <bx/allocator.h>
+#include <bx/math.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    constexpr const char* USAGE{
+        "Usage: MipGeneratorBenchmark [--iterations <count>]\n"
+        "\n"
+        "Builds full mip chains for synthetic 2048x2048 and 4096x4096 images with the native mip generator and with\n"
+        "the bimg path it replaced, and reports the time each takes. Needs no GPU.\n"
+        "\n"
+        "  iterations  Number of measured runs per image and path, after one warm-up run. Defaults to 5.\n"};
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr std::array<uint16_t, 2> SIZES{2048, 4096};
+
+    constexpr std::array<bimg::TextureFormat::Enum, 5> FORMATS{
+        bimg::TextureFormat::RGBA8,
+        bimg::TextureFormat::RGB8,
+        bimg::TextureFormat::R8,
+        bimg::TextureFormat::RGBA16F,
+        bimg::TextureFormat::RGBA32F,
+    };
+
+    // Fills the image with a smooth gradient plus noise, in range for every format.
+    void Fill(bimg::ImageContainer& image)
+    {
+        uint32_t state{0x9E3779B9};
+        auto next = [&state]() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        };
+
+        const uint32_t bitsPerPixel{bimg::getBitsPerPixel(image.m_format)};
+        const size_t pixelCount{static_cast<size_t>(image.m_width) * image.m_height};
+        uint8_t* data{static_cast<uint8_t*>(image.m_data)};
+
+        switch (image.m_format)
+        {
+            case bimg::TextureFormat::RGBA16F:
+            {
+                auto* halves{reinterpret_cast<uint16_t*>(data)};
+                for (size_t index = 0; index < pixelCount * 4; ++index)
+                {
+                    halves[index] = bx::halfFromFloat(static_cast<float>(next() & 0xFFFF) / 65535.0f);
+                }
+                break;
+            }
+            case bimg::TextureFormat::RGBA32F:
+            {
+                auto* floats{reinterpret_cast<float*>(data)};
+                for (size_t index = 0; index < pixelCount * 4; ++index)
+                {
+                    floats[index] = static_cast<float>(next() & 0xFFFF) / 65535.0f;
+                }
+                break;
+            }
+            default:
+            {
+                const size_t byteCount{pixelCount * bitsPerPixel / 8};
+                for (size_t index = 0; index < byteCount; ++index)
+                {
+                    data[index] = static_cast<uint8_t>((index / 64) + (next() & 0x0F));
+                }
+                break;
+            }
+        }
+    }
+
+    // What GenerateMips in NativeEngine did before the native generator: bimg's own mip generation, going through
+    // RGBA8 for the formats bimg cannot filter directly.
+    bimg::ImageContainer* GenerateWithBimg(bx::AllocatorI* allocator, const bimg::ImageContainer& input)
+    {
+        if (bimg::ImageContainer* output = bimg::imageGenerateMips(allocator, input))
+        {
+            return output;
+        }
+
+        bimg::ImageContainer* rgba = bimg::imageConvert(allocator, bimg::TextureFormat::RGBA8, input, false);
+        bimg::ImageContainer* mips = bimg::imageGenerateMips(allocator, *rgba);
+        bimg::imageFree(rgba);
+        bimg::ImageContainer* output = bimg::imageConvert(allocator, input.m_format, *mips);
+        bimg::imageFree(mips);
+        return output;
+    }
+
+    template<typename GenerateT>
+    double Measure(size_t iterations, const bimg::ImageContainer& input, GenerateT&& generate)
+    {
+        std::chrono::nanoseconds total{};
+        for (size_t iteration = 0; iteration <= iterations; ++iteration)
+        {
+            const auto start{Clock::now()};
+            bimg::ImageContainer* output{generate(input)};
+            const auto duration{Clock::now() - start};
+            if (output == nullptr)
+            {
+                throw std::runtime_error{std::string{"Mip generation failed for "} + bimg::getName(input.m_format)};
+            }
+
+            bimg::imageFree(output);
+
+            // The first run warms up the allocator and the thread pool, and is not measured.
+            if (iteration > 0)
+            {
+                total += duration;
+            }
+        }
+
+        return std::chrono::duration<double, std::milli>(total).count() / static_cast<double>(iterations);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t iterations{5};
+
+    try
+    {
+        for (int index = 1; index < argc; ++index)
+        {
+            const std::string argument{argv[index]};
+            if (argument == "--iterations" && index + 1 < argc)
+            {
+                iterations = std::max<size_t>(std::stoul(argv[++index]), 1);
+            }
+            else
+            {
+                throw std::runtime_error{"Unknown argument " + argument};
+            }
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << "\n\n" << USAGE;
+        return 1;
+    }
+
+    bx::DefaultAllocator allocator{};
+
+    std::printf("%zu measured iteration(s), %zu thread pool worker(s)\n\n", iterations, Babylon::ThreadPool::GetDefault().WorkerCount());
+    std::printf("%-10s %-10s %12s %12s %9s\n", "Size", "Format", "Native ms", "bimg ms", "Speedup");
+
+    try
+    {
+        for (const auto size : SIZES)
+        {
+            for (const auto format : FORMATS)
+            {
+                bimg::ImageContainer* input{bimg::imageAlloc(&allocator, format, size, size, 1, 1, false, false)};
+                Fill(*input);
+
+                const double native{Measure(iterations, *input, [&allocator](const bimg::ImageContainer& image) { return Babylon::MipGenerator::Generate(&allocator, image); })};
+                const double legacy{Measure(iterations, *input, [&allocator](const bimg::ImageContainer& image) { return GenerateWithBimg(&allocator, image); })};
+                bimg::imageFree(input);
+
+                const std::string dimensions{std::to_string(size) + "x" + std::to_string(size)};
+                std::printf("%-10s %-10s %12.2f %12.2f %8.2fx\n", dimensions.c_str(), bimg::getName(format), native, legacy, legacy / native);
+            }
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,487 @@
+#include <TextureDecoder.h>
+
+#include <bimg/bimg.h>
+#include <bimg/decode.h>
+#include <bx/allocator.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr const char* USAGE{
+        "Usage: TextureLoadBenchmark [--iterations <count>] [--caps <profile>] [--no-invert-y] [--no-mips] <input>...\n"
+        "\n"
+        "Decodes images the way NativeEngine loads textures, and reports the time and peak memory each one takes\n"
+        "through the current single-copy pipeline and through the separate convert, flip and mip passes it replaced.\n"
+        "Needs no GPU; every uncompressed format is treated as supported and compressed ones are decoded to RGBA8.\n"
+        "\n"
+        "With a compressed caps profile, KTX2 and Basis Universal images are instead kept in (or transcoded to) a\n"
+        "compressed format of that profile, and their decode time and resident bytes are reported next to those of\n"
+        "the PNG or JPEG path: a PNG or JPEG file of the same name next to the image when there is one, otherwise the\n"
+        "same image decoded to RGBA8.\n"
+        "\n"
+        "  iterations   Number of measured decodes per image and pipeline, after one warm-up decode. Defaults to 5.\n"
+        "  caps         The compressed formats the renderer is assumed to support: bc, etc2, astc, or none, the\n"
+        "               default, for the single-copy comparison.\n"
+        "  no-invert-y  Loads without flipping rows. Babylon.js flips most textures, so they are flipped by default.\n"
+        "  no-mips      Loads without generating mips.\n"
+        "  input        An image file, or a directory whose image files are all loaded, such as the textures used by\n"
+        "               the validation tests.\n"};
+
+    using Clock = std::chrono::steady_clock;
+
+    // Tracks the bytes the pipelines allocate through bx, so that the peak of each decode can be reported.
+    class TrackingAllocator final : public bx::AllocatorI
+    {
+    public:
+        void* realloc(void* ptr, size_t size, size_t align, const char* /*file*/, uint32_t /*line*/) override
+        {
+            // Every block is prefixed with its size, in a header that keeps the payload aligned.
+            const size_t header{std::max<size_t>(align, HEADER_SIZE)};
+
+            if (size == 0)
+            {
+                Free(ptr, align);
+                return nullptr;
+            }
+
+            auto* block{static_cast<uint8_t*>(::operator new(header + size, std::align_val_t{header}))};
+            std::memcpy(block + header - sizeof(size_t), &size, sizeof(size_t));
+            uint8_t* payload{block + header};
+
+            m_live += size;
+            m_peak = std::max(m_peak, m_live);
+
+            if (ptr != nullptr)
+            {
+                std::memcpy(payload, ptr, std::min(size, SizeOf(ptr)));
+                Free(ptr, align);
+            }
+
+            return payload;
+        }
+
+        void ResetPeak()
+        {
+            m_peak = m_live;
+        }
+
+        size_t GetPeak() const
+        {
+            return m_peak;
+        }
+
+    private:
+        static constexpr size_t HEADER_SIZE{16};
+
+        static size_t SizeOf(void* ptr)
+        {
+            size_t size{};
+            std::memcpy(&size, static_cast<uint8_t*>(ptr) - sizeof(size_t), sizeof(size_t));
+            return size;
+        }
+
+        void Free(void* ptr, size_t align)
+        {
+            if (ptr == nullptr)
+            {
+                return;
+            }
+
+            const size_t header{std::max<size_t>(align, HEADER_SIZE)};
+            m_live -= SizeOf(ptr);
+            ::operator delete(static_cast<uint8_t*>(ptr) - header, std::align_val_t{header});
+        }
+
+        size_t m_live{};
+        size_t m_peak{};
+    };
+
+    bool IsFormatSupported(bimg::TextureFormat::Enum format)
+    {
+        return !bimg::isCompressed(format);
+    }
+
+    bool IsBcSupported(bimg::TextureFormat::Enum format)
+    {
+        switch (format)
+        {
+        case bimg::TextureFormat::BC1:
+        case bimg::TextureFormat::BC2:
+        case bimg::TextureFormat::BC3:
+        case bimg::TextureFormat::BC4:
+        case bimg::TextureFormat::BC5:
+        case bimg::TextureFormat::BC6H:
+        case bimg::TextureFormat::BC7:
+            return true;
+        default:
+            return IsFormatSupported(format);
+        }
+    }
+
+    bool IsEtc2Supported(bimg::TextureFormat::Enum format)
+    {
+        switch (format)
+        {
+        case bimg::TextureFormat::ETC1:
+        case bimg::TextureFormat::ETC2:
+        case bimg::TextureFormat::ETC2A:
+        case bimg::TextureFormat::ETC2A1:
+            return true;
+        default:
+            return IsFormatSupported(format);
+        }
+    }
+
+    bool IsAstcSupported(bimg::TextureFormat::Enum format)
+    {
+        switch (format)
+        {
+        case bimg::TextureFormat::ASTC4x4:
+        case bimg::TextureFormat::ASTC5x5:
+        case bimg::TextureFormat::ASTC6x6:
+        case bimg::TextureFormat::ASTC8x5:
+        case bimg::TextureFormat::ASTC8x6:
+        case bimg::TextureFormat::ASTC10x5:
+            return true;
+        default:
+            return IsFormatSupported(format);
+        }
+    }
+
+    using IsFormatSupportedT = bool (*)(bimg::TextureFormat::Enum);
+
+    // The format support of typical desktop (BC), mobile (ETC2) and recent mobile (ASTC) renderers.
+    IsFormatSupportedT ParseCaps(const std::string& name)
+    {
+        if (name == "none")
+        {
+            return IsFormatSupported;
+        }
+        if (name == "bc")
+        {
+            return IsBcSupported;
+        }
+        if (name == "etc2")
+        {
+            return IsEtc2Supported;
+        }
+        if (name == "astc")
+        {
+            return IsAstcSupported;
+        }
+
+        throw std::runtime_error{"Unknown caps profile: " + name};
+    }
+
+    // What DecodeImage in NativeEngine did before decoded texels were copied once into the final buffer: a
+    // separate pass with its own allocation for luminance expansion, for the flip and for the mip chain.
+    bimg::ImageContainer* DecodeInPasses(bx::AllocatorI* allocator, const std::vector<uint8_t>& data, bool invertY, bool generateMips)
+    {
+        bimg::ImageContainer* image{bimg::imageParse(allocator, data.data(), static_cast<uint32_t>(data.size()))};
+        if (image == nullptr)
+        {
+            throw std::runtime_error{"Unable to decode image."};
+        }
+
+        if (!IsFormatSupported(image->m_format))
+        {
+            bimg::ImageContainer* rgba{bimg::imageConvert(allocator, bimg::TextureFormat::RGBA8, *image)};
+            bimg::imageFree(image);
+            image = rgba;
+        }
+
+        if (image->m_format == bimg::TextureFormat::R8)
+        {
+            image->m_format = bimg::TextureFormat::A8;
+            bimg::ImageContainer* rgb{bimg::imageConvert(allocator, bimg::TextureFormat::RGB8, *image, false)};
+            bimg::imageFree(image);
+            image = rgb;
+        }
+
+        if (invertY)
+        {
+            Babylon::TextureDecoder::FlipY(image);
+        }
+
+        if (generateMips && image->m_numMips <= 1 && !bimg::isCompressed(image->m_format))
+        {
+            Babylon::TextureDecoder::GenerateMips(allocator, &image);
+        }
+
+        return image;
+    }
+
+    struct Measurement
+    {
+        double Milliseconds{};
+        size_t PeakBytes{};
+
+        // The size of the decoded image, which is what stays resident once uploaded.
+        size_t ResidentBytes{};
+    };
+
+    template<typename DecodeT>
+    Measurement Measure(size_t iterations, TrackingAllocator& allocator, DecodeT&& decode)
+    {
+        Measurement measurement{};
+        std::chrono::nanoseconds total{};
+        for (size_t iteration = 0; iteration <= iterations; ++iteration)
+        {
+            allocator.ResetPeak();
+            const auto start{Clock::now()};
+            bimg::ImageContainer* image{decode()};
+            const auto duration{Clock::now() - start};
+            measurement.ResidentBytes = image->m_size;
+            bimg::imageFree(image);
+
+            // The first decode warms up the allocator and the thread pool, and is not measured.
+            if (iteration > 0)
+            {
+                total += duration;
+                measurement.PeakBytes = std::max(measurement.PeakBytes, allocator.GetPeak());
+            }
+        }
+
+        measurement.Milliseconds = std::chrono::duration<double, std::milli>(total).count() / static_cast<double>(iterations);
+        return measurement;
+    }
+
+    std::string GetExtension(const std::filesystem::path& path)
+    {
+        auto extension{path.extension().string()};
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+        return extension;
+    }
+
+    bool IsPngOrJpeg(const std::filesystem::path& path)
+    {
+        const auto extension{GetExtension(path)};
+        return extension == ".png" || extension == ".jpg" || extension == ".jpeg";
+    }
+
+    bool IsImageFile(const std::filesystem::path& path)
+    {
+        const auto extension{GetExtension(path)};
+        for (const char* known : {".png", ".jpg", ".jpeg", ".bmp", ".tga", ".gif", ".psd", ".hdr", ".exr", ".dds", ".ktx", ".ktx2"})
+        {
+            if (extension == known)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    std::vector<uint8_t> ReadFile(const std::filesystem::path& path)
+    {
+        std::ifstream stream{path, std::ios::binary};
+        if (!stream)
+        {
+            throw std::runtime_error{"Unable to read " + path.string()};
+        }
+
+        return {std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+    }
+
+    double ToMegabytes(size_t bytes)
+    {
+        return static_cast<double>(bytes) / (1024.0 * 1024.0);
+    }
+
+    // The PNG or JPEG file an image was presumably made from, if there is one next to it.
+    std::filesystem::path FindUncompressedSource(const std::filesystem::path& file)
+    {
+        for (const char* extension : {".png", ".jpg", ".jpeg", ".PNG", ".JPG", ".JPEG"})
+        {
+            auto source{file};
+            source.replace_extension(extension);
+            if (source != file && std::filesystem::is_regular_file(source))
+            {
+                return source;
+            }
+        }
+
+        return {};
+    }
+
+    // Compares the images the renderer would keep compressed with what the same content costs through the PNG or
+    // JPEG path.
+    int RunCompressed(const std::vector<std::filesystem::path>& files, size_t iterations, bool invertY, bool generateMips, IsFormatSupportedT isFormatSupported)
+    {
+        TrackingAllocator allocator{};
+        Measurement compressedTotal{};
+        Measurement uncompressedTotal{};
+
+        std::printf("%-40s %-18s %10s %12s %-28s %10s %12s\n", "Image", "Output", "Decode ms", "Resident MB", "PNG/JPEG path", "Decode ms", "Resident MB");
+
+        for (const auto& file : files)
+        {
+            // PNG and JPEG files are what the others are compared with.
+            if (IsPngOrJpeg(file))
+            {
+                continue;
+            }
+
+            try
+            {
+                const auto data{ReadFile(file)};
+                const gsl::span<const uint8_t> span{data.data(), data.size()};
+
+                bimg::ImageContainer* output{Babylon::TextureDecoder::Decode(&allocator, span, invertY, generateMips, isFormatSupported)};
+                const std::string description{std::to_string(output->m_width) + "x" + std::to_string(output->m_height) + " " + bimg::getName(output->m_format)};
+                bimg::imageFree(output);
+
+                const auto compressed{Measure(iterations, allocator, [&]() { return Babylon::TextureDecoder::Decode(&allocator, span, invertY, generateMips, isFormatSupported); })};
+
+                const auto source{FindUncompressedSource(file)};
+                const auto sourceData{source.empty() ? data : ReadFile(source)};
+                const gsl::span<const uint8_t> sourceSpan{sourceData.data(), sourceData.size()};
+                const auto uncompressed{Measure(iterations, allocator, [&]() { return Babylon::TextureDecoder::Decode(&allocator, sourceSpan, invertY, generateMips, IsFormatSupported); })};
+                const std::string sourceDescription{source.empty() ? "(this image as RGBA8)" : source.filename().string()};
+
+                compressedTotal.Milliseconds += compressed.Milliseconds;
+                compressedTotal.ResidentBytes += compressed.ResidentBytes;
+                uncompressedTotal.Milliseconds += uncompressed.Milliseconds;
+                uncompressedTotal.ResidentBytes += uncompressed.ResidentBytes;
+
+                std::printf("%-40s %-18s %10.2f %12.2f %-28s %10.2f %12.2f\n", file.filename().string().c_str(), description.c_str(),
+                    compressed.Milliseconds, ToMegabytes(compressed.ResidentBytes), sourceDescription.c_str(), uncompressed.Milliseconds, ToMegabytes(uncompressed.ResidentBytes));
+            }
+            catch (const std::exception& ex)
+            {
+                std::printf("%-40s %s\n", file.filename().string().c_str(), ex.what());
+            }
+        }
+
+        std::printf("%-40s %-18s %10.2f %12.2f %-28s %10.2f %12.2f\n", "Total", "",
+            compressedTotal.Milliseconds, ToMegabytes(compressedTotal.ResidentBytes), "", uncompressedTotal.Milliseconds, ToMegabytes(uncompressedTotal.ResidentBytes));
+
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t iterations{5};
+    bool invertY{true};
+    bool generateMips{true};
+    std::string caps{"none"};
+    IsFormatSupportedT isFormatSupported{IsFormatSupported};
+    std::vector<std::filesystem::path> files{};
+
+    try
+    {
+        for (int index = 1; index < argc; ++index)
+        {
+            const std::string argument{argv[index]};
+            if (argument == "--iterations" && index + 1 < argc)
+            {
+                iterations = std::max<size_t>(std::stoul(argv[++index]), 1);
+            }
+            else if (argument == "--caps" && index + 1 < argc)
+            {
+                caps = argv[++index];
+                isFormatSupported = ParseCaps(caps);
+            }
+            else if (argument == "--no-invert-y")
+            {
+                invertY = false;
+            }
+            else if (argument == "--no-mips")
+            {
+                generateMips = false;
+            }
+            else if (std::filesystem::is_directory(argument))
+            {
+                for (const auto& entry : std::filesystem::recursive_directory_iterator{argument})
+                {
+                    if (entry.is_regular_file() && IsImageFile(entry.path()))
+                    {
+                        files.push_back(entry.path());
+                    }
+                }
+            }
+            else if (std::filesystem::is_regular_file(argument))
+            {
+                files.emplace_back(argument);
+            }
+            else
+            {
+                throw std::runtime_error{"No such file or directory: " + argument};
+            }
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << "\n\n" << USAGE;
+        return 1;
+    }
+
+    if (files.empty())
+    {
+        std::cerr << USAGE;
+        return 1;
+    }
+
+    std::sort(files.begin(), files.end());
+
+    std::printf("%zu image(s), %zu measured iteration(s), caps %s, invertY %s, mips %s\n\n", files.size(), iterations, caps.c_str(), invertY ? "on" : "off", generateMips ? "on" : "off");
+
+    if (isFormatSupported != IsFormatSupported)
+    {
+        return RunCompressed(files, iterations, invertY, generateMips, isFormatSupported);
+    }
+
+    TrackingAllocator allocator{};
+    Measurement currentTotal{};
+    Measurement passesTotal{};
+
+    std::printf("%-40s %-18s %12s %12s %15s %15s\n", "Image", "Output", "Current ms", "Passes ms", "Current peak MB", "Passes peak MB");
+
+    for (const auto& file : files)
+    {
+        try
+        {
+            const auto data{ReadFile(file)};
+            const gsl::span<const uint8_t> span{data.data(), data.size()};
+
+            bimg::ImageContainer* output{Babylon::TextureDecoder::Decode(&allocator, span, invertY, generateMips, IsFormatSupported)};
+            const std::string description{std::to_string(output->m_width) + "x" + std::to_string(output->m_height) + " " + bimg::getName(output->m_format)};
+            bimg::imageFree(output);
+
+            const auto current{Measure(iterations, allocator, [&]() { return Babylon::TextureDecoder::Decode(&allocator, span, invertY, generateMips, IsFormatSupported); })};
+            const auto passes{Measure(iterations, allocator, [&]() { return DecodeInPasses(&allocator, data, invertY, generateMips); })};
+
+            currentTotal.Milliseconds += current.Milliseconds;
+            currentTotal.PeakBytes = std::max(currentTotal.PeakBytes, current.PeakBytes);
+            passesTotal.Milliseconds += passes.Milliseconds;
+            passesTotal.PeakBytes = std::max(passesTotal.PeakBytes, passes.PeakBytes);
+
+            std::printf("%-40s %-18s %12.2f %12.2f %15.2f %15.2f\n", file.filename().string().c_str(), description.c_str(),
+                current.Milliseconds, passes.Milliseconds, ToMegabytes(current.PeakBytes), ToMegabytes(passes.PeakBytes));
+        }
+        catch (const std::exception& ex)
+        {
+            std::printf("%-40s %s\n", file.filename().string().c_str(), ex.what());
+        }
+    }
+
+    std::printf("%-40s %-18s %12.2f %12.2f %15.2f %15.2f\n", "Total (peak is the largest image's)", "",
+        currentTotal.Milliseconds, passesTotal.Milliseconds, ToMegabytes(currentTotal.PeakBytes), ToMegabytes(passesTotal.PeakBytes));
+
+    return 0;
+}
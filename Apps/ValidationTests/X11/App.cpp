@@ -5,6 +5,7 @@
 #include <X11/Xutil.h>
 #include <unistd.h> // syscall
 #undef None
+#include <cstring>
 #include <filesystem>
 
 #include <Shared/TestUtils.h>
@@ -55,13 +56,14 @@ namespace
         graphics.reset();
     }
     
-    void InitBabylon(int32_t window)
+    void InitBabylon(int32_t window, Display* display, Babylon::Graphics::Renderer renderer)
     {
         std::string moduleRootUrl = GetUrlFromPath(GetModulePath().parent_path());
 
         Uninitialize();
 
-        graphics = Babylon::Graphics::CreateGraphics((void*)(uintptr_t)window, static_cast<size_t>(width), static_cast<size_t>(height));
+        graphics = Babylon::Graphics::CreateGraphics((void*)(uintptr_t)window, static_cast<void*>(display), static_cast<size_t>(width), static_cast<size_t>(height));
+        graphics->SetRenderer(renderer);
         graphics->SetDiagnosticOutput([](const char* outputString) { printf("%s", outputString); fflush(stdout); });
         graphics->StartRenderingCurrentFrame();
 
@@ -102,8 +104,11 @@ namespace
     }
 }
 
-int main(int /*_argc*/, const char* const* /*_argv*/)
+int main(int _argc, const char* const* _argv)
 {
+    // --vulkan renders with Vulkan instead of OpenGL, which also works without a GPU through a software Vulkan driver.
+    const bool vulkan{_argc > 1 && std::strcmp(_argv[1], "--vulkan") == 0};
+
     XInitThreads();
     Display* display = XOpenDisplay(NULL);
 
@@ -168,7 +173,7 @@ int main(int /*_argc*/, const char* const* /*_argv*/)
             , NULL
             );
 
-    InitBabylon(window);
+    InitBabylon(window, display, vulkan ? Babylon::Graphics::Renderer::Vulkan : Babylon::Graphics::Renderer::Default);
     UpdateWindowSize(width, height);
 
     while (!doExit)
@@ -1,6 +1,8 @@
 #include "AppRuntime.h"
 #include "WorkQueue.h"
 
+#include <Babylon/ThreadConfiguration.h>
+
 namespace Babylon
 {
     AppRuntime::AppRuntime()
@@ -9,7 +11,10 @@ namespace Babylon
     }
 
     AppRuntime::AppRuntime(std::function<void(std::exception_ptr)> unhandledExceptionHandler)
-        : m_workQueue{std::make_unique<WorkQueue>([this] { RunPlatformTier(); }, unhandledExceptionHandler)}
+        : m_workQueue{std::make_unique<WorkQueue>([this] {
+            ThreadConfiguration::ApplyToCurrentThread(ThreadRole::JavaScript);
+            RunPlatformTier();
+        }, unhandledExceptionHandler)}
     {
         Dispatch([this](Napi::Env env) {
             JsRuntime::CreateForJavaScript(env, [this](auto func) { m_workQueue->Append(std::move(func)); });
@@ -2,6 +2,7 @@
 
 #include <Babylon/JsRuntime.h>
 
+#include <chrono>
 #include <memory>
 
 namespace Babylon
@@ -11,6 +12,56 @@ namespace Babylon
     public:
         class Impl;
 
+        struct FrameStatistics
+        {
+            // Number of the last rendered frame; it does not advance while idle frames are skipped.
+            uint32_t FrameNumber{};
+
+            // Work submitted in the last rendered frame.
+            uint32_t DrawCalls{};
+            uint32_t ComputeCalls{};
+            uint32_t BlitCalls{};
+
+            // Timings of the last rendered frame.
+            double CpuSubmitTimeMs{};
+            double GpuTimeMs{};
+            double WaitForRenderMs{};
+            double WaitForSubmitMs{};
+
+            // Transient buffer usage of the last rendered frame, in bytes.
+            int32_t TransientVertexBufferBytes{};
+            int32_t TransientIndexBufferBytes{};
+
+            // Live resource counts. Buffer counts include dynamic buffers.
+            uint32_t Textures{};
+            uint32_t VertexBuffers{};
+            uint32_t IndexBuffers{};
+            uint32_t Programs{};
+            uint32_t Shaders{};
+            uint32_t FrameBuffers{};
+            uint32_t VertexLayouts{};
+
+            // Estimated memory of live resources, in bytes. Texture and render target memory are
+            // reported by the renderer and are negative when the backend does not track them.
+            int64_t TextureMemoryBytes{};
+            int64_t RenderTargetMemoryBytes{};
+            int64_t BufferMemoryBytes{};
+
+            // Texture uploads waiting for a frame with upload budget left.
+            size_t PendingTextureUploads{};
+            size_t PendingTextureUploadBytes{};
+        };
+
+        // The renderers that can be asked for instead of the platform's default one.
+        enum class Renderer
+        {
+            Default,
+            OpenGL,
+            Vulkan,
+            // Renders nothing and needs no window; for headless runs such as benchmarks.
+            Noop,
+        };
+
         ~Graphics();
 
         template<typename... Ts>
@@ -21,6 +72,11 @@ namespace Babylon
 
         void UpdateSize(size_t width, size_t height);
 
+        // Selects the renderer bgfx is initialized with, which must be done while rendering is disabled. Throws if
+        // the renderer is not built for this platform; Vulkan can be chosen over the default OpenGL on Linux when
+        // built with BABYLON_NATIVE_VULKAN.
+        void SetRenderer(Renderer renderer);
+
         void AddToJavaScript(Napi::Env);
 
         void EnableRendering();
@@ -29,11 +85,32 @@ namespace Babylon
         void StartRenderingCurrentFrame();
         void FinishRenderingCurrentFrame();
 
+        // When idle frame skipping is enabled, FinishRenderingCurrentFrame does not advance the
+        // bgfx frame unless work was encoded or requested since the previous frame.
+        void EnableIdleFrameSkipping();
+        void DisableIdleFrameSkipping();
+        bool HasPendingFrameWork();
+
+        // Blocks until work is requested for the next frame or the timeout elapses, returning
+        // immediately if idle frame skipping is disabled. Must be called between
+        // StartRenderingCurrentFrame and FinishRenderingCurrentFrame so JavaScript can encode.
+        bool WaitForPendingFrameWork(std::chrono::milliseconds timeout);
+
         void SetDiagnosticOutput(std::function<void(const char* output)> outputFunction);
 
         float GetHardwareScalingLevel();
         void SetHardwareScalingLevel(float level);
 
+        void EnableDynamicResolution(float targetFrameTimeMs, float minHardwareScalingLevel, float maxHardwareScalingLevel);
+        void DisableDynamicResolution();
+
+        // Caps how much texture data is handed to bgfx per frame. At least one upload is submitted
+        // per frame regardless of its size. Zero disables the corresponding limit.
+        void SetTextureUploadBudget(size_t bytesPerFrame, std::chrono::microseconds timePerFrame);
+
+        // Statistics of the most recently rendered frame. Cheap enough to call every frame from any thread.
+        FrameStatistics GetFrameStatistics();
+
     private:
         Graphics();
 
@@ -0,0 +1,84 @@
+#include "DynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace Babylon
+{
+    namespace
+    {
+        // Frames slower than this fraction of the target lower the resolution.
+        constexpr float OVER_BUDGET_RATIO{1.05f};
+
+        // Frames faster than this fraction of the target raise the resolution. The gap between
+        // the two ratios keeps the controller from oscillating around the target.
+        constexpr float UNDER_BUDGET_RATIO{0.75f};
+
+        constexpr float LEVEL_STEP{0.125f};
+    }
+
+    void DynamicResolution::Enable(const Settings& settings)
+    {
+        m_enabled = true;
+        m_settings = settings;
+        ClearSamples();
+    }
+
+    void DynamicResolution::Disable()
+    {
+        m_enabled = false;
+        ClearSamples();
+    }
+
+    bool DynamicResolution::IsEnabled() const
+    {
+        return m_enabled;
+    }
+
+    std::optional<float> DynamicResolution::Update(float frameTimeMs, float currentLevel)
+    {
+        if (!m_enabled || frameTimeMs <= 0.0f)
+        {
+            return {};
+        }
+
+        m_samples[m_nextSample] = frameTimeMs;
+        m_nextSample = (m_nextSample + 1) % SAMPLE_COUNT;
+        m_sampleCount = std::min(m_sampleCount + 1, SAMPLE_COUNT);
+
+        if (m_sampleCount < SAMPLE_COUNT)
+        {
+            return {};
+        }
+
+        const float averageMs{std::accumulate(m_samples.begin(), m_samples.end(), 0.0f) / SAMPLE_COUNT};
+
+        float level{currentLevel};
+        if (averageMs > m_settings.TargetFrameTimeMs * OVER_BUDGET_RATIO)
+        {
+            level = std::min(currentLevel + LEVEL_STEP, m_settings.MaxHardwareScalingLevel);
+        }
+        else if (averageMs < m_settings.TargetFrameTimeMs * UNDER_BUDGET_RATIO)
+        {
+            level = std::max(currentLevel - LEVEL_STEP, m_settings.MinHardwareScalingLevel);
+        }
+
+        if (std::abs(level - currentLevel) < std::numeric_limits<float>::epsilon())
+        {
+            return {};
+        }
+
+        // Samples taken at the old resolution say nothing about the new one.
+        ClearSamples();
+        return level;
+    }
+
+    void DynamicResolution::ClearSamples()
+    {
+        m_samples = {};
+        m_sampleCount = 0;
+        m_nextSample = 0;
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <optional>
+
+namespace Babylon
+{
+    /// Tracks recent frame times and decides when the hardware scaling level should be raised
+    /// (lower resolution) or lowered (higher resolution) to keep frames within a target budget.
+    /// Decisions are only made once a full window of samples has been collected, and the window
+    /// is cleared after every change, which provides hysteresis between consecutive adjustments.
+    class DynamicResolution final
+    {
+    public:
+        struct Settings
+        {
+            float TargetFrameTimeMs{16.6f};
+            float MinHardwareScalingLevel{1.0f};
+            float MaxHardwareScalingLevel{2.0f};
+        };
+
+        void Enable(const Settings& settings);
+        void Disable();
+        bool IsEnabled() const;
+
+        /// Records the time spent on the last frame and returns the hardware scaling level that
+        /// should be applied, if it differs from the current one.
+        std::optional<float> Update(float frameTimeMs, float currentLevel);
+
+    private:
+        static constexpr size_t SAMPLE_COUNT{30};
+
+        void ClearSamples();
+
+        bool m_enabled{};
+        Settings m_settings{};
+        std::array<float, SAMPLE_COUNT> m_samples{};
+        size_t m_sampleCount{};
+        size_t m_nextSample{};
+    };
+}
@@ -1,5 +1,6 @@
 #include <Babylon/Graphics.h>
 #include "GraphicsImpl.h"
+#include <GraphicsPlatform.h>
 
 namespace Babylon
 {
@@ -45,6 +46,27 @@ namespace Babylon
         m_impl->Resize(width, height);
     }
 
+    void Graphics::SetRenderer(Renderer renderer)
+    {
+        switch (renderer)
+        {
+        case Renderer::Default:
+            m_impl->SetRendererType(BgfxDefaultRendererType);
+            break;
+        case Renderer::OpenGL:
+            m_impl->SetRendererType(bgfx::RendererType::OpenGL);
+            break;
+        case Renderer::Vulkan:
+            m_impl->SetRendererType(bgfx::RendererType::Vulkan);
+            break;
+        case Renderer::Noop:
+            m_impl->SetRendererType(bgfx::RendererType::Noop);
+            break;
+        default:
+            throw std::runtime_error{"Unrecognized renderer."};
+        }
+    }
+
     void Graphics::AddToJavaScript(Napi::Env env)
     {
         m_impl->AddToJavaScript(env);
@@ -70,6 +92,26 @@ namespace Babylon
         m_impl->FinishRenderingCurrentFrame();
     }
 
+    void Graphics::EnableIdleFrameSkipping()
+    {
+        m_impl->EnableIdleFrameSkipping();
+    }
+
+    void Graphics::DisableIdleFrameSkipping()
+    {
+        m_impl->DisableIdleFrameSkipping();
+    }
+
+    bool Graphics::HasPendingFrameWork()
+    {
+        return m_impl->HasPendingFrameWork();
+    }
+
+    bool Graphics::WaitForPendingFrameWork(std::chrono::milliseconds timeout)
+    {
+        return m_impl->WaitForPendingFrameWork(timeout);
+    }
+
     void Graphics::SetDiagnosticOutput(std::function<void(const char* output)> outputFunction)
     {
         m_impl->SetDiagnosticOutput(std::move(outputFunction));
@@ -84,4 +126,24 @@ namespace Babylon
     {
         return m_impl->GetHardwareScalingLevel();
     }
+
+    void Graphics::EnableDynamicResolution(float targetFrameTimeMs, float minHardwareScalingLevel, float maxHardwareScalingLevel)
+    {
+        m_impl->EnableDynamicResolution(targetFrameTimeMs, minHardwareScalingLevel, maxHardwareScalingLevel);
+    }
+
+    void Graphics::DisableDynamicResolution()
+    {
+        m_impl->DisableDynamicResolution();
+    }
+
+    void Graphics::SetTextureUploadBudget(size_t bytesPerFrame, std::chrono::microseconds timePerFrame)
+    {
+        m_impl->SetTextureUploadBudget(bytesPerFrame, timePerFrame);
+    }
+
+    Graphics::FrameStatistics Graphics::GetFrameStatistics()
+    {
+        return m_impl->GetFrameStatistics();
+    }
 }
@@ -1,6 +1,10 @@
 #include "GraphicsImpl.h"
 #include <GraphicsPlatform.h>
 #include <JsRuntimeInternalState.h>
+#include <Babylon/ThreadConfiguration.h>
+
+#include <algorithm>
+#include <array>
 
 namespace
 {
@@ -22,6 +26,8 @@ namespace Babylon
 
     Graphics::Impl::Impl()
         : m_bgfxCallback{[this](const auto& data) { CaptureCallback(data); }}
+        , m_beforeRenderScheduler{*this}
+        , m_afterRenderScheduler{*this}
     {
         std::scoped_lock lock{m_state.Mutex};
         m_state.Bgfx.Initialized = false;
@@ -43,6 +49,31 @@ namespace Babylon
         return m_state.Bgfx.InitState.platformData.nwh;
     }
 
+    bgfx::RendererType::Enum Graphics::Impl::GetRendererType()
+    {
+        std::scoped_lock lock{m_state.Mutex};
+        return m_state.Bgfx.InitState.type;
+    }
+
+    void Graphics::Impl::SetRendererType(bgfx::RendererType::Enum type)
+    {
+        std::scoped_lock lock{m_state.Mutex};
+
+        if (m_state.Bgfx.Initialized)
+        {
+            throw std::runtime_error{"The renderer cannot be changed while rendering is enabled."};
+        }
+
+        std::array<bgfx::RendererType::Enum, bgfx::RendererType::Count> supported{};
+        const auto count{bgfx::getSupportedRenderers(static_cast<uint8_t>(supported.size()), supported.data())};
+        if (std::find(supported.begin(), supported.begin() + count, type) == supported.begin() + count)
+        {
+            throw std::runtime_error{std::string{"Renderer "} + bgfx::getRendererName(type) + " is not supported on this platform."};
+        }
+
+        m_state.Bgfx.InitState.type = type;
+    }
+
     void Graphics::Impl::SetNativeWindow(void* nativeWindowPtr, void* windowTypePtr)
     {
         std::scoped_lock lock{m_state.Mutex};
@@ -54,6 +85,8 @@ namespace Babylon
         pd.context = nullptr;
         pd.backBuffer = nullptr;
         pd.backBufferDS = nullptr;
+
+        SignalFrameWork();
     }
 
     void Graphics::Impl::Resize(size_t width, size_t height)
@@ -96,6 +129,7 @@ namespace Babylon
         {
             // Set the thread affinity (all other rendering operations must happen on this thread).
             m_renderThreadAffinity = std::this_thread::get_id();
+            ThreadConfiguration::ApplyToCurrentThread(ThreadRole::Render);
 
             // This tells bgfx to not create its own render thread.
             bgfx::renderFrame();
@@ -105,8 +139,13 @@ namespace Babylon
             bgfx::setPlatformData(init.platformData);
             bgfx::init(init);
 
+            // bgfx falls back to another renderer when the requested one fails to initialize, for instance
+            // when no Vulkan driver is installed.
+            init.type = bgfx::getRendererType();
+
             m_state.Bgfx.Initialized = true;
             m_state.Bgfx.Dirty = false;
+            m_state.Bgfx.ResolutionDirty = false;
 
             m_frameBufferManager = std::make_unique<FrameBufferManager>();
 
@@ -122,7 +161,11 @@ namespace Babylon
 
         if (m_state.Bgfx.Initialized)
         {
+            // Pending uploads own their image data, so submit them all rather than leak them.
+            m_textureUploadQueue.Submit(true);
+
             // HACK: Render one more frame to drain the before/after render work queues.
+            SignalFrameWork();
             StartRenderingCurrentFrame();
             FinishRenderingCurrentFrame();
 
@@ -177,6 +220,37 @@ namespace Babylon
         m_rendering = false;
     }
 
+    void Graphics::Impl::EnableIdleFrameSkipping()
+    {
+        std::scoped_lock lock{m_frameWorkMutex};
+        m_idleFrameSkipping = true;
+    }
+
+    void Graphics::Impl::DisableIdleFrameSkipping()
+    {
+        {
+            std::scoped_lock lock{m_frameWorkMutex};
+            m_idleFrameSkipping = false;
+        }
+
+        // Release anyone waiting for work, since frames are no longer skipped.
+        m_frameWorkCondition.notify_all();
+    }
+
+    bool Graphics::Impl::HasPendingFrameWork()
+    {
+        std::scoped_lock lock{m_frameWorkMutex};
+        return m_frameWorkPending;
+    }
+
+    bool Graphics::Impl::WaitForPendingFrameWork(std::chrono::milliseconds timeout)
+    {
+        assert(m_renderThreadAffinity.check());
+
+        std::unique_lock lock{m_frameWorkMutex};
+        return m_frameWorkCondition.wait_for(lock, timeout, [this] { return m_frameWorkPending || !m_idleFrameSkipping; });
+    }
+
     Graphics::Impl::UpdateToken Graphics::Impl::GetUpdateToken()
     {
         return {*this};
@@ -221,6 +295,7 @@ namespace Babylon
     void Graphics::Impl::RequestScreenShot(std::function<void(std::vector<uint8_t>)> callback)
     {
         m_screenShotCallbacks.push(std::move(callback));
+        SignalFrameWork();
     }
 
     float Graphics::Impl::GetHardwareScalingLevel()
@@ -243,6 +318,28 @@ namespace Babylon
         UpdateBgfxResolution();
     }
 
+    void Graphics::Impl::EnableDynamicResolution(float targetFrameTimeMs, float minHardwareScalingLevel, float maxHardwareScalingLevel)
+    {
+        if (targetFrameTimeMs <= std::numeric_limits<float>::epsilon())
+        {
+            throw std::runtime_error{"Dynamic resolution target frame time must be greater than 0."};
+        }
+
+        if (minHardwareScalingLevel <= std::numeric_limits<float>::epsilon() || maxHardwareScalingLevel < minHardwareScalingLevel)
+        {
+            throw std::runtime_error{"Dynamic resolution scaling levels must be greater than 0 and the maximum cannot be less than the minimum."};
+        }
+
+        std::scoped_lock lock{m_state.Mutex};
+        m_dynamicResolution.Enable({targetFrameTimeMs, minHardwareScalingLevel, maxHardwareScalingLevel});
+    }
+
+    void Graphics::Impl::DisableDynamicResolution()
+    {
+        std::scoped_lock lock{m_state.Mutex};
+        m_dynamicResolution.Disable();
+    }
+
     Graphics::Impl::CaptureCallbackTicketT Graphics::Impl::AddCaptureCallback(std::function<void(const BgfxCallback::CaptureData&)> callback)
     {
         // If we're not already capturing, start.
@@ -255,6 +352,8 @@ namespace Babylon
             }
         }
 
+        SignalFrameWork();
+
         return m_captureCallbacks.insert(std::move(callback), m_captureCallbacksMutex);
     }
 
@@ -273,17 +372,30 @@ namespace Babylon
             bgfx::setViewRect(0, 0, 0, static_cast<uint16_t>(res.width), static_cast<uint16_t>(res.height));
 
             m_state.Bgfx.Dirty = false;
+            m_state.Bgfx.ResolutionDirty = false;
+        }
+        else if (m_state.Bgfx.ResolutionDirty)
+        {
+            // Only the back buffer size changed, so resources and bindings are still valid
+            // and there is no need to discard them.
+            auto& res = m_state.Bgfx.InitState.resolution;
+            bgfx::reset(res.width, res.height, BGFX_RESET_FLAGS);
+            bgfx::setViewRect(0, 0, 0, static_cast<uint16_t>(res.width), static_cast<uint16_t>(res.height));
+
+            m_state.Bgfx.ResolutionDirty = false;
         }
     }
 
     void Graphics::Impl::UpdateBgfxResolution()
     {
         std::scoped_lock lock{m_state.Mutex};
-        m_state.Bgfx.Dirty = true;
+        m_state.Bgfx.ResolutionDirty = true;
         auto& res = m_state.Bgfx.InitState.resolution;
         auto level = m_state.Resolution.HardwareScalingLevel;
         res.width = static_cast<uint32_t>(m_state.Resolution.Width / level);
         res.height = static_cast<uint32_t>(m_state.Resolution.Height / level);
+
+        SignalFrameWork();
     }
 
     void Graphics::Impl::DiscardIfDirty()
@@ -305,19 +417,140 @@ namespace Babylon
         }
     }
 
+    void Graphics::Impl::UpdateFrameStatistics(uint32_t frameNumber)
+    {
+        const bgfx::Stats* stats{bgfx::getStats()};
+        const auto toMilliseconds{[](int64_t ticks, int64_t frequency) {
+            return frequency == 0 ? 0.0 : 1000.0 * ticks / frequency;
+        }};
+
+        FrameStatistics frameStatistics{};
+        frameStatistics.FrameNumber = frameNumber;
+        frameStatistics.DrawCalls = stats->numDraw;
+        frameStatistics.ComputeCalls = stats->numCompute;
+        frameStatistics.BlitCalls = stats->numBlit;
+        frameStatistics.CpuSubmitTimeMs = toMilliseconds(stats->cpuTimeEnd - stats->cpuTimeBegin, stats->cpuTimerFreq);
+        frameStatistics.GpuTimeMs = toMilliseconds(stats->gpuTimeEnd - stats->gpuTimeBegin, stats->gpuTimerFreq);
+        frameStatistics.WaitForRenderMs = toMilliseconds(stats->waitRender, stats->cpuTimerFreq);
+        frameStatistics.WaitForSubmitMs = toMilliseconds(stats->waitSubmit, stats->cpuTimerFreq);
+        frameStatistics.TransientVertexBufferBytes = stats->transientVbUsed;
+        frameStatistics.TransientIndexBufferBytes = stats->transientIbUsed;
+        frameStatistics.Textures = stats->numTextures;
+        frameStatistics.VertexBuffers = static_cast<uint32_t>(stats->numVertexBuffers) + stats->numDynamicVertexBuffers;
+        frameStatistics.IndexBuffers = static_cast<uint32_t>(stats->numIndexBuffers) + stats->numDynamicIndexBuffers;
+        frameStatistics.Programs = stats->numPrograms;
+        frameStatistics.Shaders = stats->numShaders;
+        frameStatistics.FrameBuffers = stats->numFrameBuffers;
+        frameStatistics.VertexLayouts = stats->numVertexLayouts;
+        frameStatistics.TextureMemoryBytes = stats->textureMemoryUsed;
+        frameStatistics.RenderTargetMemoryBytes = stats->rtMemoryUsed;
+
+        std::scoped_lock lock{m_frameStatisticsMutex};
+        m_frameStatistics = frameStatistics;
+    }
+
+    void Graphics::Impl::UpdateDynamicResolution()
+    {
+        std::scoped_lock lock{m_state.Mutex};
+        if (!m_dynamicResolution.IsEnabled())
+        {
+            return;
+        }
+
+        // Use the larger of the render thread submit time and the GPU time so that waiting on
+        // vsync does not count as work; otherwise the resolution could never recover.
+        const auto frameStatistics{GetFrameStatistics()};
+        const auto frameTimeMs{static_cast<float>(std::max(frameStatistics.CpuSubmitTimeMs, frameStatistics.GpuTimeMs))};
+
+        if (auto level{m_dynamicResolution.Update(frameTimeMs, m_state.Resolution.HardwareScalingLevel)})
+        {
+            m_state.Resolution.HardwareScalingLevel = level.value();
+            UpdateBgfxResolution();
+        }
+    }
+
+    Graphics::FrameStatistics Graphics::Impl::GetFrameStatistics()
+    {
+        std::scoped_lock lock{m_frameStatisticsMutex};
+        auto frameStatistics{m_frameStatistics};
+        frameStatistics.BufferMemoryBytes = m_bufferMemoryBytes;
+
+        const auto backlog{m_textureUploadQueue.GetBacklog()};
+        frameStatistics.PendingTextureUploads = backlog.Uploads;
+        frameStatistics.PendingTextureUploadBytes = backlog.Bytes;
+
+        return frameStatistics;
+    }
+
+    arcana::task<void, std::exception_ptr> Graphics::Impl::UploadTextureAsync(size_t byteCount, std::function<void()> upload, const arcana::cancellation* cancellation)
+    {
+        auto task{m_textureUploadQueue.Enqueue(byteCount, std::move(upload), cancellation)};
+        SignalFrameWork();
+        return task;
+    }
+
+    void Graphics::Impl::SetTextureUploadBudget(size_t bytesPerFrame, std::chrono::microseconds timePerFrame)
+    {
+        m_textureUploadQueue.SetBudget({bytesPerFrame, timePerFrame});
+    }
+
+    void Graphics::Impl::TrackBufferMemory(int64_t deltaBytes)
+    {
+        m_bufferMemoryBytes += deltaBytes;
+    }
+
+    void Graphics::Impl::SignalFrameWork()
+    {
+        {
+            std::scoped_lock lock{m_frameWorkMutex};
+            m_frameWorkPending = true;
+        }
+
+        m_frameWorkCondition.notify_all();
+    }
+
+    bool Graphics::Impl::ConsumePendingFrameWork()
+    {
+        std::scoped_lock lock{m_frameWorkMutex};
+        const bool pending{m_frameWorkPending};
+        m_frameWorkPending = false;
+        return pending || !m_idleFrameSkipping;
+    }
+
     void Graphics::Impl::Frame()
     {
         // Automatically end bgfx encoders.
         EndEncoders();
 
+        // Nothing was encoded or requested, so there is nothing new to present.
+        if (!ConsumePendingFrameWork())
+        {
+            return;
+        }
+
         // Discard everything if the bgfx state is dirty.
         DiscardIfDirty();
 
         // Request screen shots before bgfx::frame.
         RequestScreenShots();
 
+        // Hand this frame's share of the queued texture uploads to bgfx.
+        m_textureUploadQueue.Submit();
+
         // Advance frame and render!
-        bgfx::frame();
+        const uint32_t frameNumber{bgfx::frame()};
+
+        // The uploads submitted above are now resident.
+        m_textureUploadQueue.CompleteSubmitted();
+        if (!m_textureUploadQueue.Empty())
+        {
+            SignalFrameWork();
+        }
+
+        UpdateFrameStatistics(frameNumber);
+
+        // Adjust the resolution of the next frame based on how long this one took.
+        UpdateDynamicResolution();
 
         // Reset the frame buffers.
         m_frameBufferManager->Reset();
@@ -334,6 +567,7 @@ namespace Babylon
         {
             bgfx::Encoder* encoder{bgfx::begin(true)};
             it = m_threadIdToEncoder.emplace(threadId, encoder).first;
+            SignalFrameWork();
         }
 
         return it->second;
@@ -361,6 +595,7 @@ namespace Babylon
             std::scoped_lock stateLock{m_state.Mutex};
             m_state.Bgfx.Dirty = true;
             m_state.Bgfx.InitState.resolution.reset &= ~BGFX_RESET_CAPTURE;
+            SignalFrameWork();
             return;
         }
 
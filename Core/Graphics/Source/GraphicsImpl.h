@@ -2,8 +2,10 @@
 
 #include <Babylon/Graphics.h>
 #include "BgfxCallback.h"
+#include "DynamicResolution.h"
 #include "FrameBufferManager.h"
 #include "SafeTimespanGuarantor.h"
+#include "TextureUploadQueue.h"
 
 #include <arcana/containers/ticketed_collection.h>
 #include <arcana/threading/blocking_concurrent_queue.h>
@@ -14,6 +16,9 @@
 #include <bgfx/bgfx.h>
 #include <bgfx/platform.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
 #include <map>
 
@@ -46,11 +51,18 @@ namespace Babylon
             void operator()(CallableT&& callable)
             {
                 m_dispatcher(callable);
+                m_graphicsImpl.SignalFrameWork();
             }
 
         private:
             friend Impl;
 
+            RenderScheduler(Impl& graphicsImpl)
+                : m_graphicsImpl{graphicsImpl}
+            {
+            }
+
+            Impl& m_graphicsImpl;
             arcana::manual_dispatcher<128> m_dispatcher;
         };
 
@@ -61,6 +73,10 @@ namespace Babylon
         void SetNativeWindow(void* nativeWindowPtr, void* windowTypePtr);
         void Resize(size_t width, size_t height);
 
+        // The renderer bgfx is initialized with; available before rendering is enabled.
+        bgfx::RendererType::Enum GetRendererType();
+        void SetRendererType(bgfx::RendererType::Enum type);
+
         void AddToJavaScript(Napi::Env);
         static Impl& GetFromJavaScript(Napi::Env);
 
@@ -73,6 +89,11 @@ namespace Babylon
         void StartRenderingCurrentFrame();
         void FinishRenderingCurrentFrame();
 
+        void EnableIdleFrameSkipping();
+        void DisableIdleFrameSkipping();
+        bool HasPendingFrameWork();
+        bool WaitForPendingFrameWork(std::chrono::milliseconds timeout);
+
         UpdateToken GetUpdateToken();
 
         FrameBuffer& AddFrameBuffer(bgfx::FrameBufferHandle handle, uint16_t width, uint16_t height, bool backBuffer);
@@ -86,6 +107,21 @@ namespace Babylon
         float GetHardwareScalingLevel();
         void SetHardwareScalingLevel(float level);
 
+        void EnableDynamicResolution(float targetFrameTimeMs, float minHardwareScalingLevel, float maxHardwareScalingLevel);
+        void DisableDynamicResolution();
+
+        FrameStatistics GetFrameStatistics();
+
+        // Queues a texture upload to be submitted within the per-frame upload budget. The returned
+        // task completes on the render thread once the texture is resident, or fails without running
+        // the upload if the cancellation is requested before the upload is submitted. The cancellation,
+        // if any, must outlive the queued upload.
+        arcana::task<void, std::exception_ptr> UploadTextureAsync(size_t byteCount, std::function<void()> upload, const arcana::cancellation* cancellation = nullptr);
+        void SetTextureUploadBudget(size_t bytesPerFrame, std::chrono::microseconds timePerFrame);
+
+        // Buffers are created by plugins, so bgfx cannot tell how much memory they hold.
+        void TrackBufferMemory(int64_t deltaBytes);
+
         using CaptureCallbackTicketT = arcana::ticketed_collection<std::function<void(const BgfxCallback::CaptureData&)>>::ticket;
         CaptureCallbackTicketT AddCaptureCallback(std::function<void(const BgfxCallback::CaptureData&)> callback);
 
@@ -96,6 +132,10 @@ namespace Babylon
         void UpdateBgfxResolution();
         void DiscardIfDirty();
         void RequestScreenShots();
+        void UpdateFrameStatistics(uint32_t frameNumber);
+        void UpdateDynamicResolution();
+        void SignalFrameWork();
+        bool ConsumePendingFrameWork();
         void Frame();
         bgfx::Encoder* GetEncoderForThread();
         void EndEncoders();
@@ -115,6 +155,7 @@ namespace Babylon
                 bgfx::Init InitState{};
                 bool Initialized{};
                 bool Dirty{};
+                bool ResolutionDirty{};
             } Bgfx{};
 
             struct
@@ -125,6 +166,9 @@ namespace Babylon
             } Resolution{};
         } m_state;
 
+        // Guarded by m_state.Mutex.
+        DynamicResolution m_dynamicResolution{};
+
         BgfxCallback m_bgfxCallback;
 
         SafeTimespanGuarantor m_safeTimespanGuarantor{};
@@ -132,6 +176,17 @@ namespace Babylon
         RenderScheduler m_beforeRenderScheduler;
         RenderScheduler m_afterRenderScheduler;
 
+        std::mutex m_frameWorkMutex{};
+        std::condition_variable m_frameWorkCondition{};
+        bool m_frameWorkPending{true};
+        bool m_idleFrameSkipping{};
+
+        std::mutex m_frameStatisticsMutex{};
+        FrameStatistics m_frameStatistics{};
+        std::atomic<int64_t> m_bufferMemoryBytes{};
+
+        TextureUploadQueue m_textureUploadQueue{};
+
         std::unique_ptr<FrameBufferManager> m_frameBufferManager{};
 
         std::mutex m_captureCallbacksMutex{};
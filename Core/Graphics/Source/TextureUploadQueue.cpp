@@ -0,0 +1,107 @@
+#include "TextureUploadQueue.h"
+
+#include <system_error>
+
+namespace Babylon
+{
+    arcana::task<void, std::exception_ptr> TextureUploadQueue::Enqueue(size_t byteCount, std::function<void()> upload, const arcana::cancellation* cancellation)
+    {
+        std::scoped_lock lock{m_mutex};
+        m_pending.push_back({byteCount, std::move(upload), cancellation});
+        m_pendingBytes += byteCount;
+        return m_pending.back().Completion.as_task();
+    }
+
+    void TextureUploadQueue::SetBudget(const Budget& budget)
+    {
+        std::scoped_lock lock{m_mutex};
+        m_budget = budget;
+    }
+
+    TextureUploadQueue::Backlog TextureUploadQueue::GetBacklog()
+    {
+        std::scoped_lock lock{m_mutex};
+        return {m_pending.size(), m_pendingBytes};
+    }
+
+    bool TextureUploadQueue::Empty()
+    {
+        std::scoped_lock lock{m_mutex};
+        return m_pending.empty();
+    }
+
+    void TextureUploadQueue::Submit(bool unbudgeted)
+    {
+        const auto startTime{std::chrono::steady_clock::now()};
+        size_t submittedBytes{};
+        size_t submittedCount{};
+
+        while (true)
+        {
+            Upload upload{};
+            {
+                std::scoped_lock lock{m_mutex};
+                if (m_pending.empty())
+                {
+                    return;
+                }
+
+                if (!unbudgeted && submittedCount > 0)
+                {
+                    const auto& budget{m_budget};
+                    const bool overBytes{budget.BytesPerFrame != 0 && submittedBytes + m_pending.front().ByteCount > budget.BytesPerFrame};
+                    const bool overTime{budget.TimePerFrame.count() != 0 && std::chrono::steady_clock::now() - startTime >= budget.TimePerFrame};
+                    if (overBytes || overTime)
+                    {
+                        return;
+                    }
+                }
+
+                upload = std::move(m_pending.front());
+                m_pending.pop_front();
+                m_pendingBytes -= upload.ByteCount;
+            }
+
+            if (upload.Cancellation && upload.Cancellation->cancelled())
+            {
+                // Release whatever the upload holds (typically the decoded image) now; it does not count against the budget.
+                upload.Function = nullptr;
+                m_submitted.emplace_back(std::move(upload.Completion), std::make_exception_ptr(std::system_error{std::make_error_code(std::errc::operation_canceled)}));
+                continue;
+            }
+
+            std::exception_ptr exception{};
+            try
+            {
+                upload.Function();
+            }
+            catch (...)
+            {
+                exception = std::current_exception();
+            }
+
+            submittedBytes += upload.ByteCount;
+            ++submittedCount;
+            m_submitted.emplace_back(std::move(upload.Completion), exception);
+        }
+    }
+
+    void TextureUploadQueue::CompleteSubmitted()
+    {
+        // Move the list out first; completions may run continuations that enqueue more uploads.
+        auto submitted{std::move(m_submitted)};
+        m_submitted.clear();
+
+        for (auto& [completion, exception] : submitted)
+        {
+            if (exception)
+            {
+                completion.complete(arcana::make_unexpected(exception));
+            }
+            else
+            {
+                completion.complete();
+            }
+        }
+    }
+}
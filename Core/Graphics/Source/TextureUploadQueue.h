@@ -0,0 +1,74 @@
+#pragma once
+
+#include <arcana/threading/cancellation.h>
+#include <arcana/threading/task.h>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace Babylon
+{
+    /// Spreads texture creation and updates across frames so that a burst of decoded images does not
+    /// make a single bgfx::frame upload hundreds of megabytes. Uploads are submitted on the render
+    /// thread right before bgfx::frame, in queue order, until the per-frame byte or time budget is
+    /// used up. At least one upload is submitted per frame so that uploads larger than the budget
+    /// still make progress. Tasks returned by Enqueue complete after the bgfx::frame that consumed
+    /// the upload, i.e. once the texture is resident. Uploads whose cancellation has been requested
+    /// by the time they reach the front of the queue are dropped without running.
+    class TextureUploadQueue final
+    {
+    public:
+        struct Budget
+        {
+            // Zero means unlimited.
+            size_t BytesPerFrame{32 * 1024 * 1024};
+            std::chrono::microseconds TimePerFrame{std::chrono::milliseconds{4}};
+        };
+
+        struct Backlog
+        {
+            size_t Uploads{};
+            size_t Bytes{};
+        };
+
+        TextureUploadQueue() = default;
+        TextureUploadQueue(const TextureUploadQueue&) = delete;
+        TextureUploadQueue(TextureUploadQueue&&) = delete;
+
+        /// The upload function runs on the render thread and must hand its data to bgfx
+        /// (e.g. bgfx::createTexture2D or bgfx::updateTexture2D). When the cancellation is requested
+        /// first, the function is destroyed without running and the task fails with operation_canceled.
+        /// The cancellation, if any, must outlive the queued upload.
+        arcana::task<void, std::exception_ptr> Enqueue(size_t byteCount, std::function<void()> upload, const arcana::cancellation* cancellation = nullptr);
+
+        void SetBudget(const Budget& budget);
+        Backlog GetBacklog();
+        bool Empty();
+
+        /// Called on the render thread before bgfx::frame. When unbudgeted, everything is submitted.
+        void Submit(bool unbudgeted = false);
+
+        /// Called on the render thread after bgfx::frame.
+        void CompleteSubmitted();
+
+    private:
+        struct Upload
+        {
+            size_t ByteCount{};
+            std::function<void()> Function{};
+            const arcana::cancellation* Cancellation{};
+            arcana::task_completion_source<void, std::exception_ptr> Completion{};
+        };
+
+        std::mutex m_mutex{};
+        Budget m_budget{};
+        std::deque<Upload> m_pending{};
+        size_t m_pendingBytes{};
+
+        // Only accessed on the render thread.
+        std::vector<std::pair<arcana::task_completion_source<void, std::exception_ptr>, std::exception_ptr>> m_submitted{};
+    };
+}
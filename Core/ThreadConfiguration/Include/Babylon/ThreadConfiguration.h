@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace Babylon
+{
+    enum class ThreadRole
+    {
+        // The thread running the JavaScript work queue.
+        JavaScript,
+        // The thread calling Graphics::StartRenderingCurrentFrame and Graphics::FinishRenderingCurrentFrame.
+        Render,
+        // Background threads used for decoding and other CPU-heavy work.
+        Worker,
+        // Threads created by UrlLib to service requests.
+        Network,
+    };
+
+    struct ThreadSettings
+    {
+        // Shown in debuggers, profilers and tracing tools. Worker thread names get an index suffix.
+        // Names are truncated to 15 characters on Linux and Android.
+        std::string Name{};
+
+        // Platform-specific priority. This is a nice value (-20 to 19, lower is more important) on
+        // Linux and Android, a THREAD_PRIORITY_* value on Windows, and a pthread scheduling priority on
+        // Apple platforms. Leaving it empty keeps the default priority.
+        std::optional<int> Priority{};
+
+        // Bit N allows the thread to run on logical CPU N. Zero keeps the default affinity. Affinity is
+        // not supported on Apple platforms or UWP and is ignored there.
+        uint64_t AffinityMask{};
+    };
+
+    namespace ThreadConfiguration
+    {
+        // Sets the settings applied to threads of the given role. Threads pick up their settings
+        // when they start, so this should be called before creating the AppRuntime and Graphics
+        // instances and before the first network request is sent.
+        void Configure(ThreadRole role, ThreadSettings settings);
+
+        ThreadSettings GetSettings(ThreadRole role);
+
+        // Applies the settings for the given role to the calling thread. Failures (e.g. raising
+        // priority without the required privileges) are ignored so that thread startup never fails.
+        void ApplyToCurrentThread(ThreadRole role);
+    }
+}
@@ -0,0 +1,70 @@
+#include "ThreadConfigurationPlatform.h"
+
+#include <UrlLib/UrlLib.h>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+
+namespace Babylon::ThreadConfiguration
+{
+    namespace
+    {
+        constexpr size_t ROLE_COUNT{static_cast<size_t>(ThreadRole::Network) + 1};
+
+        struct State
+        {
+            std::mutex Mutex{};
+            std::array<ThreadSettings, ROLE_COUNT> Settings{
+                ThreadSettings{"BabylonJS"},
+                ThreadSettings{"BabylonRender"},
+                ThreadSettings{"BabylonWorker"},
+                ThreadSettings{"BabylonNetwork"},
+            };
+            std::atomic<uint32_t> WorkerIndex{};
+            bool NetworkCallbackInstalled{};
+        };
+
+        State& GetState()
+        {
+            static State state{};
+            return state;
+        }
+    }
+
+    void Configure(ThreadRole role, ThreadSettings settings)
+    {
+        auto& state{GetState()};
+        std::scoped_lock lock{state.Mutex};
+
+        state.Settings[static_cast<size_t>(role)] = std::move(settings);
+
+        // UrlLib threads are only worth hooking once somebody configures threads at all; this keeps
+        // UrlLib untouched for apps that never use this API.
+        if (!state.NetworkCallbackInstalled)
+        {
+            UrlLib::SetThreadStartCallback([] { ApplyToCurrentThread(ThreadRole::Network); });
+            state.NetworkCallbackInstalled = true;
+        }
+    }
+
+    ThreadSettings GetSettings(ThreadRole role)
+    {
+        auto& state{GetState()};
+        std::scoped_lock lock{state.Mutex};
+        return state.Settings[static_cast<size_t>(role)];
+    }
+
+    void ApplyToCurrentThread(ThreadRole role)
+    {
+        auto settings{GetSettings(role)};
+
+        std::string name{settings.Name};
+        if (role == ThreadRole::Worker && !name.empty())
+        {
+            name += std::to_string(GetState().WorkerIndex++);
+        }
+
+        ApplyPlatformSettings(name, settings);
+    }
+}
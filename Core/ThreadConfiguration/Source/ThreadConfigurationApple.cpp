@@ -0,0 +1,27 @@
+#include "ThreadConfigurationPlatform.h"
+
+#include <pthread.h>
+
+namespace Babylon::ThreadConfiguration
+{
+    void ApplyPlatformSettings(const std::string& name, const ThreadSettings& settings)
+    {
+        if (!name.empty())
+        {
+            pthread_setname_np(name.c_str());
+        }
+
+        if (settings.Priority)
+        {
+            int policy{};
+            sched_param param{};
+            if (pthread_getschedparam(pthread_self(), &policy, &param) == 0)
+            {
+                param.sched_priority = *settings.Priority;
+                pthread_setschedparam(pthread_self(), policy, &param);
+            }
+        }
+
+        // Apple platforms do not support thread affinity; AffinityMask is ignored.
+    }
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <Babylon/ThreadConfiguration.h>
+
+namespace Babylon::ThreadConfiguration
+{
+    // Implemented per platform. The name has already been resolved (e.g. worker index suffix).
+    void ApplyPlatformSettings(const std::string& name, const ThreadSettings& settings);
+}
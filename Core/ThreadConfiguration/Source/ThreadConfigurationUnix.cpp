@@ -0,0 +1,48 @@
+#include "ThreadConfigurationPlatform.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Babylon::ThreadConfiguration
+{
+    namespace
+    {
+        // Linux limits thread names to 16 characters including the null terminator.
+        constexpr size_t MAX_NAME_LENGTH{15};
+    }
+
+    void ApplyPlatformSettings(const std::string& name, const ThreadSettings& settings)
+    {
+        const auto threadId{static_cast<pid_t>(syscall(SYS_gettid))};
+
+        // Renaming the main thread also renames the process (as shown by ps, top, etc.), so leave it alone.
+        if (!name.empty() && threadId != getpid())
+        {
+            pthread_setname_np(pthread_self(), name.substr(0, MAX_NAME_LENGTH).c_str());
+        }
+
+        // On Linux, nice values are per thread when addressed by thread id.
+        if (settings.Priority)
+        {
+            setpriority(PRIO_PROCESS, static_cast<id_t>(threadId), *settings.Priority);
+        }
+
+        if (settings.AffinityMask != 0)
+        {
+            cpu_set_t cpuSet{};
+            CPU_ZERO(&cpuSet);
+            for (int cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; ++cpu)
+            {
+                if ((settings.AffinityMask & (uint64_t{1} << cpu)) != 0)
+                {
+                    CPU_SET(cpu, &cpuSet);
+                }
+            }
+
+            sched_setaffinity(0, sizeof(cpuSet), &cpuSet);
+        }
+    }
+}
@@ -0,0 +1,28 @@
+#include "ThreadConfigurationPlatform.h"
+
+#include <Windows.h>
+
+namespace Babylon::ThreadConfiguration
+{
+    void ApplyPlatformSettings(const std::string& name, const ThreadSettings& settings)
+    {
+        if (!name.empty())
+        {
+            // Thread names are ASCII, so a simple widening is enough.
+            const std::wstring wideName{name.begin(), name.end()};
+            SetThreadDescription(GetCurrentThread(), wideName.c_str());
+        }
+
+        if (settings.Priority)
+        {
+            SetThreadPriority(GetCurrentThread(), *settings.Priority);
+        }
+
+#if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
+        if (settings.AffinityMask != 0)
+        {
+            SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(settings.AffinityMask));
+        }
+#endif
+    }
+}
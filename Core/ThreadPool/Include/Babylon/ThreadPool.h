@@ -0,0 +1,144 @@
+#pragma once
+
+#include <arcana/threading/cancellation.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Babylon
+{
+    enum class TaskPriority
+    {
+        Low,
+        Normal,
+        High,
+    };
+
+    /**
+     * Work-stealing thread pool for CPU-heavy background work such as image decoding and shader
+     * compilation. Every worker owns one queue per priority and idle workers steal from the others.
+     * Tasks can be tied to an arcana cancellation. Once it fires, tasks queued for it are handed back
+     * to arcana (which completes them as cancelled without running their bodies) as soon as a worker
+     * reaches them, and tasks queued afterwards complete immediately on the calling thread.
+     */
+    class ThreadPool final
+    {
+    public:
+        struct Statistics
+        {
+            size_t WorkerCount{};
+            size_t QueuedTasks{};
+            size_t PeakQueuedTasks{};
+            size_t ActiveTasks{};
+            uint64_t CompletedTasks{};
+            uint64_t CancelledTasks{};
+            uint64_t StolenTasks{};
+            // Time between a task being queued and a worker picking it up, over completed tasks.
+            double AverageQueueLatencyMs{};
+            double MaxQueueLatencyMs{};
+            double AverageExecutionTimeMs{};
+        };
+
+        /**
+         * Scheduler that queues continuations on a ThreadPool.
+         * Intended to be consumed by arcana.cpp tasks.
+         */
+        class Scheduler
+        {
+        public:
+            template<typename CallableT>
+            void operator()(CallableT&& callable) const
+            {
+                m_pool.Enqueue(std::forward<CallableT>(callable), m_priority, m_cancellation);
+            }
+
+        private:
+            friend class ThreadPool;
+
+            Scheduler(ThreadPool& pool, TaskPriority priority, const arcana::cancellation* cancellation)
+                : m_pool{pool}
+                , m_priority{priority}
+                , m_cancellation{cancellation}
+            {
+            }
+
+            ThreadPool& m_pool;
+            TaskPriority m_priority;
+            const arcana::cancellation* m_cancellation;
+        };
+
+        // A worker count of zero uses one worker per hardware thread, minus one for the calling thread.
+        explicit ThreadPool(size_t workerCount = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Sets the worker count of the process-wide pool. Must be called before GetDefault is first used.
+        static void ConfigureDefault(size_t workerCount);
+        static ThreadPool& GetDefault();
+
+        size_t WorkerCount() const;
+
+        // The cancellation, if any, must outlive the queued tasks.
+        Scheduler GetScheduler(TaskPriority priority = TaskPriority::Normal, const arcana::cancellation* cancellation = nullptr);
+        void Enqueue(std::function<void()> task, TaskPriority priority = TaskPriority::Normal, const arcana::cancellation* cancellation = nullptr);
+
+        // Runs body for every index in [0, count) on the calling thread and up to WorkerCount() workers, and
+        // returns once all of them completed. The calling thread never waits on a queued task that has not
+        // started, so this is safe to call from a worker. The first exception thrown by body is rethrown.
+        void ParallelFor(size_t count, const std::function<void(size_t)>& body, TaskPriority priority = TaskPriority::High);
+
+        Statistics GetStatistics() const;
+
+    private:
+        static constexpr size_t PRIORITY_COUNT{static_cast<size_t>(TaskPriority::High) + 1};
+
+        using Clock = std::chrono::steady_clock;
+
+        struct Task
+        {
+            std::function<void()> Function{};
+            const arcana::cancellation* Cancellation{};
+            Clock::time_point QueuedTime{};
+        };
+
+        struct Worker
+        {
+            std::mutex Mutex{};
+            std::array<std::deque<Task>, PRIORITY_COUNT> Queues{};
+            std::thread Thread{};
+        };
+
+        void Run(size_t workerIndex);
+        bool TryPop(size_t workerIndex, Task& task);
+        void Execute(Task& task);
+
+        std::vector<std::unique_ptr<Worker>> m_workers{};
+        std::atomic<size_t> m_nextWorker{};
+
+        std::mutex m_wakeMutex{};
+        std::condition_variable m_wakeCondition{};
+        bool m_shutdown{};
+
+        std::atomic<size_t> m_queuedTasks{};
+        std::atomic<size_t> m_peakQueuedTasks{};
+        std::atomic<size_t> m_activeTasks{};
+        std::atomic<uint64_t> m_completedTasks{};
+        std::atomic<uint64_t> m_cancelledTasks{};
+        std::atomic<uint64_t> m_stolenTasks{};
+
+        mutable std::mutex m_statisticsMutex{};
+        double m_totalQueueLatencyMs{};
+        double m_maxQueueLatencyMs{};
+        double m_totalExecutionTimeMs{};
+    };
+}
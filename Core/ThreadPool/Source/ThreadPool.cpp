@@ -0,0 +1,312 @@
+#include <Babylon/ThreadPool.h>
+#include <Babylon/ThreadConfiguration.h>
+
+#include <algorithm>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+
+namespace Babylon
+{
+    namespace
+    {
+        // Identifies the pool and worker the current thread belongs to, so that tasks queued from
+        // a worker land in that worker's own queues.
+        thread_local const ThreadPool* t_currentPool{};
+        thread_local size_t t_currentWorker{};
+
+        struct DefaultPoolState
+        {
+            std::mutex Mutex{};
+            size_t WorkerCount{};
+            std::optional<ThreadPool> Pool{};
+        };
+
+        DefaultPoolState& GetDefaultPoolState()
+        {
+            static DefaultPoolState state{};
+            return state;
+        }
+
+        double ToMilliseconds(std::chrono::steady_clock::duration duration)
+        {
+            return std::chrono::duration<double, std::milli>{duration}.count();
+        }
+    }
+
+    ThreadPool::ThreadPool(size_t workerCount)
+    {
+        if (workerCount == 0)
+        {
+            workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+        }
+
+        m_workers.reserve(workerCount);
+        for (size_t index = 0; index < workerCount; ++index)
+        {
+            m_workers.push_back(std::make_unique<Worker>());
+        }
+
+        // Start the threads only once all workers exist, since any of them may be stolen from.
+        for (size_t index = 0; index < workerCount; ++index)
+        {
+            m_workers[index]->Thread = std::thread{[this, index] { Run(index); }};
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::scoped_lock lock{m_wakeMutex};
+            m_shutdown = true;
+        }
+
+        m_wakeCondition.notify_all();
+
+        // Tasks still queued at this point are destroyed without running.
+        for (auto& worker : m_workers)
+        {
+            worker->Thread.join();
+        }
+    }
+
+    void ThreadPool::ConfigureDefault(size_t workerCount)
+    {
+        auto& state{GetDefaultPoolState()};
+        std::scoped_lock lock{state.Mutex};
+
+        if (state.Pool)
+        {
+            throw std::runtime_error{"The default thread pool cannot be configured after it has been created."};
+        }
+
+        state.WorkerCount = workerCount;
+    }
+
+    ThreadPool& ThreadPool::GetDefault()
+    {
+        auto& state{GetDefaultPoolState()};
+        std::scoped_lock lock{state.Mutex};
+
+        if (!state.Pool)
+        {
+            state.Pool.emplace(state.WorkerCount);
+        }
+
+        return *state.Pool;
+    }
+
+    size_t ThreadPool::WorkerCount() const
+    {
+        return m_workers.size();
+    }
+
+    ThreadPool::Scheduler ThreadPool::GetScheduler(TaskPriority priority, const arcana::cancellation* cancellation)
+    {
+        return {*this, priority, cancellation};
+    }
+
+    void ThreadPool::Enqueue(std::function<void()> function, TaskPriority priority, const arcana::cancellation* cancellation)
+    {
+        // Work that is already cancelled is a no-op for arcana, so complete it right away rather than queueing it.
+        if (cancellation != nullptr && cancellation->cancelled())
+        {
+            ++m_cancelledTasks;
+            function();
+            return;
+        }
+
+        const size_t workerIndex{t_currentPool == this ? t_currentWorker : m_nextWorker++ % m_workers.size()};
+
+        auto& worker{*m_workers[workerIndex]};
+        {
+            std::scoped_lock lock{worker.Mutex};
+            worker.Queues[static_cast<size_t>(priority)].push_back({std::move(function), cancellation, Clock::now()});
+        }
+
+        const size_t queuedTasks{++m_queuedTasks};
+        size_t peakQueuedTasks{m_peakQueuedTasks.load()};
+        while (queuedTasks > peakQueuedTasks && !m_peakQueuedTasks.compare_exchange_weak(peakQueuedTasks, queuedTasks))
+        {
+        }
+
+        {
+            // Taking the lock orders this notification after a worker's predicate check.
+            std::scoped_lock lock{m_wakeMutex};
+        }
+
+        m_wakeCondition.notify_one();
+    }
+
+    void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& body, TaskPriority priority)
+    {
+        // Indices are claimed through a shared counter. Helpers that start after every index was claimed
+        // return without touching body, which may be gone by then.
+        struct State
+        {
+            const std::function<void(size_t)>* Body{};
+            size_t Count{};
+            std::atomic<size_t> Next{};
+            std::atomic<size_t> Completed{};
+            std::mutex Mutex{};
+            std::condition_variable Condition{};
+            std::exception_ptr Exception{};
+
+            void Work()
+            {
+                for (size_t index = Next++; index < Count; index = Next++)
+                {
+                    try
+                    {
+                        (*Body)(index);
+                    }
+                    catch (...)
+                    {
+                        std::scoped_lock lock{Mutex};
+                        if (!Exception)
+                        {
+                            Exception = std::current_exception();
+                        }
+                    }
+
+                    if (++Completed == Count)
+                    {
+                        std::scoped_lock lock{Mutex};
+                        Condition.notify_all();
+                    }
+                }
+            }
+        };
+
+        if (count == 0)
+        {
+            return;
+        }
+
+        auto state{std::make_shared<State>()};
+        state->Body = &body;
+        state->Count = count;
+
+        const size_t helperCount{std::min(m_workers.size(), count - 1)};
+        for (size_t helper = 0; helper < helperCount; ++helper)
+        {
+            Enqueue([state]() { state->Work(); }, priority);
+        }
+
+        state->Work();
+
+        std::unique_lock lock{state->Mutex};
+        state->Condition.wait(lock, [&state]() { return state->Completed == state->Count; });
+
+        if (state->Exception)
+        {
+            std::rethrow_exception(state->Exception);
+        }
+    }
+
+    ThreadPool::Statistics ThreadPool::GetStatistics() const
+    {
+        Statistics statistics{};
+        statistics.WorkerCount = m_workers.size();
+        statistics.QueuedTasks = m_queuedTasks;
+        statistics.PeakQueuedTasks = m_peakQueuedTasks;
+        statistics.ActiveTasks = m_activeTasks;
+        statistics.CompletedTasks = m_completedTasks;
+        statistics.CancelledTasks = m_cancelledTasks;
+        statistics.StolenTasks = m_stolenTasks;
+
+        std::scoped_lock lock{m_statisticsMutex};
+        if (statistics.CompletedTasks > 0)
+        {
+            statistics.AverageQueueLatencyMs = m_totalQueueLatencyMs / statistics.CompletedTasks;
+            statistics.AverageExecutionTimeMs = m_totalExecutionTimeMs / statistics.CompletedTasks;
+        }
+        statistics.MaxQueueLatencyMs = m_maxQueueLatencyMs;
+
+        return statistics;
+    }
+
+    void ThreadPool::Run(size_t workerIndex)
+    {
+        t_currentPool = this;
+        t_currentWorker = workerIndex;
+        ThreadConfiguration::ApplyToCurrentThread(ThreadRole::Worker);
+
+        while (true)
+        {
+            Task task{};
+            if (TryPop(workerIndex, task))
+            {
+                Execute(task);
+                continue;
+            }
+
+            std::unique_lock lock{m_wakeMutex};
+            m_wakeCondition.wait(lock, [this] { return m_shutdown || m_queuedTasks > 0; });
+            if (m_shutdown)
+            {
+                return;
+            }
+        }
+    }
+
+    bool ThreadPool::TryPop(size_t workerIndex, Task& task)
+    {
+        // Highest priority first. Within a priority, a worker serves its own queue in FIFO order and
+        // steals from the back of the other workers' queues.
+        for (size_t priority = PRIORITY_COUNT; priority-- > 0;)
+        {
+            for (size_t offset = 0; offset < m_workers.size(); ++offset)
+            {
+                auto& worker{*m_workers[(workerIndex + offset) % m_workers.size()]};
+                std::scoped_lock lock{worker.Mutex};
+                auto& queue{worker.Queues[priority]};
+                if (queue.empty())
+                {
+                    continue;
+                }
+
+                if (offset == 0)
+                {
+                    task = std::move(queue.front());
+                    queue.pop_front();
+                }
+                else
+                {
+                    task = std::move(queue.back());
+                    queue.pop_back();
+                    ++m_stolenTasks;
+                }
+
+                --m_queuedTasks;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void ThreadPool::Execute(Task& task)
+    {
+        if (task.Cancellation != nullptr && task.Cancellation->cancelled())
+        {
+            ++m_cancelledTasks;
+            task.Function();
+            return;
+        }
+
+        const auto startTime{Clock::now()};
+        ++m_activeTasks;
+        task.Function();
+        --m_activeTasks;
+        const auto endTime{Clock::now()};
+
+        ++m_completedTasks;
+
+        const double queueLatencyMs{ToMilliseconds(startTime - task.QueuedTime)};
+        std::scoped_lock lock{m_statisticsMutex};
+        m_totalQueueLatencyMs += queueLatencyMs;
+        m_maxQueueLatencyMs = std::max(m_maxQueueLatencyMs, queueLatencyMs);
+        m_totalExecutionTimeMs += ToMilliseconds(endTime - startTime);
+    }
+}
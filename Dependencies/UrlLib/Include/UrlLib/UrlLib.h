@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <arcana/threading/task.h>
 
@@ -55,4 +56,9 @@ namespace UrlLib
         class Impl;
         std::shared_ptr<Impl> m_impl{};
     };
+
+    // Sets a callback that runs on each thread UrlLib creates internally, before the thread services
+    // any request (e.g. to name the thread or change its priority). Must be called before the first
+    // request is sent. Platforms that rely on system-managed threads never invoke the callback.
+    void SetThreadStartCallback(std::function<void()> callback);
 }
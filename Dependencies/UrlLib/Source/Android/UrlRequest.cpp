@@ -37,6 +37,11 @@ namespace UrlLib
             Abort();
         }
 
+        static void SetThreadStartCallback(std::function<void()>)
+        {
+            // Requests run on system-managed threads, so there is nothing to configure.
+        }
+
         void Abort()
         {
             m_cancellationSource.cancel();
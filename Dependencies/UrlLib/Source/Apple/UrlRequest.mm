@@ -18,6 +18,11 @@ namespace UrlLib
             }
         }
 
+        static void SetThreadStartCallback(std::function<void()>)
+        {
+            // Requests run on system-managed threads, so there is nothing to configure.
+        }
+
         void Abort()
         {
             m_cancellationSource.cancel();
@@ -57,4 +57,9 @@ namespace UrlLib
     {
         return m_impl->ResponseBuffer();
     }
+
+    void SetThreadStartCallback(std::function<void()> callback)
+    {
+        UrlRequest::Impl::SetThreadStartCallback(std::move(callback));
+    }
 }
@@ -14,6 +14,11 @@ namespace UrlLib
             Abort();
         }
 
+        static void SetThreadStartCallback(std::function<void()> callback)
+        {
+            s_threadStartCallback = std::move(callback);
+        }
+
         void Abort()
         {
             m_cancellationSource.cancel();
@@ -84,6 +89,11 @@ namespace UrlLib
                 curl_multi_setopt(m_multiHandle, CURLMOPT_MAX_TOTAL_CONNECTIONS, 200);
                 curl_multi_setopt(m_multiHandle, CURLMOPT_MAX_HOST_CONNECTIONS, 6L);
                 m_thread = std::thread([this](){
+                    if (s_threadStartCallback)
+                    {
+                        s_threadStartCallback();
+                    }
+
                     Loop();
                 });
             }
@@ -186,11 +196,18 @@ namespace UrlLib
                 curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, callback);
                 curl_easy_setopt(curl, CURLOPT_WRITEDATA, &data);
                 curl_easy_setopt(curl, CURLOPT_PRIVATE, this);
-                s_curlMulti.AddHandle(curl);
+                GetCurlMulti().AddHandle(curl);
             }
         }
 
-        static inline CurlMulti s_curlMulti{};
+        // Created on first use so that the thread start callback can be set beforehand.
+        static CurlMulti& GetCurlMulti()
+        {
+            static CurlMulti curlMulti{};
+            return curlMulti;
+        }
+
+        static inline std::function<void()> s_threadStartCallback{};
         arcana::cancellation_source m_cancellationSource{};
         arcana::task_completion_source<void, std::exception_ptr> m_taskCompletionSource{};
         UrlResponseType m_responseType{UrlResponseType::String};
@@ -4,7 +4,31 @@
 
 #include <napi/env.h>
 
+#include <string>
+
 namespace Babylon::Plugins::NativeEngine
 {
     void Initialize(Napi::Env env);
+
+    // Caches decoded, upload-ready textures in an existing directory across runs, evicting the least
+    // recently used ones beyond maxBytes. Applies to engines created after the call.
+    void EnableTextureDiskCache(std::string directory, uint64_t maxBytes);
+
+    // Caches compiled shaders in an existing directory across runs, evicting the least recently used ones
+    // beyond maxBytes. Compiled shaders are always cached in memory for the lifetime of the process.
+    void EnableShaderDiskCache(std::string directory, uint64_t maxBytes);
+
+    // Serves compiled shaders from a pack built offline by the ShaderPacker tool for the renderer in use,
+    // so that programs found in it are never compiled on the device. Throws if the pack is invalid.
+    void LoadShaderPack(std::string path);
+
+    // Makes createProgram and createProgramAsync fail for programs that are not in a loaded shader pack instead
+    // of compiling them on the device, for deployments that ship every shader they use in packs.
+    void EnableShaderPackOnlyMode();
+
+    // Records the shader sources of every program created by the engine into a manifest file. The programs
+    // already recorded there are compiled in the background as soon as the plugin is initialized, so that
+    // scenes find them ready. Call before Initialize; combine with the shader disk cache to also skip the
+    // compilation itself on later runs.
+    void EnableShaderManifest(std::string path);
 }
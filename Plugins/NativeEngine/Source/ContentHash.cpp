@@ -0,0 +1,109 @@
+#include "ContentHash.h"
+
+#include <cstring>
+
+namespace Babylon
+{
+    namespace
+    {
+        constexpr uint64_t PRIME1{0x9E3779B185EBCA87ULL};
+        constexpr uint64_t PRIME2{0xC2B2AE3D27D4EB4FULL};
+        constexpr uint64_t PRIME3{0x165667B19E3779F9ULL};
+        constexpr uint64_t PRIME4{0x85EBCA77C2B2AE63ULL};
+        constexpr uint64_t PRIME5{0x27D4EB2F165667C5ULL};
+
+        uint64_t RotateLeft(uint64_t value, int bits)
+        {
+            return (value << bits) | (value >> (64 - bits));
+        }
+
+        uint64_t Read64(const uint8_t* ptr)
+        {
+            uint64_t value;
+            std::memcpy(&value, ptr, sizeof(value));
+            return value;
+        }
+
+        uint32_t Read32(const uint8_t* ptr)
+        {
+            uint32_t value;
+            std::memcpy(&value, ptr, sizeof(value));
+            return value;
+        }
+
+        uint64_t Round(uint64_t accumulator, uint64_t input)
+        {
+            accumulator += input * PRIME2;
+            accumulator = RotateLeft(accumulator, 31);
+            return accumulator * PRIME1;
+        }
+
+        uint64_t MergeRound(uint64_t accumulator, uint64_t value)
+        {
+            accumulator ^= Round(0, value);
+            return accumulator * PRIME1 + PRIME4;
+        }
+    }
+
+    uint64_t ContentHash(gsl::span<const uint8_t> data, uint64_t seed)
+    {
+        // Reads are little-endian, which every supported platform is.
+        const uint8_t* ptr{data.data()};
+        const uint8_t* const end{ptr + data.size()};
+        uint64_t hash{};
+
+        if (data.size() >= 32)
+        {
+            uint64_t v1{seed + PRIME1 + PRIME2};
+            uint64_t v2{seed + PRIME2};
+            uint64_t v3{seed};
+            uint64_t v4{seed - PRIME1};
+
+            for (const uint8_t* const limit{end - 32}; ptr <= limit; ptr += 32)
+            {
+                v1 = Round(v1, Read64(ptr));
+                v2 = Round(v2, Read64(ptr + 8));
+                v3 = Round(v3, Read64(ptr + 16));
+                v4 = Round(v4, Read64(ptr + 24));
+            }
+
+            hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+            hash = MergeRound(hash, v1);
+            hash = MergeRound(hash, v2);
+            hash = MergeRound(hash, v3);
+            hash = MergeRound(hash, v4);
+        }
+        else
+        {
+            hash = seed + PRIME5;
+        }
+
+        hash += static_cast<uint64_t>(data.size());
+
+        for (; ptr + 8 <= end; ptr += 8)
+        {
+            hash ^= Round(0, Read64(ptr));
+            hash = RotateLeft(hash, 27) * PRIME1 + PRIME4;
+        }
+
+        if (ptr + 4 <= end)
+        {
+            hash ^= static_cast<uint64_t>(Read32(ptr)) * PRIME1;
+            hash = RotateLeft(hash, 23) * PRIME2 + PRIME3;
+            ptr += 4;
+        }
+
+        for (; ptr < end; ++ptr)
+        {
+            hash ^= (*ptr) * PRIME5;
+            hash = RotateLeft(hash, 11) * PRIME1;
+        }
+
+        hash ^= hash >> 33;
+        hash *= PRIME2;
+        hash ^= hash >> 29;
+        hash *= PRIME3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+}
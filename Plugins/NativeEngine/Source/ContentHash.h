@@ -0,0 +1,12 @@
+#pragma once
+
+#include <gsl/gsl>
+
+#include <cstdint>
+
+namespace Babylon
+{
+    // 64-bit xxHash (XXH64) of a block of memory. Fast enough to run over encoded asset bytes on the
+    // JavaScript thread, and used to identify identical content across loads.
+    uint64_t ContentHash(gsl::span<const uint8_t> data, uint64_t seed = 0);
+}
@@ -0,0 +1,190 @@
+#include "DiskCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace Babylon
+{
+    namespace
+    {
+        bool ReadFile(const std::string& path, std::vector<uint8_t>& data)
+        {
+            std::ifstream file{path, std::ios::binary | std::ios::ate};
+            if (!file)
+            {
+                return false;
+            }
+
+            data.resize(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            return static_cast<bool>(file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size())));
+        }
+    }
+
+    DiskCache::DiskCache(std::string directory, std::string extension, uint64_t maxBytes)
+        : m_directory{std::move(directory)}
+        , m_extension{std::move(extension)}
+        , m_maxBytes{maxBytes}
+    {
+        ReadIndex();
+    }
+
+    DiskCache::~DiskCache()
+    {
+        // Persists the use order of entries read since the last write.
+        std::scoped_lock lock{m_mutex};
+        WriteIndex();
+    }
+
+    std::optional<std::vector<uint8_t>> DiskCache::Read(uint64_t key)
+    {
+        {
+            std::scoped_lock lock{m_mutex};
+            auto it{m_entries.find(key)};
+            if (it == m_entries.end())
+            {
+                ++m_misses;
+                return {};
+            }
+
+            it->second.LastUse = ++m_useCounter;
+        }
+
+        std::vector<uint8_t> data{};
+        const bool read{ReadFile(GetPath(key), data)};
+
+        std::scoped_lock lock{m_mutex};
+        if (!read)
+        {
+            ++m_misses;
+            RemoveLocked(key);
+            return {};
+        }
+
+        ++m_hits;
+        return data;
+    }
+
+    void DiskCache::Write(uint64_t key, gsl::span<const uint8_t> data)
+    {
+        if (static_cast<uint64_t>(data.size()) > m_maxBytes)
+        {
+            return;
+        }
+
+        const auto path{GetPath(key)};
+
+        // Written under a temporary name so that readers never see a partial file. The name is unique to this
+        // write, as writes of the same key may run concurrently outside the lock.
+        const auto temporaryPath{path + "." + std::to_string(++m_temporaryCounter) + ".tmp"};
+        {
+            std::ofstream file{temporaryPath, std::ios::binary | std::ios::trunc};
+            if (!file || !file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size())))
+            {
+                std::remove(temporaryPath.c_str());
+                return;
+            }
+        }
+
+        std::scoped_lock lock{m_mutex};
+
+        // Renaming over an existing file fails on some platforms.
+        RemoveLocked(key);
+        if (std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+        {
+            std::remove(temporaryPath.c_str());
+            return;
+        }
+
+        m_entries[key] = {static_cast<uint64_t>(data.size()), ++m_useCounter};
+        m_totalBytes += data.size();
+
+        EvictLocked();
+        WriteIndex();
+    }
+
+    void DiskCache::Remove(uint64_t key)
+    {
+        std::scoped_lock lock{m_mutex};
+        if (m_hits > 0)
+        {
+            --m_hits;
+        }
+
+        ++m_misses;
+        RemoveLocked(key);
+    }
+
+    DiskCache::Statistics DiskCache::GetStatistics() const
+    {
+        std::scoped_lock lock{m_mutex};
+        return {m_hits, m_misses, m_entries.size(), m_totalBytes};
+    }
+
+    std::string DiskCache::GetPath(uint64_t key) const
+    {
+        std::ostringstream path{};
+        path << m_directory << '/' << std::hex << std::setw(16) << std::setfill('0') << key << m_extension;
+        return path.str();
+    }
+
+    std::string DiskCache::GetIndexPath() const
+    {
+        return m_directory + "/index" + m_extension + ".txt";
+    }
+
+    void DiskCache::ReadIndex()
+    {
+        std::ifstream index{GetIndexPath()};
+
+        uint64_t key{};
+        Entry entry{};
+        while (index >> std::hex >> key >> std::dec >> entry.Bytes >> entry.LastUse)
+        {
+            m_entries[key] = entry;
+            m_totalBytes += entry.Bytes;
+            m_useCounter = std::max(m_useCounter, entry.LastUse);
+        }
+    }
+
+    void DiskCache::WriteIndex() const
+    {
+        std::ofstream index{GetIndexPath(), std::ios::trunc};
+        for (const auto& [key, entry] : m_entries)
+        {
+            index << std::hex << key << ' ' << std::dec << entry.Bytes << ' ' << entry.LastUse << '\n';
+        }
+    }
+
+    void DiskCache::EvictLocked()
+    {
+        while (m_totalBytes > m_maxBytes && !m_entries.empty())
+        {
+            auto oldest{m_entries.begin()};
+            for (auto it{m_entries.begin()}; it != m_entries.end(); ++it)
+            {
+                if (it->second.LastUse < oldest->second.LastUse)
+                {
+                    oldest = it;
+                }
+            }
+
+            RemoveLocked(oldest->first);
+        }
+    }
+
+    void DiskCache::RemoveLocked(uint64_t key)
+    {
+        auto it{m_entries.find(key)};
+        if (it != m_entries.end())
+        {
+            m_totalBytes -= it->second.Bytes;
+            m_entries.erase(it);
+        }
+
+        std::remove(GetPath(key).c_str());
+    }
+}
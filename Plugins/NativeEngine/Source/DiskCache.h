@@ -0,0 +1,71 @@
+#pragma once
+
+#include <gsl/gsl>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Babylon
+{
+    /// Stores blobs as files in a host-provided directory, keyed by 64-bit hashes. An index file in the
+    /// directory tracks entry sizes and use order across runs so that the least recently used entries are
+    /// evicted once the total size exceeds the cap. Thread-safe.
+    class DiskCache final
+    {
+    public:
+        struct Statistics
+        {
+            uint64_t Hits{};
+            uint64_t Misses{};
+            size_t Entries{};
+            uint64_t Bytes{};
+        };
+
+        // The directory must exist. Entry files are named after their key with the given extension.
+        DiskCache(std::string directory, std::string extension, uint64_t maxBytes);
+        ~DiskCache();
+
+        DiskCache(const DiskCache&) = delete;
+        DiskCache& operator=(const DiskCache&) = delete;
+
+        std::optional<std::vector<uint8_t>> Read(uint64_t key);
+        void Write(uint64_t key, gsl::span<const uint8_t> data);
+
+        // Drops an entry, typically one whose content failed validation; the read is counted as a miss.
+        void Remove(uint64_t key);
+
+        Statistics GetStatistics() const;
+
+    private:
+        struct Entry
+        {
+            uint64_t Bytes{};
+            uint64_t LastUse{};
+        };
+
+        std::string GetPath(uint64_t key) const;
+        std::string GetIndexPath() const;
+        void ReadIndex();
+        void WriteIndex() const;
+        void EvictLocked();
+        void RemoveLocked(uint64_t key);
+
+        const std::string m_directory;
+        const std::string m_extension;
+        const uint64_t m_maxBytes;
+
+        mutable std::mutex m_mutex{};
+        std::map<uint64_t, Entry> m_entries{};
+        uint64_t m_totalBytes{};
+        uint64_t m_useCounter{};
+        uint64_t m_hits{};
+        uint64_t m_misses{};
+
+        // Suffixes temporary file names so that concurrent writes of the same key never share a file.
+        std::atomic<uint64_t> m_temporaryCounter{};
+    };
+}
@@ -0,0 +1,566 @@
+#include "Ktx2.h"
+
+#ifdef BASIS_TRANSCODER
+#include <transcoder/basisu_transcoder.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+
+namespace Babylon::Ktx2
+{
+    namespace
+    {
+        constexpr std::array<uint8_t, 12> IDENTIFIER{0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+        struct Header
+        {
+            uint8_t Identifier[12];
+            uint32_t VkFormat;
+            uint32_t TypeSize;
+            uint32_t PixelWidth;
+            uint32_t PixelHeight;
+            uint32_t PixelDepth;
+            uint32_t LayerCount;
+            uint32_t FaceCount;
+            uint32_t LevelCount;
+            uint32_t SupercompressionScheme;
+            uint32_t DfdByteOffset;
+            uint32_t DfdByteLength;
+            uint32_t KvdByteOffset;
+            uint32_t KvdByteLength;
+            uint64_t SgdByteOffset;
+            uint64_t SgdByteLength;
+        };
+
+        struct LevelIndex
+        {
+            uint64_t ByteOffset;
+            uint64_t ByteLength;
+            uint64_t UncompressedByteLength;
+        };
+
+        // Basic data format descriptor block, followed by one DfdSample per sample.
+        struct DfdBasicBlock
+        {
+            uint32_t VendorIdAndDescriptorType;
+            uint16_t VersionNumber;
+            uint16_t DescriptorBlockSize;
+            uint8_t ColorModel;
+            uint8_t ColorPrimaries;
+            uint8_t TransferFunction;
+            uint8_t Flags;
+            uint8_t TexelBlockDimension[4];
+            uint8_t BytesPlane[8];
+        };
+
+        struct DfdSample
+        {
+            uint16_t BitOffset;
+            uint8_t BitLength;
+            uint8_t ChannelType;
+            uint8_t SamplePosition[4];
+            uint32_t SampleLower;
+            uint32_t SampleUpper;
+        };
+
+        static_assert(sizeof(Header) == 80);
+        static_assert(sizeof(LevelIndex) == 24);
+        static_assert(sizeof(DfdBasicBlock) == 24);
+        static_assert(sizeof(DfdSample) == 16);
+
+        // Values from the Khronos Data Format Specification 1.3.
+        constexpr uint16_t KHR_DF_VERSIONNUMBER_1_3{2};
+        constexpr uint8_t KHR_DF_MODEL_RGBSDA{1};
+        constexpr uint8_t KHR_DF_MODEL_BC1A{128};
+        constexpr uint8_t KHR_DF_MODEL_BC2{129};
+        constexpr uint8_t KHR_DF_MODEL_BC3{130};
+        constexpr uint8_t KHR_DF_MODEL_BC4{131};
+        constexpr uint8_t KHR_DF_MODEL_BC5{132};
+        constexpr uint8_t KHR_DF_MODEL_BC6H{133};
+        constexpr uint8_t KHR_DF_MODEL_BC7{134};
+        constexpr uint8_t KHR_DF_MODEL_ETC2{161};
+        constexpr uint8_t KHR_DF_MODEL_ASTC{162};
+        constexpr uint8_t KHR_DF_PRIMARIES_BT709{1};
+        constexpr uint8_t KHR_DF_TRANSFER_LINEAR{1};
+        constexpr uint8_t KHR_DF_CHANNEL_RED{0};
+        constexpr uint8_t KHR_DF_CHANNEL_GREEN{1};
+        constexpr uint8_t KHR_DF_CHANNEL_BLUE{2};
+        constexpr uint8_t KHR_DF_CHANNEL_ALPHA{15};
+        constexpr uint8_t KHR_DF_CHANNEL_COLOR{0};
+        constexpr uint8_t KHR_DF_CHANNEL_BC1A_ALPHAPRESENT{1};
+        constexpr uint8_t KHR_DF_CHANNEL_ETC2_COLOR{2};
+        constexpr uint8_t KHR_DF_SAMPLE_DATATYPE_SIGNED{0x40};
+        constexpr uint8_t KHR_DF_SAMPLE_DATATYPE_FLOAT{0x80};
+
+        // IEEE 754 bit patterns of -1.0f and 1.0f, the sample range of float formats.
+        constexpr uint32_t FLOAT_MINUS_ONE{0xBF800000};
+        constexpr uint32_t FLOAT_ONE{0x3F800000};
+
+        constexpr uint32_t SUPERCOMPRESSION_NONE{0};
+        constexpr uint32_t SUPERCOMPRESSION_BASIS_LZ{1};
+
+        // VK_FORMAT_UNDEFINED, used by Basis Universal payloads.
+        constexpr uint32_t VK_FORMAT_UNDEFINED{0};
+
+        // bimg stores dimensions as 16 bits.
+        constexpr uint32_t MAX_DIMENSION{std::numeric_limits<uint16_t>::max()};
+
+        bimg::TextureFormat::Enum ToTextureFormat(uint32_t vkFormat)
+        {
+            // UNORM and SRGB variants map to the same bimg format; color space is handled by the shaders.
+            switch (vkFormat)
+            {
+                case 9: case 15: return bimg::TextureFormat::R8;
+                case 23: case 29: return bimg::TextureFormat::RGB8;
+                case 37: case 43: return bimg::TextureFormat::RGBA8;
+                case 44: case 50: return bimg::TextureFormat::BGRA8;
+                case 97: return bimg::TextureFormat::RGBA16F;
+                case 109: return bimg::TextureFormat::RGBA32F;
+                case 131: case 132: case 133: case 134: return bimg::TextureFormat::BC1;
+                case 135: case 136: return bimg::TextureFormat::BC2;
+                case 137: case 138: return bimg::TextureFormat::BC3;
+                case 139: case 140: return bimg::TextureFormat::BC4;
+                case 141: case 142: return bimg::TextureFormat::BC5;
+                case 143: case 144: return bimg::TextureFormat::BC6H;
+                case 145: case 146: return bimg::TextureFormat::BC7;
+                case 147: case 148: return bimg::TextureFormat::ETC2;
+                case 149: case 150: return bimg::TextureFormat::ETC2A1;
+                case 151: case 152: return bimg::TextureFormat::ETC2A;
+                case 157: case 158: return bimg::TextureFormat::ASTC4x4;
+                case 161: case 162: return bimg::TextureFormat::ASTC5x5;
+                case 165: case 166: return bimg::TextureFormat::ASTC6x6;
+                case 167: case 168: return bimg::TextureFormat::ASTC8x5;
+                case 169: case 170: return bimg::TextureFormat::ASTC8x6;
+                case 173: case 174: return bimg::TextureFormat::ASTC10x5;
+                default: return bimg::TextureFormat::Unknown;
+            }
+        }
+
+        uint32_t ToVkFormat(bimg::TextureFormat::Enum format)
+        {
+            switch (format)
+            {
+                case bimg::TextureFormat::R8: return 9;
+                case bimg::TextureFormat::RGB8: return 23;
+                case bimg::TextureFormat::RGBA8: return 37;
+                case bimg::TextureFormat::BGRA8: return 44;
+                case bimg::TextureFormat::RGBA16F: return 97;
+                case bimg::TextureFormat::RGBA32F: return 109;
+                case bimg::TextureFormat::BC1: return 133;
+                case bimg::TextureFormat::BC2: return 135;
+                case bimg::TextureFormat::BC3: return 137;
+                case bimg::TextureFormat::BC4: return 139;
+                case bimg::TextureFormat::BC5: return 141;
+                case bimg::TextureFormat::BC6H: return 143;
+                case bimg::TextureFormat::BC7: return 145;
+                case bimg::TextureFormat::ETC2: return 147;
+                case bimg::TextureFormat::ETC2A1: return 149;
+                case bimg::TextureFormat::ETC2A: return 151;
+                case bimg::TextureFormat::ASTC4x4: return 157;
+                case bimg::TextureFormat::ASTC5x5: return 161;
+                case bimg::TextureFormat::ASTC6x6: return 165;
+                case bimg::TextureFormat::ASTC8x5: return 167;
+                case bimg::TextureFormat::ASTC8x6: return 169;
+                case bimg::TextureFormat::ASTC10x5: return 173;
+                default: return VK_FORMAT_UNDEFINED;
+            }
+        }
+
+        uint32_t TypeSize(bimg::TextureFormat::Enum format)
+        {
+            switch (format)
+            {
+                case bimg::TextureFormat::RGBA16F: return 2;
+                case bimg::TextureFormat::RGBA32F: return 4;
+                default: return 1;
+            }
+        }
+
+        struct FormatSample
+        {
+            uint8_t Channel;
+            uint16_t BitOffset;
+            uint8_t BitLength;
+        };
+
+        struct FormatDescriptor
+        {
+            uint8_t ColorModel;
+            uint8_t BlockWidth;
+            uint8_t BlockHeight;
+            uint8_t BytesPerBlock;
+            bool Float;
+            std::vector<FormatSample> Samples;
+        };
+
+        FormatDescriptor Describe(bimg::TextureFormat::Enum format)
+        {
+            switch (format)
+            {
+                case bimg::TextureFormat::R8: return {KHR_DF_MODEL_RGBSDA, 1, 1, 1, false, {{KHR_DF_CHANNEL_RED, 0, 8}}};
+                case bimg::TextureFormat::RGB8: return {KHR_DF_MODEL_RGBSDA, 1, 1, 3, false, {{KHR_DF_CHANNEL_RED, 0, 8}, {KHR_DF_CHANNEL_GREEN, 8, 8}, {KHR_DF_CHANNEL_BLUE, 16, 8}}};
+                case bimg::TextureFormat::RGBA8: return {KHR_DF_MODEL_RGBSDA, 1, 1, 4, false, {{KHR_DF_CHANNEL_RED, 0, 8}, {KHR_DF_CHANNEL_GREEN, 8, 8}, {KHR_DF_CHANNEL_BLUE, 16, 8}, {KHR_DF_CHANNEL_ALPHA, 24, 8}}};
+                case bimg::TextureFormat::BGRA8: return {KHR_DF_MODEL_RGBSDA, 1, 1, 4, false, {{KHR_DF_CHANNEL_BLUE, 0, 8}, {KHR_DF_CHANNEL_GREEN, 8, 8}, {KHR_DF_CHANNEL_RED, 16, 8}, {KHR_DF_CHANNEL_ALPHA, 24, 8}}};
+                case bimg::TextureFormat::RGBA16F: return {KHR_DF_MODEL_RGBSDA, 1, 1, 8, true, {{KHR_DF_CHANNEL_RED, 0, 16}, {KHR_DF_CHANNEL_GREEN, 16, 16}, {KHR_DF_CHANNEL_BLUE, 32, 16}, {KHR_DF_CHANNEL_ALPHA, 48, 16}}};
+                case bimg::TextureFormat::RGBA32F: return {KHR_DF_MODEL_RGBSDA, 1, 1, 16, true, {{KHR_DF_CHANNEL_RED, 0, 32}, {KHR_DF_CHANNEL_GREEN, 32, 32}, {KHR_DF_CHANNEL_BLUE, 64, 32}, {KHR_DF_CHANNEL_ALPHA, 96, 32}}};
+                case bimg::TextureFormat::BC1: return {KHR_DF_MODEL_BC1A, 4, 4, 8, false, {{KHR_DF_CHANNEL_BC1A_ALPHAPRESENT, 0, 64}}};
+                case bimg::TextureFormat::BC2: return {KHR_DF_MODEL_BC2, 4, 4, 16, false, {{KHR_DF_CHANNEL_ALPHA, 0, 64}, {KHR_DF_CHANNEL_COLOR, 64, 64}}};
+                case bimg::TextureFormat::BC3: return {KHR_DF_MODEL_BC3, 4, 4, 16, false, {{KHR_DF_CHANNEL_ALPHA, 0, 64}, {KHR_DF_CHANNEL_COLOR, 64, 64}}};
+                case bimg::TextureFormat::BC4: return {KHR_DF_MODEL_BC4, 4, 4, 8, false, {{KHR_DF_CHANNEL_RED, 0, 64}}};
+                case bimg::TextureFormat::BC5: return {KHR_DF_MODEL_BC5, 4, 4, 16, false, {{KHR_DF_CHANNEL_RED, 0, 64}, {KHR_DF_CHANNEL_GREEN, 64, 64}}};
+                case bimg::TextureFormat::BC6H: return {KHR_DF_MODEL_BC6H, 4, 4, 16, true, {{KHR_DF_CHANNEL_COLOR, 0, 128}}};
+                case bimg::TextureFormat::BC7: return {KHR_DF_MODEL_BC7, 4, 4, 16, false, {{KHR_DF_CHANNEL_COLOR, 0, 128}}};
+                case bimg::TextureFormat::ETC2: return {KHR_DF_MODEL_ETC2, 4, 4, 8, false, {{KHR_DF_CHANNEL_ETC2_COLOR, 0, 64}}};
+                // Punch-through alpha shares its bits with the color.
+                case bimg::TextureFormat::ETC2A1: return {KHR_DF_MODEL_ETC2, 4, 4, 8, false, {{KHR_DF_CHANNEL_ETC2_COLOR, 0, 64}, {KHR_DF_CHANNEL_ALPHA, 0, 64}}};
+                case bimg::TextureFormat::ETC2A: return {KHR_DF_MODEL_ETC2, 4, 4, 16, false, {{KHR_DF_CHANNEL_ALPHA, 0, 64}, {KHR_DF_CHANNEL_ETC2_COLOR, 64, 64}}};
+                case bimg::TextureFormat::ASTC4x4: return {KHR_DF_MODEL_ASTC, 4, 4, 16, false, {{KHR_DF_CHANNEL_COLOR, 0, 128}}};
+                case bimg::TextureFormat::ASTC5x5: return {KHR_DF_MODEL_ASTC, 5, 5, 16, false, {{KHR_DF_CHANNEL_COLOR, 0, 128}}};
+                case bimg::TextureFormat::ASTC6x6: return {KHR_DF_MODEL_ASTC, 6, 6, 16, false, {{KHR_DF_CHANNEL_COLOR, 0, 128}}};
+                case bimg::TextureFormat::ASTC8x5: return {KHR_DF_MODEL_ASTC, 8, 5, 16, false, {{KHR_DF_CHANNEL_COLOR, 0, 128}}};
+                case bimg::TextureFormat::ASTC8x6: return {KHR_DF_MODEL_ASTC, 8, 6, 16, false, {{KHR_DF_CHANNEL_COLOR, 0, 128}}};
+                case bimg::TextureFormat::ASTC10x5: return {KHR_DF_MODEL_ASTC, 10, 5, 16, false, {{KHR_DF_CHANNEL_COLOR, 0, 128}}};
+                default: throw std::runtime_error{"Image cannot be stored as KTX2."};
+            }
+        }
+
+        template<typename T>
+        void Append(std::vector<uint8_t>& data, const T& value)
+        {
+            const auto bytes{reinterpret_cast<const uint8_t*>(&value)};
+            data.insert(data.end(), bytes, bytes + sizeof(T));
+        }
+
+        void Pad(std::vector<uint8_t>& data, size_t alignment)
+        {
+            data.resize((data.size() + alignment - 1) / alignment * alignment);
+        }
+
+        void AppendDfd(std::vector<uint8_t>& data, const FormatDescriptor& descriptor)
+        {
+            const uint16_t blockSize{static_cast<uint16_t>(sizeof(DfdBasicBlock) + descriptor.Samples.size() * sizeof(DfdSample))};
+            Append(data, static_cast<uint32_t>(sizeof(uint32_t) + blockSize));
+
+            // Vendor Khronos (0), descriptor type basic (0).
+            DfdBasicBlock block{};
+            block.VersionNumber = KHR_DF_VERSIONNUMBER_1_3;
+            block.DescriptorBlockSize = blockSize;
+            block.ColorModel = descriptor.ColorModel;
+            block.ColorPrimaries = KHR_DF_PRIMARIES_BT709;
+            block.TransferFunction = KHR_DF_TRANSFER_LINEAR;
+            block.TexelBlockDimension[0] = static_cast<uint8_t>(descriptor.BlockWidth - 1);
+            block.TexelBlockDimension[1] = static_cast<uint8_t>(descriptor.BlockHeight - 1);
+            block.BytesPlane[0] = descriptor.BytesPerBlock;
+            Append(data, block);
+
+            const bool compressed{descriptor.ColorModel != KHR_DF_MODEL_RGBSDA};
+            for (const auto& formatSample : descriptor.Samples)
+            {
+                DfdSample sample{};
+                sample.BitOffset = formatSample.BitOffset;
+                sample.BitLength = static_cast<uint8_t>(formatSample.BitLength - 1);
+                sample.ChannelType = formatSample.Channel;
+                if (descriptor.Float)
+                {
+                    sample.ChannelType |= KHR_DF_SAMPLE_DATATYPE_FLOAT | KHR_DF_SAMPLE_DATATYPE_SIGNED;
+                    sample.SampleLower = FLOAT_MINUS_ONE;
+                    sample.SampleUpper = FLOAT_ONE;
+                }
+                else
+                {
+                    sample.SampleUpper = compressed ? std::numeric_limits<uint32_t>::max() : (1u << formatSample.BitLength) - 1;
+                }
+
+                Append(data, sample);
+            }
+        }
+
+        void AppendKeyValues(std::vector<uint8_t>& data, const KeyValues& keyValues)
+        {
+            for (const auto& [key, value] : keyValues)
+            {
+                Append(data, static_cast<uint32_t>(key.size() + 1 + value.size()));
+                data.insert(data.end(), key.c_str(), key.c_str() + key.size() + 1);
+                data.insert(data.end(), value.begin(), value.end());
+                Pad(data, 4);
+            }
+        }
+
+        KeyValues ParseKeyValues(gsl::span<const uint8_t> data)
+        {
+            KeyValues keyValues{};
+            size_t offset{0};
+            const auto size{static_cast<size_t>(data.size())};
+            while (size - offset >= sizeof(uint32_t))
+            {
+                uint32_t length{};
+                std::memcpy(&length, data.data() + offset, sizeof(uint32_t));
+                offset += sizeof(uint32_t);
+
+                if (length > size - offset)
+                {
+                    throw std::runtime_error{"KTX2 key/value data is malformed."};
+                }
+
+                // Each entry is a NUL-terminated key followed by its value.
+                const auto entry{data.data() + offset};
+                const auto terminator{std::find(entry, entry + length, uint8_t{0})};
+                if (terminator == entry + length)
+                {
+                    throw std::runtime_error{"KTX2 key/value data is malformed."};
+                }
+
+                keyValues.emplace(std::string{reinterpret_cast<const char*>(entry), static_cast<size_t>(terminator - entry)}, std::vector<uint8_t>{terminator + 1, entry + length});
+                offset = std::min(size, (offset + length + 3) / 4 * 4);
+            }
+
+            return keyValues;
+        }
+
+        void ValidateDimensions(uint32_t width, uint32_t height)
+        {
+            if (width > MAX_DIMENSION || height > MAX_DIMENSION)
+            {
+                throw std::runtime_error{"KTX2 textures larger than 65535 pixels are not supported."};
+            }
+        }
+
+#ifdef BASIS_TRANSCODER
+        struct BasisTarget
+        {
+            basist::transcoder_texture_format TranscoderFormat;
+            bimg::TextureFormat::Enum Format;
+        };
+
+        // Candidates in order of preference: the highest quality block format first, then the smaller or more
+        // widely supported ones. RGBA8 always works but costs four times the memory of BC7 or ASTC 4x4.
+        constexpr std::array<BasisTarget, 5> BASIS_TARGETS_ALPHA{{
+            {basist::transcoder_texture_format::cTFBC7_RGBA, bimg::TextureFormat::BC7},
+            {basist::transcoder_texture_format::cTFASTC_4x4_RGBA, bimg::TextureFormat::ASTC4x4},
+            {basist::transcoder_texture_format::cTFBC3_RGBA, bimg::TextureFormat::BC3},
+            {basist::transcoder_texture_format::cTFETC2_RGBA, bimg::TextureFormat::ETC2A},
+            {basist::transcoder_texture_format::cTFRGBA32, bimg::TextureFormat::RGBA8},
+        }};
+
+        constexpr std::array<BasisTarget, 6> BASIS_TARGETS_OPAQUE{{
+            {basist::transcoder_texture_format::cTFBC7_RGBA, bimg::TextureFormat::BC7},
+            {basist::transcoder_texture_format::cTFASTC_4x4_RGBA, bimg::TextureFormat::ASTC4x4},
+            {basist::transcoder_texture_format::cTFBC1_RGB, bimg::TextureFormat::BC1},
+            {basist::transcoder_texture_format::cTFETC1_RGB, bimg::TextureFormat::ETC1},
+            // ETC1 data is valid ETC2 data.
+            {basist::transcoder_texture_format::cTFETC1_RGB, bimg::TextureFormat::ETC2},
+            {basist::transcoder_texture_format::cTFRGBA32, bimg::TextureFormat::RGBA8},
+        }};
+
+        template<size_t Size>
+        BasisTarget SelectBasisTarget(const std::array<BasisTarget, Size>& targets, const std::function<bool(bimg::TextureFormat::Enum)>& isFormatSupported)
+        {
+            for (const auto& target : targets)
+            {
+                if (!isFormatSupported || isFormatSupported(target.Format))
+                {
+                    return target;
+                }
+            }
+
+            return targets.back();
+        }
+
+        bimg::ImageContainer* TranscodeBasis(bx::AllocatorI* allocator, gsl::span<const uint8_t> data, const std::function<bool(bimg::TextureFormat::Enum)>& isFormatSupported)
+        {
+            static std::once_flag initialized{};
+            std::call_once(initialized, []() { basist::basisu_transcoder_init(); });
+
+            basist::ktx2_transcoder transcoder{};
+            if (!transcoder.init(data.data(), static_cast<uint32_t>(data.size())) || !transcoder.start_transcoding())
+            {
+                throw std::runtime_error{"KTX2 Basis Universal data is malformed."};
+            }
+
+            if (transcoder.get_faces() != 1 || transcoder.get_layers() > 1)
+            {
+                throw std::runtime_error{"Only 2D KTX2 textures are supported."};
+            }
+
+            ValidateDimensions(transcoder.get_width(), transcoder.get_height());
+
+            // Without a callback, the first candidate is taken.
+            const BasisTarget target{transcoder.get_has_alpha() ? SelectBasisTarget(BASIS_TARGETS_ALPHA, isFormatSupported) : SelectBasisTarget(BASIS_TARGETS_OPAQUE, isFormatSupported)};
+
+            const uint32_t levelCount{std::max(transcoder.get_levels(), 1u)};
+            bimg::ImageContainer* image{bimg::imageAlloc(allocator, target.Format, static_cast<uint16_t>(transcoder.get_width()), static_cast<uint16_t>(transcoder.get_height()), 1, 1, false, levelCount > 1)};
+            if (levelCount > 1 && image->m_numMips != levelCount)
+            {
+                bimg::imageFree(image);
+                throw std::runtime_error{"KTX2 textures with a partial mip chain are not supported."};
+            }
+
+            // Sized in blocks for block formats and in pixels for RGBA8.
+            const uint32_t bytesPerBlock{basist::basis_get_bytes_per_block_or_pixel(target.TranscoderFormat)};
+            for (uint8_t level = 0; level < levelCount; ++level)
+            {
+                bimg::ImageMip mip{};
+                bimg::imageGetRawData(*image, 0, level, image->m_data, image->m_size, mip);
+
+                if (!transcoder.transcode_image_level(level, 0, 0, const_cast<uint8_t*>(mip.m_data), mip.m_size / bytesPerBlock, target.TranscoderFormat))
+                {
+                    bimg::imageFree(image);
+                    throw std::runtime_error{"KTX2 Basis Universal data is malformed."};
+                }
+            }
+
+            return image;
+        }
+#endif
+    }
+
+    bool IsKtx2(gsl::span<const uint8_t> data)
+    {
+        return static_cast<size_t>(data.size()) >= IDENTIFIER.size() && std::memcmp(data.data(), IDENTIFIER.data(), IDENTIFIER.size()) == 0;
+    }
+
+    bimg::ImageContainer* Parse(bx::AllocatorI* allocator, gsl::span<const uint8_t> data, [[maybe_unused]] const std::function<bool(bimg::TextureFormat::Enum)>& isFormatSupported, KeyValues* keyValues)
+    {
+        const auto size{static_cast<size_t>(data.size())};
+        if (size < sizeof(Header))
+        {
+            throw std::runtime_error{"KTX2 data is truncated."};
+        }
+
+        Header header{};
+        std::memcpy(&header, data.data(), sizeof(Header));
+
+        if (keyValues != nullptr)
+        {
+            if (header.KvdByteOffset > size || size - header.KvdByteOffset < header.KvdByteLength)
+            {
+                throw std::runtime_error{"KTX2 data is truncated."};
+            }
+
+            *keyValues = ParseKeyValues(data.subspan(header.KvdByteOffset, header.KvdByteLength));
+        }
+
+        if (header.VkFormat == VK_FORMAT_UNDEFINED || header.SupercompressionScheme == SUPERCOMPRESSION_BASIS_LZ)
+        {
+#ifdef BASIS_TRANSCODER
+            return TranscodeBasis(allocator, data, isFormatSupported);
+#else
+            throw std::runtime_error{"KTX2 Basis Universal textures need a build with BABYLON_NATIVE_BASIS_TRANSCODER."};
+#endif
+        }
+
+        if (header.SupercompressionScheme != SUPERCOMPRESSION_NONE)
+        {
+            throw std::runtime_error{"Supercompressed KTX2 textures are not supported."};
+        }
+
+        if (header.PixelDepth > 1 || header.LayerCount > 1 || header.FaceCount != 1)
+        {
+            throw std::runtime_error{"Only 2D KTX2 textures are supported."};
+        }
+
+        const auto format{ToTextureFormat(header.VkFormat)};
+        if (format == bimg::TextureFormat::Unknown)
+        {
+            throw std::runtime_error{"Unsupported KTX2 texture format."};
+        }
+
+        ValidateDimensions(header.PixelWidth, header.PixelHeight);
+
+        const uint32_t levelCount{std::max(header.LevelCount, 1u)};
+        if (size < sizeof(Header) + levelCount * sizeof(LevelIndex))
+        {
+            throw std::runtime_error{"KTX2 data is truncated."};
+        }
+
+        bimg::ImageContainer* image{bimg::imageAlloc(allocator, format, static_cast<uint16_t>(header.PixelWidth), static_cast<uint16_t>(std::max(header.PixelHeight, 1u)), 1, 1, false, levelCount > 1)};
+
+        // bimg allocates the full mip chain when mips are requested; files that only carry part of it
+        // are rejected rather than uploaded with undefined levels.
+        if (levelCount > 1 && image->m_numMips != levelCount)
+        {
+            bimg::imageFree(image);
+            throw std::runtime_error{"KTX2 textures with a partial mip chain are not supported."};
+        }
+
+        for (uint8_t level = 0; level < levelCount; ++level)
+        {
+            LevelIndex levelIndex{};
+            std::memcpy(&levelIndex, data.data() + sizeof(Header) + level * sizeof(LevelIndex), sizeof(LevelIndex));
+
+            bimg::ImageMip mip{};
+            bimg::imageGetRawData(*image, 0, level, image->m_data, image->m_size, mip);
+
+            if (levelIndex.ByteLength != mip.m_size || levelIndex.ByteOffset > size || size - levelIndex.ByteOffset < levelIndex.ByteLength)
+            {
+                bimg::imageFree(image);
+                throw std::runtime_error{"KTX2 level data is malformed."};
+            }
+
+            std::memcpy(const_cast<uint8_t*>(mip.m_data), data.data() + levelIndex.ByteOffset, mip.m_size);
+        }
+
+        return image;
+    }
+
+    bool CanWrite(bimg::TextureFormat::Enum format)
+    {
+        return ToVkFormat(format) != VK_FORMAT_UNDEFINED;
+    }
+
+    std::vector<uint8_t> Write(const bimg::ImageContainer& image, const KeyValues& keyValues)
+    {
+        if (!CanWrite(image.m_format) || image.m_depth > 1 || image.m_numLayers > 1 || image.m_cubeMap)
+        {
+            throw std::runtime_error{"Image cannot be stored as KTX2."};
+        }
+
+        const FormatDescriptor descriptor{Describe(image.m_format)};
+
+        Header header{};
+        std::memcpy(header.Identifier, IDENTIFIER.data(), IDENTIFIER.size());
+        header.VkFormat = ToVkFormat(image.m_format);
+        header.TypeSize = TypeSize(image.m_format);
+        header.PixelWidth = image.m_width;
+        header.PixelHeight = image.m_height;
+        header.FaceCount = 1;
+        header.LevelCount = image.m_numMips;
+
+        const size_t levelIndexSize{image.m_numMips * sizeof(LevelIndex)};
+        std::vector<uint8_t> data(sizeof(Header) + levelIndexSize);
+
+        header.DfdByteOffset = static_cast<uint32_t>(data.size());
+        AppendDfd(data, descriptor);
+        header.DfdByteLength = static_cast<uint32_t>(data.size() - header.DfdByteOffset);
+
+        if (!keyValues.empty())
+        {
+            header.KvdByteOffset = static_cast<uint32_t>(data.size());
+            AppendKeyValues(data, keyValues);
+            header.KvdByteLength = static_cast<uint32_t>(data.size() - header.KvdByteOffset);
+        }
+
+        std::memcpy(data.data(), &header, sizeof(Header));
+
+        // Levels are stored from the smallest to the largest, each aligned to its block size and to 4 bytes.
+        const size_t alignment{std::lcm<size_t>(descriptor.BytesPerBlock, 4)};
+        for (uint8_t level = image.m_numMips; level-- > 0;)
+        {
+            bimg::ImageMip mip{};
+            bimg::imageGetRawData(image, 0, level, image.m_data, image.m_size, mip);
+
+            Pad(data, alignment);
+            const LevelIndex levelIndex{data.size(), mip.m_size, mip.m_size};
+            std::memcpy(data.data() + sizeof(Header) + level * sizeof(LevelIndex), &levelIndex, sizeof(LevelIndex));
+            data.insert(data.end(), mip.m_data, mip.m_data + mip.m_size);
+        }
+
+        return data;
+    }
+}
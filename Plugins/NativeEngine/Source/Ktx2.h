@@ -0,0 +1,34 @@
+#pragma once
+
+#include <bimg/bimg.h>
+#include <bx/allocator.h>
+#include <gsl/gsl>
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Babylon::Ktx2
+{
+    // Entries of the key/value data, sorted by key as the format requires.
+    using KeyValues = std::map<std::string, std::vector<uint8_t>>;
+
+    // Returns true if the data starts with the KTX2 file identifier.
+    bool IsKtx2(gsl::span<const uint8_t> data);
+
+    // Parses a 2D KTX2 texture, optionally with a full mip chain. Payloads stored in a format bimg understands
+    // (uncompressed or GPU block-compressed) are copied as they are. Basis Universal payloads (ETC1S/UASTC) are
+    // transcoded to the best block-compressed format for which isFormatSupported returns true, or to RGBA8;
+    // this needs a build with BABYLON_NATIVE_BASIS_TRANSCODER. Throws for cube maps, arrays, 3D textures,
+    // dimensions above 65535 and Zstandard supercompression of anything but Basis Universal payloads.
+    // The key/value data is returned through keyValues when it is not null.
+    bimg::ImageContainer* Parse(bx::AllocatorI* allocator, gsl::span<const uint8_t> data, const std::function<bool(bimg::TextureFormat::Enum)>& isFormatSupported = {}, KeyValues* keyValues = nullptr);
+
+    // Returns true if Write can store images of this format.
+    bool CanWrite(bimg::TextureFormat::Enum format);
+
+    // Serializes a 2D image and its mips with a basic data format descriptor and the given key/value data.
+    // Throws for unsupported images.
+    std::vector<uint8_t> Write(const bimg::ImageContainer& image, const KeyValues& keyValues = {});
+}
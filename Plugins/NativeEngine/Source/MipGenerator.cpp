@@ -0,0 +1,240 @@
+#include "MipGenerator.h"
+
+#include <Babylon/ThreadPool.h>
+
+#include <bx/math.h>
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIP_GENERATOR_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define MIP_GENERATOR_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Babylon::MipGenerator
+{
+    namespace
+    {
+        enum class ComponentType
+        {
+            Unorm8,
+            Half,
+            Float,
+        };
+
+        struct FormatInfo
+        {
+            ComponentType Type{};
+            uint32_t Channels{};
+        };
+
+        bool GetFormatInfo(bimg::TextureFormat::Enum format, FormatInfo& info)
+        {
+            switch (format)
+            {
+                case bimg::TextureFormat::R8:
+                case bimg::TextureFormat::A8: info = {ComponentType::Unorm8, 1}; return true;
+                case bimg::TextureFormat::RG8: info = {ComponentType::Unorm8, 2}; return true;
+                case bimg::TextureFormat::RGB8: info = {ComponentType::Unorm8, 3}; return true;
+                case bimg::TextureFormat::RGBA8:
+                case bimg::TextureFormat::BGRA8: info = {ComponentType::Unorm8, 4}; return true;
+                case bimg::TextureFormat::R16F: info = {ComponentType::Half, 1}; return true;
+                case bimg::TextureFormat::RGBA16F: info = {ComponentType::Half, 4}; return true;
+                case bimg::TextureFormat::R32F: info = {ComponentType::Float, 1}; return true;
+                case bimg::TextureFormat::RGBA32F: info = {ComponentType::Float, 4}; return true;
+                default: return false;
+            }
+        }
+
+        // Levels with fewer output rows than this are generated on the calling thread only.
+        constexpr uint32_t PARALLEL_MIN_ROWS{128};
+        constexpr uint32_t ROWS_PER_CHUNK{32};
+
+        struct Level
+        {
+            const uint8_t* Source{};
+            uint32_t SourceWidth{};
+            uint32_t SourceHeight{};
+            uint8_t* Destination{};
+            uint32_t Width{};
+            uint32_t Height{};
+        };
+
+        void DownsampleRowUnorm8(const uint8_t* row0, const uint8_t* row1, uint8_t* out, uint32_t channels, uint32_t sourceWidth, uint32_t width)
+        {
+            uint32_t x{0};
+
+#if defined(MIP_GENERATOR_SSE2)
+            if (channels == 4 && sourceWidth > 1)
+            {
+                // Two output pixels (four input pixels per row) per iteration.
+                const __m128i zero{_mm_setzero_si128()};
+                const __m128i rounding{_mm_set1_epi16(2)};
+                for (; x + 2 <= width && 2 * x + 4 <= sourceWidth; x += 2)
+                {
+                    const __m128i a{_mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 8 * x))};
+                    const __m128i b{_mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 8 * x))};
+                    const __m128i lo{_mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero))};
+                    const __m128i hi{_mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero))};
+                    const __m128i sumLo{_mm_add_epi16(lo, _mm_srli_si128(lo, 8))};
+                    const __m128i sumHi{_mm_add_epi16(hi, _mm_srli_si128(hi, 8))};
+                    const __m128i sum{_mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(sumLo, sumHi), rounding), 2)};
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 4 * x), _mm_packus_epi16(sum, zero));
+                }
+            }
+#elif defined(MIP_GENERATOR_NEON)
+            if (channels == 4 && sourceWidth > 1)
+            {
+                for (; x + 2 <= width && 2 * x + 4 <= sourceWidth; x += 2)
+                {
+                    const uint8x16_t a{vld1q_u8(row0 + 8 * x)};
+                    const uint8x16_t b{vld1q_u8(row1 + 8 * x)};
+                    const uint16x8_t lo{vaddl_u8(vget_low_u8(a), vget_low_u8(b))};
+                    const uint16x8_t hi{vaddl_u8(vget_high_u8(a), vget_high_u8(b))};
+                    const uint16x8_t sum{vcombine_u16(vadd_u16(vget_low_u16(lo), vget_high_u16(lo)), vadd_u16(vget_low_u16(hi), vget_high_u16(hi)))};
+                    vst1_u8(out + 4 * x, vrshrn_n_u16(sum, 2));
+                }
+            }
+#endif
+
+            for (; x < width; ++x)
+            {
+                const uint32_t x0{std::min(2 * x, sourceWidth - 1) * channels};
+                const uint32_t x1{std::min(2 * x + 1, sourceWidth - 1) * channels};
+                for (uint32_t channel = 0; channel < channels; ++channel)
+                {
+                    const uint32_t sum{uint32_t{row0[x0 + channel]} + row0[x1 + channel] + row1[x0 + channel] + row1[x1 + channel]};
+                    out[x * channels + channel] = static_cast<uint8_t>((sum + 2) >> 2);
+                }
+            }
+        }
+
+        void DownsampleRowFloat(const float* row0, const float* row1, float* out, uint32_t channels, uint32_t sourceWidth, uint32_t width)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                const uint32_t x0{std::min(2 * x, sourceWidth - 1) * channels};
+                const uint32_t x1{std::min(2 * x + 1, sourceWidth - 1) * channels};
+                for (uint32_t channel = 0; channel < channels; ++channel)
+                {
+                    out[x * channels + channel] = 0.25f * (row0[x0 + channel] + row0[x1 + channel] + row1[x0 + channel] + row1[x1 + channel]);
+                }
+            }
+        }
+
+        void DownsampleRowHalf(const uint16_t* row0, const uint16_t* row1, uint16_t* out, uint32_t channels, uint32_t sourceWidth, uint32_t width)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                const uint32_t x0{std::min(2 * x, sourceWidth - 1) * channels};
+                const uint32_t x1{std::min(2 * x + 1, sourceWidth - 1) * channels};
+                for (uint32_t channel = 0; channel < channels; ++channel)
+                {
+                    const float sum{bx::halfToFloat(row0[x0 + channel]) + bx::halfToFloat(row0[x1 + channel]) + bx::halfToFloat(row1[x0 + channel]) + bx::halfToFloat(row1[x1 + channel])};
+                    out[x * channels + channel] = bx::halfFromFloat(0.25f * sum);
+                }
+            }
+        }
+
+        void DownsampleRows(const Level& level, const FormatInfo& info, uint32_t firstRow, uint32_t lastRow)
+        {
+            const uint32_t componentSize{info.Type == ComponentType::Unorm8 ? 1u : info.Type == ComponentType::Half ? 2u : 4u};
+            const size_t sourcePitch{size_t{level.SourceWidth} * info.Channels * componentSize};
+            const size_t pitch{size_t{level.Width} * info.Channels * componentSize};
+
+            for (uint32_t y = firstRow; y < lastRow; ++y)
+            {
+                const uint8_t* row0{level.Source + std::min(2 * y, level.SourceHeight - 1) * sourcePitch};
+                const uint8_t* row1{level.Source + std::min(2 * y + 1, level.SourceHeight - 1) * sourcePitch};
+                uint8_t* out{level.Destination + y * pitch};
+
+                switch (info.Type)
+                {
+                    case ComponentType::Unorm8:
+                        DownsampleRowUnorm8(row0, row1, out, info.Channels, level.SourceWidth, level.Width);
+                        break;
+                    case ComponentType::Half:
+                        DownsampleRowHalf(reinterpret_cast<const uint16_t*>(row0), reinterpret_cast<const uint16_t*>(row1), reinterpret_cast<uint16_t*>(out), info.Channels, level.SourceWidth, level.Width);
+                        break;
+                    case ComponentType::Float:
+                        DownsampleRowFloat(reinterpret_cast<const float*>(row0), reinterpret_cast<const float*>(row1), reinterpret_cast<float*>(out), info.Channels, level.SourceWidth, level.Width);
+                        break;
+                }
+            }
+        }
+
+        void DownsampleLevel(const Level& level, const FormatInfo& info)
+        {
+            if (level.Height < PARALLEL_MIN_ROWS)
+            {
+                DownsampleRows(level, info, 0, level.Height);
+                return;
+            }
+
+            const uint32_t chunkCount{(level.Height + ROWS_PER_CHUNK - 1) / ROWS_PER_CHUNK};
+            ThreadPool::GetDefault().ParallelFor(chunkCount, [&level, &info](size_t chunk) {
+                const uint32_t firstRow{static_cast<uint32_t>(chunk) * ROWS_PER_CHUNK};
+                DownsampleRows(level, info, firstRow, std::min(firstRow + ROWS_PER_CHUNK, level.Height));
+            });
+        }
+    }
+
+    bool IsSupported(bimg::TextureFormat::Enum format)
+    {
+        FormatInfo info{};
+        return GetFormatInfo(format, info);
+    }
+
+    bimg::ImageContainer* Generate(bx::AllocatorI* allocator, const bimg::ImageContainer& input)
+    {
+        if (!IsSupported(input.m_format) || input.m_depth > 1 || input.m_numLayers > 1 || input.m_cubeMap)
+        {
+            return nullptr;
+        }
+
+        bimg::ImageContainer* output{bimg::imageAlloc(allocator, input.m_format, static_cast<uint16_t>(input.m_width), static_cast<uint16_t>(input.m_height), 1, 1, false, true)};
+
+        bimg::ImageMip source{};
+        bimg::imageGetRawData(input, 0, 0, input.m_data, input.m_size, source);
+
+        bimg::ImageMip destination{};
+        bimg::imageGetRawData(*output, 0, 0, output->m_data, output->m_size, destination);
+        std::memcpy(const_cast<uint8_t*>(destination.m_data), source.m_data, source.m_size);
+
+        GenerateInPlace(*output);
+        return output;
+    }
+
+    bool GenerateInPlace(bimg::ImageContainer& image, uint8_t firstLod)
+    {
+        FormatInfo info{};
+        if (!GetFormatInfo(image.m_format, info) || image.m_depth > 1 || image.m_numLayers > 1 || image.m_cubeMap)
+        {
+            return false;
+        }
+
+        bimg::ImageMip destination{};
+        bimg::imageGetRawData(image, 0, static_cast<uint8_t>(firstLod - 1), image.m_data, image.m_size, destination);
+
+        for (uint8_t lod = firstLod; lod < image.m_numMips; ++lod)
+        {
+            const bimg::ImageMip source{destination};
+            bimg::imageGetRawData(image, 0, lod, image.m_data, image.m_size, destination);
+
+            Level level{};
+            level.Source = source.m_data;
+            level.SourceWidth = source.m_width;
+            level.SourceHeight = source.m_height;
+            level.Destination = const_cast<uint8_t*>(destination.m_data);
+            level.Width = destination.m_width;
+            level.Height = destination.m_height;
+            DownsampleLevel(level, info);
+        }
+
+        return true;
+    }
+}
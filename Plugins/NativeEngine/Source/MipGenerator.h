@@ -0,0 +1,20 @@
+#pragma once
+
+#include <bimg/bimg.h>
+#include <bx/allocator.h>
+
+namespace Babylon::MipGenerator
+{
+    // Returns true if Generate can produce mips for images of this format.
+    bool IsSupported(bimg::TextureFormat::Enum format);
+
+    // Builds a full mip chain for a single 2D image with a 2x2 box filter, working directly in the image's
+    // format (8-bit unorm with 1 to 4 channels, R16F/RGBA16F, R32F/RGBA32F). Large levels are split by rows
+    // across the default thread pool; the calling thread participates, so it is safe to call from a pool
+    // worker. Returns nullptr if the image is not supported.
+    bimg::ImageContainer* Generate(bx::AllocatorI* allocator, const bimg::ImageContainer& input);
+
+    // Fills mips firstLod and up of an image that was allocated with a full mip chain, each from the one before
+    // it. Returns false, leaving the image untouched, if the image is not supported.
+    bool GenerateInPlace(bimg::ImageContainer& image, uint8_t firstLod = 1);
+}
@@ -1,5 +1,7 @@
 #include "NativeEngine.h"
+#include "ContentHash.h"
 #include "ShaderCompiler.h"
+#include "TextureDecoder.h"
 #include <arcana/threading/task.h>
 #include <arcana/threading/task_schedulers.h>
 #include <arcana/macros.h>
@@ -18,9 +20,11 @@
 #include <stb/stb_image_resize.h>
 #include <bx/math.h>
 
+#include <array>
 #include <queue>
 #include <regex>
 #include <sstream>
+#include <utility>
 #include <variant>
 
 namespace Babylon
@@ -72,87 +76,297 @@ namespace Babylon
             return static_cast<bgfx::TextureFormat::Enum>(format);
         }
 
-        void FlipY(bimg::ImageContainer* image)
+        bool IsTextureFormatSupported(bimg::TextureFormat::Enum format)
         {
-            uint8_t* bytes = static_cast<uint8_t*>(image->m_data);
-            uint32_t rowCount = image->m_height;
-            uint32_t rowPitch = image->m_size / image->m_height;
+            const auto caps{bgfx::getCaps()->formats[Cast(format)]};
 
-            std::vector<uint8_t> buffer(rowPitch);
+            // bgfx emulates compressed formats by decoding them on the render thread at upload time,
+            // so treat them as unsupported and decode them on a worker thread instead.
+            const auto supported{bimg::isCompressed(format) ? BGFX_CAPS_FORMAT_TEXTURE_2D : BGFX_CAPS_FORMAT_TEXTURE_2D | BGFX_CAPS_FORMAT_TEXTURE_2D_EMULATED};
+            return (caps & supported) != 0;
+        }
+
+        bimg::ImageContainer* DecodeImage(bx::AllocatorI* allocator, gsl::span<const uint8_t> data, bool invertY, bool generateMips,
+            const std::optional<TextureDownscale::Settings>& downscale = {}, std::optional<TextureDownscale::Result>* downscaleResult = nullptr)
+        {
+            return TextureDecoder::Decode(allocator, data, invertY, generateMips, IsTextureFormatSupported, downscale, downscaleResult);
+        }
+
+        // Decoded images can outlive the engine in the texture upload queue, in bgfx or in the array buffers of image
+        // bitmaps, so they are allocated from an allocator that lives as long as the process.
+        bx::AllocatorI* GetImageAllocator()
+        {
+            static bx::DefaultAllocator allocator{};
+            return &allocator;
+        }
+
+        // Owns a decoded image, so that work dropped when a load is cancelled frees it.
+        using ImagePtr = std::shared_ptr<bimg::ImageContainer>;
+
+        ImagePtr MakeImagePtr(bimg::ImageContainer* image)
+        {
+            return {image, [](bimg::ImageContainer* ptr) { bimg::imageFree(ptr); }};
+        }
+
+        // A decoded image, along with what the worker did to it. Only the JavaScript thread applies the latter to
+        // the texture, which may be deleted while the worker runs.
+        struct DecodedImage final
+        {
+            ImagePtr Image{};
+            std::optional<TextureCompression::Result> Compression{};
+            std::optional<TextureDownscale::Result> Downscale{};
+        };
 
-            for (size_t row = 0; row < rowCount / 2; row++)
+        bgfx::TextureHandle CreateTextureFromImage(const ImagePtr& image)
+        {
+            // The pixels are referenced rather than copied; bgfx keeps the image alive until it is done with them.
+            auto releaseFn = [](void* /*ptr*/, void* userData) {
+                delete static_cast<ImagePtr*>(userData);
+            };
+
+            auto mem = bgfx::makeRef(image->m_data, image->m_size, releaseFn, new ImagePtr{image});
+
+            return bgfx::createTexture2D(static_cast<uint16_t>(image->m_width), static_cast<uint16_t>(image->m_height), (image->m_numMips > 1), 1, Cast(image->m_format), BGFX_TEXTURE_NONE | BGFX_SAMPLER_NONE, mem);
+        }
+
+        // A texture created by a queued upload. Destroyed along with the upload unless it was released to a
+        // TextureData or the texture cache, e.g. when the texture it was loaded for was deleted in the meantime.
+        struct UploadedTexture final
+        {
+            UploadedTexture(uint32_t width, uint32_t height, uint32_t bytes)
+                : Width{width}
+                , Height{height}
+                , Bytes{bytes}
+            {
+            }
+
+            ~UploadedTexture()
             {
-                auto frontPtr = bytes + (row * rowPitch);
-                auto backPtr = bytes + ((rowCount - row - 1) * rowPitch);
+                if (bgfx::isValid(Handle))
+                {
+                    bgfx::destroy(Handle);
+                }
+            }
 
-                std::memcpy(buffer.data(), frontPtr, rowPitch);
-                std::memcpy(frontPtr, backPtr, rowPitch);
-                std::memcpy(backPtr, buffer.data(), rowPitch);
+            UploadedTexture(const UploadedTexture&) = delete;
+            UploadedTexture& operator=(const UploadedTexture&) = delete;
+
+            bgfx::TextureHandle Release()
+            {
+                return std::exchange(Handle, bgfx::TextureHandle{bgfx::kInvalidHandle});
             }
+
+            bgfx::TextureHandle Handle{bgfx::kInvalidHandle};
+            const uint32_t Width;
+            const uint32_t Height;
+            const uint32_t Bytes;
+            std::optional<TextureCompression::Result> Compression{};
+            std::optional<TextureDownscale::Result> Downscale{};
+        };
+
+        void AssignUploadedTexture(TextureData* texture, UploadedTexture& uploaded)
+        {
+            texture->SetHandle(uploaded.Release());
+            texture->Width = uploaded.Width;
+            texture->Height = uploaded.Height;
+            texture->Compression = uploaded.Compression;
+            texture->Downscale = uploaded.Downscale;
+        }
+
+        // Wraps the pixels of an image in a Uint8Array without copying them; the image is freed once the
+        // underlying array buffer is collected.
+        Napi::Uint8Array ToUint8Array(Napi::Env env, ImagePtr image)
+        {
+            // The array buffer owns the image until it is collected.
+            const auto size{image->m_size};
+            auto* owner{new ImagePtr{std::move(image)}};
+            auto arrayBuffer{Napi::ArrayBuffer::New(env, (*owner)->m_data, size, [](Napi::Env, void*, ImagePtr* hint) {
+                delete hint;
+            }, owner)};
+            return Napi::Uint8Array::New(env, size, arrayBuffer, 0);
+        }
+
+        Napi::Object CreateImageBitmapObject(Napi::Env env, const ImagePtr& image)
+        {
+            Napi::Object imageBitmap = Napi::Object::New(env);
+            imageBitmap.Set("data", ToUint8Array(env, image));
+            imageBitmap.Set("width", Napi::Number::New(env, image->m_width).As<Napi::Value>());
+            imageBitmap.Set("height", Napi::Number::New(env, image->m_height).As<Napi::Value>());
+            imageBitmap.Set("depth", Napi::Number::New(env, image->m_depth).As<Napi::Value>());
+            imageBitmap.Set("numLayers", Napi::Number::New(env, image->m_numLayers).As<Napi::Value>());
+            imageBitmap.Set("format", Napi::Number::New(env, image->m_format).As<Napi::Value>());
+            return imageBitmap;
+        }
+
+        // Resizes RGBA8 pixels in bands of output rows spread across the thread pool. Each band maps its rows
+        // to the matching slice of the input, and stb still samples outside the slice for the filter
+        // footprint, so the bands line up exactly with a single full-image resize.
+        void ResizeRgba8(const uint8_t* input, uint32_t width, uint32_t height, uint8_t* output, uint32_t outputWidth, uint32_t outputHeight)
+        {
+            constexpr uint32_t ROWS_PER_BAND{64};
+            const uint32_t bandCount{(outputHeight + ROWS_PER_BAND - 1) / ROWS_PER_BAND};
+
+            ThreadPool::GetDefault().ParallelFor(bandCount, [=](size_t band) {
+                const uint32_t firstRow{static_cast<uint32_t>(band) * ROWS_PER_BAND};
+                const uint32_t lastRow{std::min(firstRow + ROWS_PER_BAND, outputHeight)};
+
+                stbir_resize_region(input, static_cast<int>(width), static_cast<int>(height), 0,
+                    output + static_cast<size_t>(firstRow) * outputWidth * 4, static_cast<int>(outputWidth), static_cast<int>(lastRow - firstRow), 0,
+                    STBIR_TYPE_UINT8, 4, STBIR_ALPHA_CHANNEL_NONE, 0,
+                    STBIR_EDGE_CLAMP, STBIR_EDGE_CLAMP, STBIR_FILTER_DEFAULT, STBIR_FILTER_DEFAULT, STBIR_COLORSPACE_LINEAR, nullptr,
+                    0.0f, static_cast<float>(firstRow) / outputHeight, 1.0f, static_cast<float>(lastRow) / outputHeight);
+            });
         }
 
-        void GenerateMips(bx::AllocatorI* allocator, bimg::ImageContainer** image)
+        // Converts to RGBA8 if needed and resizes; used by both the synchronous and asynchronous bitmap resize.
+        bimg::ImageContainer* ResizeImage(bx::AllocatorI* allocator, const uint8_t* data, bimg::TextureFormat::Enum format, uint32_t width, uint32_t height, uint32_t outputWidth, uint32_t outputHeight)
         {
-            bimg::ImageContainer* input = *image;
+            bimg::ImageContainer* rgba{nullptr};
+            const uint8_t* pixels{data};
+            if (format != bimg::TextureFormat::RGBA8)
+            {
+                // Single channel images are luminance; converting from alpha8 replicates the value across RGBA.
+                const auto sourceFormat{format == bimg::TextureFormat::R8 ? bimg::TextureFormat::A8 : format};
+                rgba = bimg::imageAlloc(allocator, bimg::TextureFormat::RGBA8, static_cast<uint16_t>(width), static_cast<uint16_t>(height), 1, 1, false, false);
+                if (!bimg::imageConvert(allocator, rgba->m_data, bimg::TextureFormat::RGBA8, data, sourceFormat, width, height, 1))
+                {
+                    bimg::imageFree(rgba);
+                    throw std::runtime_error{"Unable to convert image to RGBA pixel format for ResizeImageBitmap."};
+                }
+
+                pixels = static_cast<const uint8_t*>(rgba->m_data);
+            }
 
-            bimg::ImageContainer* output = bimg::imageGenerateMips(allocator, *input);
-            if (output == nullptr)
+            bimg::ImageContainer* output{bimg::imageAlloc(allocator, bimg::TextureFormat::RGBA8, static_cast<uint16_t>(outputWidth), static_cast<uint16_t>(outputHeight), 1, 1, false, false)};
+            if (width != outputWidth || height != outputHeight)
             {
-                bimg::TextureFormat::Enum format = input->m_format;
-                bimg::ImageContainer* rgba = bimg::imageConvert(allocator, bimg::TextureFormat::RGBA8, *input, false);
-                bimg::imageFree(input);
-                bimg::ImageContainer* mips = bimg::imageGenerateMips(allocator, *rgba);
-                bimg::imageFree(rgba);
-                output = bimg::imageConvert(allocator, format, *mips);
-                bimg::imageFree(mips);
+                ResizeRgba8(pixels, width, height, static_cast<uint8_t*>(output->m_data), outputWidth, outputHeight);
             }
             else
             {
-                bimg::imageFree(input);
+                std::memcpy(output->m_data, pixels, output->m_size);
             }
 
-            *image = output;
+            if (rgba != nullptr)
+            {
+                bimg::imageFree(rgba);
+            }
+
+            return output;
         }
 
-        void CreateTextureFromImage(TextureData* texture, bimg::ImageContainer* image)
+        TextureCache::Key MakeTextureCacheKey(gsl::span<const uint8_t> data, bool generateMips, bool invertY, const std::optional<TextureCompression::Quality>& compression, const std::optional<TextureDownscale::Settings>& downscale)
         {
-            auto releaseFn = [](void* /*ptr*/, void* userData) {
-                bimg::imageFree(static_cast<bimg::ImageContainer*>(userData));
-            };
+            TextureCache::Key key{};
+            key.Hash = ContentHash(data);
+            key.Size = data.size();
+            key.GenerateMips = generateMips;
+            key.InvertY = invertY;
+            key.Compression = compression;
+            if (downscale)
+            {
+                key.MaxSize = downscale->MaxSize;
+                key.DownscaleQuality = downscale->ResampleQuality;
+            }
+
+            return key;
+        }
 
-            auto mem = bgfx::makeRef(image->m_data, image->m_size, releaseFn, image);
+        // Identifies the upload-ready result of a load in the disk cache. Bump the version whenever the
+        // decode pipeline changes its output for the same input. The renderer and its format caps are part
+        // of the key because they decide which formats compression and Basis Universal transcoding pick.
+        uint64_t DiskCacheKey(const TextureCache::Key& key)
+        {
+            constexpr uint32_t VERSION{2};
+            const std::array<uint64_t, 8> options{
+                VERSION,
+                key.Size,
+                key.GenerateMips,
+                key.InvertY,
+                key.Compression ? static_cast<uint64_t>(key.Compression.value()) + 1 : 0,
+                key.MaxSize,
+                static_cast<uint64_t>(key.DownscaleQuality),
+                static_cast<uint64_t>(bgfx::getRendererType())};
+
+            std::array<uint8_t, bimg::TextureFormat::Count> formats{};
+            for (size_t format = 0; format < formats.size(); ++format)
+            {
+                formats[format] = IsTextureFormatSupported(static_cast<bimg::TextureFormat::Enum>(format));
+            }
 
-            texture->Handle = bgfx::createTexture2D(static_cast<uint16_t>(image->m_width), static_cast<uint16_t>(image->m_height), (image->m_numMips > 1), 1, Cast(image->m_format), BGFX_TEXTURE_NONE | BGFX_SAMPLER_NONE, mem);
-            texture->Width = image->m_width;
-            texture->Height = image->m_height;
+            const uint64_t hash{ContentHash(gsl::make_span(reinterpret_cast<const uint8_t*>(options.data()), sizeof(options)), key.Hash)};
+            return ContentHash(gsl::make_span(formats.data(), formats.size()), hash);
         }
 
-        void CreateCubeTextureFromImages(TextureData* texture, const std::vector<bimg::ImageContainer*>& images, bool hasMips)
+        void AssignCachedTexture(TextureData* texture, std::shared_ptr<const TextureCache::Texture> cached)
         {
-            const bimg::ImageContainer* firstImage = images.front();
-            uint32_t width = firstImage->m_width;
-            uint32_t height = firstImage->m_height;
-            bgfx::TextureFormat::Enum format = Cast(firstImage->m_format);
+            texture->Width = cached->Width;
+            texture->Height = cached->Height;
+            texture->Compression = cached->Compression;
+            texture->Downscale = cached->Downscale;
+            const bgfx::TextureHandle handle{cached->Handle};
+            texture->SetHandle(handle, false, std::move(cached));
+        }
 
+        uint32_t TotalSize(const std::vector<ImagePtr>& images)
+        {
             uint32_t totalSize = 0;
-            for (auto image : images)
+            for (const auto& image : images)
             {
                 totalSize += image->m_size;
             }
 
+            return totalSize;
+        }
+
+        bgfx::TextureHandle CreateCubeTextureFromImages(const std::vector<ImagePtr>& images, bool hasMips)
+        {
+            const bimg::ImageContainer& firstImage = *images.front();
+            uint32_t width = firstImage.m_width;
+            bgfx::TextureFormat::Enum format = Cast(firstImage.m_format);
+
+            uint32_t totalSize = TotalSize(images);
+
             // Combine all the faces into one chunk.
             const bgfx::Memory* mem = bgfx::alloc(totalSize);
             uint8_t* ptr = mem->data;
-            for (bimg::ImageContainer* image : images)
+            for (const auto& image : images)
             {
                 std::memcpy(ptr, image->m_data, image->m_size);
                 ptr += image->m_size;
-                bimg::imageFree(image);
             }
 
-            texture->Handle = bgfx::createTextureCube(static_cast<uint16_t>(width), hasMips, 1, format, BGFX_TEXTURE_NONE | BGFX_SAMPLER_NONE, mem);
-            texture->Width = width;
-            texture->Height = height;
+            return bgfx::createTextureCube(static_cast<uint16_t>(width), hasMips, 1, format, BGFX_TEXTURE_NONE | BGFX_SAMPLER_NONE, mem);
+        }
+
+        // The uploads never touch the TextureData they load, which may be deleted before they run; the handle is
+        // assigned on the JavaScript thread instead. Uploads still queued when the engine is disposed are dropped.
+        arcana::task<std::shared_ptr<UploadedTexture>, std::exception_ptr> UploadTextureAsync(Graphics::Impl& graphicsImpl, std::shared_ptr<arcana::cancellation_source> cancellationSource, DecodedImage decoded)
+        {
+            ImagePtr image{std::move(decoded.Image)};
+            const uint32_t size{image->m_size};
+            auto uploaded{std::make_shared<UploadedTexture>(image->m_width, image->m_height, size)};
+            uploaded->Compression = decoded.Compression;
+            uploaded->Downscale = decoded.Downscale;
+            const auto cancellation{cancellationSource.get()};
+            return graphicsImpl.UploadTextureAsync(size, [uploaded, image{std::move(image)}, cancellationSource{std::move(cancellationSource)}]() {
+                uploaded->Handle = CreateTextureFromImage(image);
+            }, cancellation).then(arcana::inline_scheduler, arcana::cancellation::none(), [uploaded]() {
+                return uploaded;
+            });
+        }
+
+        arcana::task<std::shared_ptr<UploadedTexture>, std::exception_ptr> UploadCubeTextureAsync(Graphics::Impl& graphicsImpl, std::shared_ptr<arcana::cancellation_source> cancellationSource, std::vector<ImagePtr> images, bool hasMips)
+        {
+            const bimg::ImageContainer& firstImage{*images.front()};
+            const uint32_t totalSize{TotalSize(images)};
+            auto uploaded{std::make_shared<UploadedTexture>(firstImage.m_width, firstImage.m_height, totalSize)};
+            const auto cancellation{cancellationSource.get()};
+            return graphicsImpl.UploadTextureAsync(totalSize, [uploaded, images{std::move(images)}, hasMips, cancellationSource{std::move(cancellationSource)}]() {
+                uploaded->Handle = CreateCubeTextureFromImages(images, hasMips);
+            }, cancellation).then(arcana::inline_scheduler, arcana::cancellation::none(), [uploaded]() {
+                return uploaded;
+            });
         }
     }
 
@@ -179,8 +393,12 @@ namespace Babylon
     class IndexBufferData final : private VariantHandleHolder<bgfx::IndexBufferHandle, bgfx::DynamicIndexBufferHandle>
     {
     public:
-        IndexBufferData(const Napi::TypedArray& bytes, uint16_t flags, bool dynamic)
+        IndexBufferData(Graphics::Impl& graphicsImpl, const Napi::TypedArray& bytes, uint16_t flags, bool dynamic)
+            : m_graphicsImpl{graphicsImpl}
+            , m_byteLength{bytes.ByteLength()}
         {
+            m_graphicsImpl.TrackBufferMemory(static_cast<int64_t>(m_byteLength));
+
             const bgfx::Memory* memory = bgfx::copy(bytes.As<Napi::Uint8Array>().Data(), static_cast<uint32_t>(bytes.ByteLength()));
             if (!dynamic)
             {
@@ -194,6 +412,8 @@ namespace Babylon
 
         ~IndexBufferData()
         {
+            m_graphicsImpl.TrackBufferMemory(-static_cast<int64_t>(m_byteLength));
+
             constexpr auto nonDynamic = [](auto handle) {
                 bgfx::destroy(handle);
             };
@@ -226,14 +446,22 @@ namespace Babylon
             };
             DoForHandleTypes(nonDynamic, dynamic);
         }
+
+    private:
+        Graphics::Impl& m_graphicsImpl;
+        const size_t m_byteLength;
     };
 
     class VertexBufferData final : VariantHandleHolder<bgfx::VertexBufferHandle, bgfx::DynamicVertexBufferHandle>
     {
     public:
-        VertexBufferData(const Napi::Uint8Array& bytes, bool dynamic)
+        VertexBufferData(Graphics::Impl& graphicsImpl, const Napi::Uint8Array& bytes, bool dynamic)
             : m_bytes{bytes.Data(), bytes.Data() + bytes.ByteLength()}
+            , m_graphicsImpl{graphicsImpl}
+            , m_byteLength{bytes.ByteLength()}
         {
+            m_graphicsImpl.TrackBufferMemory(static_cast<int64_t>(m_byteLength));
+
             if (!dynamic)
             {
                 m_handle = bgfx::VertexBufferHandle{bgfx::kInvalidHandle};
@@ -246,6 +474,8 @@ namespace Babylon
 
         ~VertexBufferData()
         {
+            m_graphicsImpl.TrackBufferMemory(-static_cast<int64_t>(m_byteLength));
+
             constexpr auto nonDynamic = [](auto handle) {
                 if (handle.idx != bgfx::kInvalidHandle)
                 {
@@ -330,6 +560,8 @@ namespace Babylon
 
     private:
         std::vector<uint8_t> m_bytes{};
+        Graphics::Impl& m_graphicsImpl;
+        const size_t m_byteLength;
     };
 
     void NativeEngine::Initialize(Napi::Env env)
@@ -357,6 +589,7 @@ namespace Babylon
                 InstanceMethod("recordVertexBuffer", &NativeEngine::RecordVertexBuffer),
                 InstanceMethod("updateDynamicVertexBuffer", &NativeEngine::UpdateDynamicVertexBuffer),
                 InstanceMethod("createProgram", &NativeEngine::CreateProgram),
+                InstanceMethod("createProgramAsync", &NativeEngine::CreateProgramAsync),
                 InstanceMethod("getUniforms", &NativeEngine::GetUniforms),
                 InstanceMethod("getAttributes", &NativeEngine::GetAttributes),
                 InstanceMethod("setProgram", &NativeEngine::SetProgram),
@@ -385,9 +618,24 @@ namespace Babylon
                 InstanceMethod("setFloat2", &NativeEngine::SetFloat2),
                 InstanceMethod("setFloat3", &NativeEngine::SetFloat3),
                 InstanceMethod("setFloat4", &NativeEngine::SetFloat4),
+                InstanceMethod("createUniformBlock", &NativeEngine::CreateUniformBlock),
+                InstanceMethod("deleteUniformBlock", &NativeEngine::DeleteUniformBlock),
+                InstanceMethod("getUniformBlockUniforms", &NativeEngine::GetUniformBlockUniforms),
+                InstanceMethod("setUniformBlockMatrix", &NativeEngine::SetUniformBlockMatrix),
+                InstanceMethod("setUniformBlockFloatArray4", &NativeEngine::SetUniformBlockFloatArray4),
+                InstanceMethod("setUniformBlockFloat4", &NativeEngine::SetUniformBlockFloat4),
                 InstanceMethod("createTexture", &NativeEngine::CreateTexture),
                 InstanceMethod("loadTexture", &NativeEngine::LoadTexture),
+                InstanceMethod("loadTextureStreaming", &NativeEngine::LoadTextureStreaming),
                 InstanceMethod("loadRawTexture", &NativeEngine::LoadRawTexture),
+                InstanceMethod("enableTextureCompression", &NativeEngine::EnableTextureCompression),
+                InstanceMethod("disableTextureCompression", &NativeEngine::DisableTextureCompression),
+                InstanceMethod("getTextureCompressionInfo", &NativeEngine::GetTextureCompressionInfo),
+                InstanceMethod("setMaximumTextureSize", &NativeEngine::SetMaximumTextureSize),
+                InstanceMethod("getTextureDownscaleInfo", &NativeEngine::GetTextureDownscaleInfo),
+                InstanceMethod("setTextureCacheEnabled", &NativeEngine::SetTextureCacheEnabled),
+                InstanceMethod("getTextureCacheStatistics", &NativeEngine::GetTextureCacheStatistics),
+                InstanceMethod("getShaderCacheStatistics", &NativeEngine::GetShaderCacheStatistics),
                 InstanceMethod("loadCubeTexture", &NativeEngine::LoadCubeTexture),
                 InstanceMethod("loadCubeTextureWithMips", &NativeEngine::LoadCubeTextureWithMips),
                 InstanceMethod("getTextureWidth", &NativeEngine::GetTextureWidth),
@@ -409,8 +657,13 @@ namespace Babylon
                 InstanceMethod("setViewPort", &NativeEngine::SetViewPort),
                 InstanceMethod("getHardwareScalingLevel", &NativeEngine::GetHardwareScalingLevel),
                 InstanceMethod("setHardwareScalingLevel", &NativeEngine::SetHardwareScalingLevel),
+                InstanceMethod("enableDynamicResolution", &NativeEngine::EnableDynamicResolution),
+                InstanceMethod("disableDynamicResolution", &NativeEngine::DisableDynamicResolution),
+                InstanceMethod("getFrameStatistics", &NativeEngine::GetFrameStatistics),
                 InstanceMethod("createImageBitmap", &NativeEngine::CreateImageBitmap),
                 InstanceMethod("resizeImageBitmap", &NativeEngine::ResizeImageBitmap),
+                InstanceMethod("createImageBitmapAsync", &NativeEngine::CreateImageBitmapAsync),
+                InstanceMethod("resizeImageBitmapAsync", &NativeEngine::ResizeImageBitmapAsync),
                 InstanceMethod("getFrameBufferData", &NativeEngine::GetFrameBufferData),
 
                 InstanceValue("TEXTURE_NEAREST_NEAREST", Napi::Number::From(env, TextureSampling::NEAREST_NEAREST)),
@@ -481,6 +734,8 @@ namespace Babylon
         , m_runtime{runtime}
         , m_graphicsImpl{Graphics::Impl::GetFromJavaScript(info.Env())}
         , m_runtimeScheduler{runtime}
+        , m_decodeScheduler{ThreadPool::GetDefault().GetScheduler(TaskPriority::Normal, m_cancellationSource.get())}
+        , m_shaderCompileScheduler{ThreadPool::GetDefault().GetScheduler(TaskPriority::High, m_cancellationSource.get())}
         , m_boundFrameBuffer{&m_graphicsImpl.DefaultFrameBuffer()}
     {
     }
@@ -498,6 +753,7 @@ namespace Babylon
 
         // This collection contains bgfx data, so it must be cleared before bgfx::shutdown is called.
         m_programDataCollection.clear();
+        m_compiledPrograms.clear();
     }
 
     void NativeEngine::Dispose(const Napi::CallbackInfo& /*info*/)
@@ -544,7 +800,7 @@ namespace Babylon
 
         const uint16_t flags = data.TypedArrayType() == napi_typedarray_type::napi_uint16_array ? 0 : BGFX_BUFFER_INDEX32;
 
-        return Napi::External<IndexBufferData>::New(info.Env(), new IndexBufferData(data, flags, dynamic));
+        return Napi::External<IndexBufferData>::New(info.Env(), new IndexBufferData(m_graphicsImpl, data, flags, dynamic));
     }
 
     void NativeEngine::DeleteIndexBuffer(const Napi::CallbackInfo& info)
@@ -576,7 +832,7 @@ namespace Babylon
         const Napi::Uint8Array data = info[0].As<Napi::Uint8Array>();
         const bool dynamic = info[1].As<Napi::Boolean>().Value();
 
-        return Napi::External<VertexBufferData>::New(info.Env(), new VertexBufferData(data, dynamic));
+        return Napi::External<VertexBufferData>::New(info.Env(), new VertexBufferData(m_graphicsImpl, data, dynamic));
     }
 
     void NativeEngine::DeleteVertexBuffer(const Napi::CallbackInfo& info)
@@ -631,18 +887,95 @@ namespace Babylon
         const std::string vertexSource{info[0].As<Napi::String>().Utf8Value()};
         const std::string fragmentSource{info[1].As<Napi::String>().Utf8Value()};
 
-        std::unique_ptr<ProgramData> programData{std::make_unique<ProgramData>()};
-        ShaderCompiler::BgfxShaderInfo shaderInfo{};
+        const bgfx::RendererType::Enum renderer{bgfx::getRendererType()};
+        const uint64_t cacheKey{ShaderCache::ComputeKey(vertexSource, fragmentSource, renderer)};
+        std::shared_ptr<CompiledProgram> compiled{FindCompiledProgram(cacheKey)};
+        if (!compiled)
+        {
+            m_shaderManifest.Record(vertexSource, fragmentSource);
 
-        try
+            // Waits for a compile of the same sources already running elsewhere, such as a prewarm, instead of
+            // compiling them again.
+            ShaderCache::ShaderInfoPtr cachedShaderInfo{};
+            try
+            {
+                cachedShaderInfo = m_shaderCache.FindOrCompile(cacheKey, vertexSource, fragmentSource, renderer, m_shaderCompiler);
+            }
+            catch (const std::exception& ex)
+            {
+                throw Napi::Error::New(info.Env(), ex.what());
+            }
+
+            compiled = CreateCompiledProgram(cacheKey, *cachedShaderInfo);
+        }
+
+        return CreateProgramObject(info.Env(), std::move(compiled));
+    }
+
+    Napi::Value NativeEngine::CreateProgramAsync(const Napi::CallbackInfo& info)
+    {
+        const Napi::Env env{info.Env()};
+        std::string vertexSource{info[0].As<Napi::String>().Utf8Value()};
+        std::string fragmentSource{info[1].As<Napi::String>().Utf8Value()};
+
+        // The renderer is only queried on the JS thread; it and the key are computed up front for the worker.
+        const bgfx::RendererType::Enum renderer{bgfx::getRendererType()};
+        const uint64_t cacheKey{ShaderCache::ComputeKey(vertexSource, fragmentSource, renderer)};
+        auto deferred{Napi::Promise::Deferred::New(env)};
+
+        if (auto compiled{FindCompiledProgram(cacheKey)})
         {
-            shaderInfo = m_shaderCompiler.Compile(vertexSource, fragmentSource);
+            deferred.Resolve(CreateProgramObject(env, std::move(compiled)));
+            return deferred.Promise();
         }
-        catch (const std::exception& ex)
+
+        m_shaderManifest.Record(vertexSource, fragmentSource);
+
+        arcana::make_task(m_shaderCompileScheduler, *m_cancellationSource, [this, vertexSource{std::move(vertexSource)}, fragmentSource{std::move(fragmentSource)}, cacheKey, renderer, cancellationSource{m_cancellationSource}]() {
+            return m_shaderCache.FindOrCompile(cacheKey, vertexSource, fragmentSource, renderer);
+        })
+            .then(m_runtimeScheduler, arcana::cancellation::none(), [this, deferred, env, cacheKey, cancellationSource{m_cancellationSource}](arcana::expected<ShaderCache::ShaderInfoPtr, std::exception_ptr> result) {
+                // Runs even once the engine is disposed so that the promise is settled; the engine must not be used then.
+                if (cancellationSource->cancelled())
+                {
+                    deferred.Reject(Napi::Error::New(env, "The engine was disposed before createProgramAsync completed.").Value());
+                    return;
+                }
+
+                if (result.has_error())
+                {
+                    deferred.Reject(Napi::Error::New(env, result.error()).Value());
+                    return;
+                }
+
+                // Another call with the same sources may have finished first.
+                std::shared_ptr<CompiledProgram> compiled{FindCompiledProgram(cacheKey)};
+                if (!compiled)
+                {
+                    compiled = CreateCompiledProgram(cacheKey, *result.value());
+                }
+
+                deferred.Resolve(CreateProgramObject(env, std::move(compiled)));
+            });
+
+        return deferred.Promise();
+    }
+
+    std::shared_ptr<CompiledProgram> NativeEngine::FindCompiledProgram(uint64_t cacheKey)
+    {
+        const auto it{m_compiledPrograms.find(cacheKey)};
+        if (it == m_compiledPrograms.end())
         {
-            throw Napi::Error::New(info.Env(), ex.what());
+            return {};
         }
 
+        return it->second.lock();
+    }
+
+    std::shared_ptr<CompiledProgram> NativeEngine::CreateCompiledProgram(uint64_t cacheKey, const ShaderCompiler::BgfxShaderInfo& shaderInfo)
+    {
+        auto compiled{std::make_shared<CompiledProgram>()};
+
         static auto InitUniformInfos{[](bgfx::ShaderHandle shader, const std::unordered_map<std::string, uint8_t>& uniformStages, std::unordered_map<std::string, UniformInfo>& uniformInfos) {
             auto numUniforms = bgfx::getShaderUniforms(shader);
             std::vector<bgfx::UniformHandle> uniforms{numUniforms};
@@ -664,17 +997,97 @@ namespace Babylon
         }};
 
         auto vertexShader = bgfx::createShader(bgfx::copy(shaderInfo.VertexBytes.data(), static_cast<uint32_t>(shaderInfo.VertexBytes.size())));
-        InitUniformInfos(vertexShader, shaderInfo.VertexUniformStages, programData->VertexUniformInfos);
-        programData->VertexAttributeLocations = std::move(shaderInfo.VertexAttributeLocations);
+        InitUniformInfos(vertexShader, shaderInfo.VertexUniformStages, compiled->VertexUniformInfos);
+        compiled->VertexAttributeLocations = shaderInfo.VertexAttributeLocations;
 
         auto fragmentShader = bgfx::createShader(bgfx::copy(shaderInfo.FragmentBytes.data(), static_cast<uint32_t>(shaderInfo.FragmentBytes.size())));
-        InitUniformInfos(fragmentShader, shaderInfo.FragmentUniformStages, programData->FragmentUniformInfos);
+        InitUniformInfos(fragmentShader, shaderInfo.FragmentUniformStages, compiled->FragmentUniformInfos);
+
+        // Packed uniforms are set through the vec4 uniform holding them, in every stage that reads it.
+        for (const auto& [name, packed] : shaderInfo.PackedUniforms)
+        {
+            for (auto* uniformInfos : {&compiled->VertexUniformInfos, &compiled->FragmentUniformInfos})
+            {
+                const auto it = uniformInfos->find(packed.Register);
+                if (it != uniformInfos->end())
+                {
+                    const UniformInfo registerInfo{it->second};
+                    (*uniformInfos)[name] = {registerInfo.Stage, registerInfo.Handle, false, packed.Offset, packed.Size};
+                }
+            }
+        }
+
+        compiled->Handle = bgfx::createProgram(vertexShader, fragmentShader, true);
+
+        for (auto it = m_compiledPrograms.begin(); it != m_compiledPrograms.end();)
+        {
+            it = it->second.expired() ? m_compiledPrograms.erase(it) : std::next(it);
+        }
+
+        m_compiledPrograms[cacheKey] = compiled;
+        return compiled;
+    }
 
-        programData->Handle = bgfx::createProgram(vertexShader, fragmentShader, true);
+    Napi::Value NativeEngine::CreateProgramObject(Napi::Env env, std::shared_ptr<CompiledProgram> compiled)
+    {
+        std::unique_ptr<ProgramData> programData{std::make_unique<ProgramData>(std::move(compiled))};
         auto* rawProgramData = programData.get();
         auto ticket = m_programDataCollection.insert(std::move(programData));
         auto finalizer = [ticket = std::move(ticket)](Napi::Env, ProgramData*) {};
-        return Napi::External<ProgramData>::New(info.Env(), rawProgramData, std::move(finalizer));
+        return Napi::External<ProgramData>::New(env, rawProgramData, std::move(finalizer));
+    }
+
+    void NativeEngine::ResolveSharedUniforms(CompiledProgram& compiled) const
+    {
+        compiled.SharedUniforms.clear();
+
+        // A uniform read by both stages is one bgfx uniform, so it is only resolved for the vertex stage.
+        const auto resolve{[this, &compiled](const std::unordered_map<std::string, UniformInfo>& uniformInfos, const std::unordered_map<std::string, UniformInfo>* resolvedInfos) {
+            for (const auto& [name, uniformInfo] : uniformInfos)
+            {
+                if (resolvedInfos != nullptr && resolvedInfos->find(name) != resolvedInfos->end())
+                {
+                    continue;
+                }
+
+                for (const auto& [blockName, block] : m_uniformBlocks)
+                {
+                    const auto it{block->Uniforms.find(name)};
+                    if (it != block->Uniforms.end())
+                    {
+                        bgfx::UniformInfo info{};
+                        bgfx::getUniformInfo(uniformInfo.Handle, info);
+                        const uint16_t floatsPerElement{info.type == bgfx::UniformType::Mat4 ? uint16_t{16} : uint16_t{4}};
+                        compiled.SharedUniforms.push_back({&uniformInfo, it->second.get(), floatsPerElement, info.num});
+                        break;
+                    }
+                }
+            }
+        }};
+
+        if (!m_uniformBlocks.empty())
+        {
+            resolve(compiled.VertexUniformInfos, nullptr);
+            resolve(compiled.FragmentUniformInfos, &compiled.VertexUniformInfos);
+        }
+
+        compiled.SharedUniformsGeneration = m_uniformBlocksGeneration;
+    }
+
+    Napi::Value NativeEngine::GetShaderCacheStatistics(const Napi::CallbackInfo& info)
+    {
+        const auto statistics{m_shaderCache.GetStatistics()};
+
+        auto result{Napi::Object::New(info.Env())};
+        result.Set("memoryHits", static_cast<double>(statistics.MemoryHits));
+        result.Set("packHits", static_cast<double>(statistics.PackHits));
+        result.Set("diskHits", static_cast<double>(statistics.DiskHits));
+        result.Set("misses", static_cast<double>(statistics.Misses));
+        result.Set("memoryEntries", static_cast<double>(statistics.MemoryEntries));
+        result.Set("packEntries", static_cast<double>(statistics.PackEntries));
+        result.Set("diskEntries", static_cast<double>(statistics.DiskEntries));
+        result.Set("diskBytes", static_cast<double>(statistics.DiskBytes));
+        return std::move(result);
     }
 
     Napi::Value NativeEngine::GetUniforms(const Napi::CallbackInfo& info)
@@ -688,14 +1101,14 @@ namespace Babylon
         {
             const auto name = names[index].As<Napi::String>().Utf8Value();
 
-            auto vertexFound = program->VertexUniformInfos.find(name);
-            auto fragmentFound = program->FragmentUniformInfos.find(name);
+            auto vertexFound = program->Compiled->VertexUniformInfos.find(name);
+            auto fragmentFound = program->Compiled->FragmentUniformInfos.find(name);
 
-            if (vertexFound != program->VertexUniformInfos.end())
+            if (vertexFound != program->Compiled->VertexUniformInfos.end())
             {
                 uniforms[index] = Napi::External<UniformInfo>::New(info.Env(), &vertexFound->second);
             }
-            else if (fragmentFound != program->FragmentUniformInfos.end())
+            else if (fragmentFound != program->Compiled->FragmentUniformInfos.end())
             {
                 uniforms[index] = Napi::External<UniformInfo>::New(info.Env(), &fragmentFound->second);
             }
@@ -713,7 +1126,7 @@ namespace Babylon
         const auto program = info[0].As<Napi::External<ProgramData>>().Data();
         const auto names = info[1].As<Napi::Array>();
 
-        const auto& attributeLocations = program->VertexAttributeLocations;
+        const auto& attributeLocations = program->Compiled->VertexAttributeLocations;
 
         auto length = names.Length();
         auto attributes = Napi::Array::New(info.Env(), length);
@@ -805,7 +1218,7 @@ namespace Babylon
     {
         const auto uniformInfo = info[0].As<Napi::External<UniformInfo>>().Data();
         const auto value = info[1].As<Napi::Number>().FloatValue();
-        m_currentProgram->SetUniform(uniformInfo->Handle, gsl::make_span(&value, 1), uniformInfo->YFlip);
+        m_currentProgram->SetUniform(*uniformInfo, gsl::make_span(&value, 1));
     }
 
     template<int size, typename arrayType>
@@ -828,7 +1241,7 @@ namespace Babylon
             m_scratch.insert(m_scratch.end(), values, values + 4);
         }
 
-        m_currentProgram->SetUniform(uniformInfo->Handle, m_scratch, uniformInfo->YFlip, elementLength / size);
+        m_currentProgram->SetUniform(*uniformInfo, m_scratch, elementLength / size);
     }
 
     template<int size>
@@ -842,7 +1255,7 @@ namespace Babylon
             (size > 3) ? info[4].As<Napi::Number>().FloatValue() : 0.f,
         };
 
-        m_currentProgram->SetUniform(uniformInfo->Handle, values, uniformInfo->YFlip);
+        m_currentProgram->SetUniform(*uniformInfo, values);
     }
 
     template<int size>
@@ -868,11 +1281,11 @@ namespace Babylon
                 }
             }
 
-            m_currentProgram->SetUniform(uniformInfo->Handle, gsl::make_span(matrixValues.data(), 16), uniformInfo->YFlip);
+            m_currentProgram->SetUniform(*uniformInfo, gsl::make_span(matrixValues.data(), 16));
         }
         else
         {
-            m_currentProgram->SetUniform(uniformInfo->Handle, gsl::make_span(matrix.Data(), elementLength), uniformInfo->YFlip);
+            m_currentProgram->SetUniform(*uniformInfo, gsl::make_span(matrix.Data(), elementLength));
         }
     }
 
@@ -924,7 +1337,7 @@ namespace Babylon
         const size_t elementLength = matricesArray.ElementLength();
         assert(elementLength % 16 == 0);
 
-        m_currentProgram->SetUniform(uniformInfo->Handle, gsl::span(matricesArray.Data(), elementLength), uniformInfo->YFlip, elementLength / 16);
+        m_currentProgram->SetUniform(*uniformInfo, gsl::span(matricesArray.Data(), elementLength), elementLength / 16);
     }
 
     void NativeEngine::SetMatrix2x2(const Napi::CallbackInfo& info)
@@ -962,6 +1375,85 @@ namespace Babylon
         SetFloatN<4>(info);
     }
 
+    Napi::Value NativeEngine::CreateUniformBlock(const Napi::CallbackInfo& info)
+    {
+        const auto name = info[0].As<Napi::String>().Utf8Value();
+
+        // Creating a block that already exists returns it, so there is only ever one block of a name.
+        auto& block = m_uniformBlocks[name];
+        if (!block)
+        {
+            block = std::make_shared<UniformBlock>(name);
+            ++m_uniformBlocksGeneration;
+        }
+
+        return Napi::External<UniformBlock>::New(info.Env(), block.get(), [block = block](Napi::Env, UniformBlock*) {});
+    }
+
+    void NativeEngine::DeleteUniformBlock(const Napi::CallbackInfo& info)
+    {
+        const auto block = info[0].As<Napi::External<UniformBlock>>().Data();
+
+        // A block of the same name may have been created since this one was deleted.
+        const auto it{m_uniformBlocks.find(block->Name)};
+        if (it != m_uniformBlocks.end() && it->second.get() == block)
+        {
+            m_uniformBlocks.erase(it);
+            ++m_uniformBlocksGeneration;
+        }
+    }
+
+    Napi::Value NativeEngine::GetUniformBlockUniforms(const Napi::CallbackInfo& info)
+    {
+        const auto block = info[0].As<Napi::External<UniformBlock>>().Data();
+        const auto names = info[1].As<Napi::Array>();
+
+        auto length = names.Length();
+        auto uniforms = Napi::Array::New(info.Env(), length);
+        for (uint32_t index = 0; index < length; ++index)
+        {
+            const auto name = names[index].As<Napi::String>().Utf8Value();
+
+            auto& uniform = block->Uniforms[name];
+            if (!uniform)
+            {
+                uniform = std::make_shared<UniformBlock::Uniform>();
+                ++m_uniformBlocksGeneration;
+            }
+
+            uniforms[index] = Napi::External<UniformBlock::Uniform>::New(info.Env(), uniform.get(), [uniform = uniform](Napi::Env, UniformBlock::Uniform*) {});
+        }
+
+        return std::move(uniforms);
+    }
+
+    void NativeEngine::SetUniformBlockMatrix(const Napi::CallbackInfo& info)
+    {
+        // Matrices are already laid out in vec4 registers.
+        SetUniformBlockFloatArray4(info);
+    }
+
+    void NativeEngine::SetUniformBlockFloatArray4(const Napi::CallbackInfo& info)
+    {
+        const auto uniform = info[0].As<Napi::External<UniformBlock::Uniform>>().Data();
+        const auto array = info[1].As<Napi::Float32Array>();
+
+        uniform->Data.assign(array.Data(), array.Data() + array.ElementLength());
+    }
+
+    void NativeEngine::SetUniformBlockFloat4(const Napi::CallbackInfo& info)
+    {
+        const auto uniform = info[0].As<Napi::External<UniformBlock::Uniform>>().Data();
+        const float values[] = {
+            info[1].As<Napi::Number>().FloatValue(),
+            info[2].As<Napi::Number>().FloatValue(),
+            info[3].As<Napi::Number>().FloatValue(),
+            info[4].As<Napi::Number>().FloatValue(),
+        };
+
+        uniform->Data.assign(std::begin(values), std::end(values));
+    }
+
     Napi::Value NativeEngine::CreateTexture(const Napi::CallbackInfo& info)
     {
         return Napi::External<TextureData>::New(info.Env(), new TextureData());
@@ -978,45 +1470,278 @@ namespace Babylon
 
         const auto dataSpan = gsl::make_span(static_cast<uint8_t*>(data.ArrayBuffer().Data()) + data.ByteOffset(), data.ByteLength());
 
-        arcana::make_task(arcana::threadpool_scheduler, *m_cancellationSource,
-            [this, dataSpan, generateMips, invertY, texture, cancellationSource{m_cancellationSource}]() {
-                bimg::ImageContainer* image = bimg::imageParse(&m_allocator, dataSpan.data(), static_cast<uint32_t>(dataSpan.size()));
-                if (image == nullptr)
+        auto onSuccessRef{std::make_shared<Napi::FunctionReference>(Napi::Persistent(onSuccess))};
+        auto onErrorRef{std::make_shared<Napi::FunctionReference>(Napi::Persistent(onError))};
+
+        const bool cacheEnabled{m_textureCacheEnabled};
+        TextureCache::Key cacheKey{};
+        if (cacheEnabled || m_textureDiskCache)
+        {
+            cacheKey = MakeTextureCacheKey(dataSpan, generateMips, invertY, m_textureCompression, m_textureDownscale);
+        }
+
+        if (cacheEnabled)
+        {
+            const bool hit{m_textureCache.TryAcquire(cacheKey, [this, texture, textureCancellation{texture->Cancellation}, onSuccessRef, onErrorRef](std::shared_ptr<const TextureCache::Texture> cached) {
+                // Deferred so that the callbacks never run from within loadTexture itself.
+                arcana::make_task(m_runtimeScheduler, *m_cancellationSource, [texture, textureCancellation, cached{std::move(cached)}, onSuccessRef, onErrorRef, cancellationSource{m_cancellationSource}]() {
+                    if (textureCancellation->cancelled())
+                    {
+                        return;
+                    }
+
+                    if (!cached)
+                    {
+                        onErrorRef->Call({});
+                        return;
+                    }
+
+                    AssignCachedTexture(texture, std::move(cached));
+                    onSuccessRef->Call({});
+                });
+            })};
+
+            if (hit)
+            {
+                return;
+            }
+        }
+
+        arcana::make_task(m_decodeScheduler, *m_cancellationSource,
+            [dataSpan, generateMips, invertY, textureCompression{m_textureCompression}, textureDownscale{m_textureDownscale}, diskCache{m_textureDiskCache}, diskKey{DiskCacheKey(cacheKey)}, cancellationSource{m_cancellationSource}]() {
+                if (diskCache)
                 {
-                    throw std::runtime_error("Unable to decode image."); // exception will be forwarded to JS
+                    TextureDiskCache::Metadata metadata{};
+                    if (bimg::ImageContainer* cached = diskCache->Load(GetImageAllocator(), diskKey, metadata))
+                    {
+                        return DecodedImage{MakeImagePtr(cached), metadata.Compression, metadata.Downscale};
+                    }
                 }
 
-                if (image->m_format == bimg::TextureFormat::R8)
+                DecodedImage decoded{};
+                bimg::ImageContainer* image = DecodeImage(GetImageAllocator(), dataSpan, invertY, generateMips, textureDownscale, &decoded.Downscale);
+                if (textureCompression)
                 {
-                    // Images with only 1 channel are interpreted as luminance texture with RGB containing the same value as R and alpha as 255
-                    // To emulate this behavior, the format is switched to alpha8 and converted to RGB8 when packing and unpacking take care of
-                    // component swizzling.
-                    image->m_format = bimg::TextureFormat::A8;
-                    bimg::ImageContainer* rgba = bimg::imageConvert(&m_allocator, bimg::TextureFormat::RGB8, *image, false);
-                    bimg::imageFree(image);
-                    image = rgba;
+                    decoded.Compression = TextureCompression::Compress(GetImageAllocator(), &image, textureCompression.value(), IsTextureFormatSupported);
                 }
 
-                if (invertY)
+                decoded.Image = MakeImagePtr(image);
+                if (diskCache)
+                {
+                    diskCache->Store(diskKey, *image, {decoded.Compression, decoded.Downscale});
+                }
+
+                return decoded;
+            })
+            .then(arcana::inline_scheduler, *m_cancellationSource, [this, cancellationSource{m_cancellationSource}](DecodedImage decoded) {
+                return UploadTextureAsync(m_graphicsImpl, cancellationSource, std::move(decoded));
+            })
+            .then(m_runtimeScheduler, *m_cancellationSource, [this, texture, textureCancellation{texture->Cancellation}, cacheEnabled, cacheKey, dataRef{Napi::Persistent(data)}, onSuccessRef{std::move(onSuccessRef)}, onErrorRef{std::move(onErrorRef)}, cancellationSource{m_cancellationSource}](arcana::expected<std::shared_ptr<UploadedTexture>, std::exception_ptr> result) {
+                const bool deleted{textureCancellation->cancelled()};
+                if (result.has_error())
                 {
-                    FlipY(image);
+                    if (cacheEnabled)
+                    {
+                        m_textureCache.Complete(cacheKey, nullptr);
+                    }
+
+                    if (!deleted)
+                    {
+                        onErrorRef->Call({});
+                    }
+
+                    return;
                 }
 
-                if (generateMips)
+                UploadedTexture& uploaded{*result.value()};
+                if (cacheEnabled)
+                {
+                    // Completed even when the texture was deleted, so that other loads of the same content still get it.
+                    auto cached{std::make_shared<TextureCache::Texture>(uploaded.Release(), uploaded.Width, uploaded.Height, uploaded.Bytes)};
+                    cached->Compression = uploaded.Compression;
+                    cached->Downscale = uploaded.Downscale;
+                    if (!deleted)
+                    {
+                        AssignCachedTexture(texture, cached);
+                    }
+
+                    m_textureCache.Complete(cacheKey, std::move(cached));
+                }
+                else if (!deleted)
                 {
-                    GenerateMips(&m_allocator, &image);
+                    AssignUploadedTexture(texture, uploaded);
                 }
 
-                CreateTextureFromImage(texture, image);
+                if (!deleted)
+                {
+                    onSuccessRef->Call({});
+                }
+            });
+    }
+
+    void NativeEngine::LoadTextureStreaming(const Napi::CallbackInfo& info)
+    {
+        const auto texture = info[0].As<Napi::External<TextureData>>().Data();
+        const auto data = info[1].As<Napi::TypedArray>();
+        const auto invertY = info[2].As<Napi::Boolean>().Value();
+        const auto onLevelLoaded = info[3].As<Napi::Function>();
+        const auto onSuccess = info[4].As<Napi::Function>();
+        const auto onError = info[5].As<Napi::Function>();
+
+        const auto dataSpan = gsl::make_span(static_cast<uint8_t*>(data.ArrayBuffer().Data()) + data.ByteOffset(), data.ByteLength());
+
+        // Shared by every level continuation; those all run on the JavaScript thread.
+        auto onLevelLoadedRef{std::make_shared<Napi::FunctionReference>(Napi::Persistent(onLevelLoaded))};
+        auto onSuccessRef{std::make_shared<Napi::FunctionReference>(Napi::Persistent(onSuccess))};
+        auto onErrorRef{std::make_shared<Napi::FunctionReference>(Napi::Persistent(onError))};
+
+        // Streaming always generates the full mip chain, so it shares cache entries with loadTexture calls
+        // that generate mips for the same content.
+        const bool cacheEnabled{m_textureCacheEnabled};
+        TextureCache::Key cacheKey{};
+        if (cacheEnabled || m_textureDiskCache)
+        {
+            cacheKey = MakeTextureCacheKey(dataSpan, true, invertY, m_textureCompression, m_textureDownscale);
+        }
+
+        if (cacheEnabled)
+        {
+            const bool hit{m_textureCache.TryAcquire(cacheKey, [this, texture, textureCancellation{texture->Cancellation}, onLevelLoadedRef, onSuccessRef, onErrorRef](std::shared_ptr<const TextureCache::Texture> cached) {
+                // Deferred so that the callbacks never run from within loadTextureStreaming itself.
+                arcana::make_task(m_runtimeScheduler, *m_cancellationSource, [texture, textureCancellation, cached{std::move(cached)}, onLevelLoadedRef, onSuccessRef, onErrorRef, cancellationSource{m_cancellationSource}]() {
+                    if (textureCancellation->cancelled())
+                    {
+                        return;
+                    }
+
+                    if (!cached)
+                    {
+                        onErrorRef->Call({});
+                        return;
+                    }
+
+                    // A cached texture is already complete, so the full resolution level is the only one reported.
+                    AssignCachedTexture(texture, std::move(cached));
+                    onLevelLoadedRef->Call({Napi::Value::From(onLevelLoadedRef->Env(), 0)});
+                    onSuccessRef->Call({});
+                });
+            })};
+
+            if (hit)
+            {
+                return;
+            }
+        }
+
+        arcana::make_task(m_decodeScheduler, *m_cancellationSource,
+            [dataSpan, invertY, textureCompression{m_textureCompression}, textureDownscale{m_textureDownscale}, diskCache{m_textureDiskCache}, diskKey{DiskCacheKey(cacheKey)}, cancellationSource{m_cancellationSource}]() {
+                if (diskCache)
+                {
+                    TextureDiskCache::Metadata metadata{};
+                    if (bimg::ImageContainer* cached = diskCache->Load(GetImageAllocator(), diskKey, metadata))
+                    {
+                        return DecodedImage{MakeImagePtr(cached), metadata.Compression, metadata.Downscale};
+                    }
+                }
+
+                DecodedImage decoded{};
+                bimg::ImageContainer* image = DecodeImage(GetImageAllocator(), dataSpan, invertY, true, textureDownscale, &decoded.Downscale);
+                if (textureCompression)
+                {
+                    decoded.Compression = TextureCompression::Compress(GetImageAllocator(), &image, textureCompression.value(), IsTextureFormatSupported);
+                }
+
+                decoded.Image = MakeImagePtr(image);
+                if (diskCache)
+                {
+                    diskCache->Store(diskKey, *image, {decoded.Compression, decoded.Downscale});
+                }
+
+                return decoded;
+            })
+            .then(m_runtimeScheduler, *m_cancellationSource, [this, texture, textureCancellation{texture->Cancellation}, cacheEnabled, onLevelLoadedRef{std::move(onLevelLoadedRef)}, cancellationSource{m_cancellationSource}](DecodedImage decoded) -> arcana::task<std::shared_ptr<const TextureCache::Texture>, std::exception_ptr> {
+                // Carried on when the texture was deleted if the load is cached, so that other loads of the
+                // same content still get it.
+                const bool deleted{textureCancellation->cancelled()};
+                if (deleted && !cacheEnabled)
+                {
+                    return arcana::task_from_result<std::exception_ptr>(std::shared_ptr<const TextureCache::Texture>{});
+                }
+
+                ImagePtr image{std::move(decoded.Image)};
+
+                // Create the texture with its full mip chain but no content, then fill the levels in smallest
+                // first so that a low resolution version is available before the large levels have gone through
+                // the upload budget. Every level has been decoded by now; only their uploads are staged. Levels
+                // that have not been reported through onLevelLoaded yet have undefined content.
+                const bgfx::TextureHandle handle{bgfx::createTexture2D(static_cast<uint16_t>(image->m_width), static_cast<uint16_t>(image->m_height), (image->m_numMips > 1), 1, Cast(image->m_format), BGFX_TEXTURE_NONE | BGFX_SAMPLER_NONE)};
+
+                // When cached, the handle belongs to the cache entry, which the level uploads hold on to until
+                // they are done. Otherwise it belongs to the texture, and the uploads are dropped once it is deleted.
+                std::shared_ptr<TextureCache::Texture> cached{};
+                if (cacheEnabled)
+                {
+                    cached = std::make_shared<TextureCache::Texture>(handle, image->m_width, image->m_height, image->m_size);
+                    cached->Compression = decoded.Compression;
+                    cached->Downscale = decoded.Downscale;
+                    if (!deleted)
+                    {
+                        AssignCachedTexture(texture, cached);
+                    }
+                }
+                else
+                {
+                    texture->SetHandle(handle);
+                    texture->Width = image->m_width;
+                    texture->Height = image->m_height;
+                    texture->Compression = decoded.Compression;
+                    texture->Downscale = decoded.Downscale;
+                }
+
+                const arcana::cancellation* uploadCancellation{cacheEnabled ? nullptr : textureCancellation.get()};
+
+                // Each upload holds on to the image, which is freed once the last level has been handed to bgfx.
+                std::vector<arcana::task<void, std::exception_ptr>> levelTasks{};
+                levelTasks.reserve(image->m_numMips);
+                for (uint8_t level = image->m_numMips; level-- > 0;)
+                {
+                    bimg::ImageMip mip{};
+                    bimg::imageGetRawData(*image, 0, level, image->m_data, image->m_size, mip);
+
+                    levelTasks.push_back(m_graphicsImpl.UploadTextureAsync(mip.m_size, [handle, level, mip, image, cached]() {
+                            bgfx::updateTexture2D(handle, 0, level, 0, 0, static_cast<uint16_t>(mip.m_width), static_cast<uint16_t>(mip.m_height), bgfx::copy(mip.m_data, mip.m_size));
+                        }, uploadCancellation)
+                        .then(m_runtimeScheduler, *m_cancellationSource, [onLevelLoadedRef, level, textureCancellation, cancellationSource{m_cancellationSource}]() {
+                            if (!textureCancellation->cancelled())
+                            {
+                                onLevelLoadedRef->Call({Napi::Value::From(onLevelLoadedRef->Env(), level)});
+                            }
+                        }));
+                }
+
+                return arcana::when_all(gsl::make_span(levelTasks)).then(arcana::inline_scheduler, arcana::cancellation::none(), [cached{std::move(cached)}]() -> std::shared_ptr<const TextureCache::Texture> {
+                    return cached;
+                });
             })
-            .then(m_runtimeScheduler, *m_cancellationSource, [dataRef{Napi::Persistent(data)}, onSuccessRef{Napi::Persistent(onSuccess)}, onErrorRef{Napi::Persistent(onError)}, cancellationSource{m_cancellationSource}](arcana::expected<void, std::exception_ptr> result) {
+            .then(m_runtimeScheduler, *m_cancellationSource, [this, textureCancellation{texture->Cancellation}, cacheEnabled, cacheKey, dataRef{Napi::Persistent(data)}, onSuccessRef{std::move(onSuccessRef)}, onErrorRef{std::move(onErrorRef)}, cancellationSource{m_cancellationSource}](arcana::expected<std::shared_ptr<const TextureCache::Texture>, std::exception_ptr> result) {
+                // Published only once every level is resident, so that loads waiting on it get a complete texture.
+                if (cacheEnabled)
+                {
+                    m_textureCache.Complete(cacheKey, result.has_error() ? nullptr : result.value());
+                }
+
+                if (textureCancellation->cancelled())
+                {
+                    return;
+                }
+
                 if (result.has_error())
                 {
-                    onErrorRef.Call({});
+                    onErrorRef->Call({});
                 }
                 else
                 {
-                    onSuccessRef.Call({});
+                    onSuccessRef->Call({});
                 }
             });
     }
@@ -1033,19 +1758,21 @@ namespace Babylon
 
         // TODO: probably should assert data byte length is equal to allocated size
         const auto bytes = static_cast<uint8_t*>(data.ArrayBuffer().Data()) + data.ByteOffset();
-        bimg::ImageContainer* image = bimg::imageAlloc(&m_allocator, format, static_cast<uint16_t>(width), static_cast<uint16_t>(height), 1, 1, false, false, bytes);
+        bimg::ImageContainer* image = bimg::imageAlloc(GetImageAllocator(), format, static_cast<uint16_t>(width), static_cast<uint16_t>(height), 1, 1, false, false, bytes);
 
         if (invertY)
         {
-            FlipY(image);
+            TextureDecoder::FlipY(image);
         }
 
         if (generateMips)
         {
-            GenerateMips(&m_allocator, &image);
+            TextureDecoder::GenerateMips(GetImageAllocator(), &image);
         }
 
-        CreateTextureFromImage(texture, image);
+        texture->SetHandle(CreateTextureFromImage(MakeImagePtr(image)));
+        texture->Width = width;
+        texture->Height = height;
     }
 
     void NativeEngine::LoadCubeTexture(const Napi::CallbackInfo& info)
@@ -1057,37 +1784,35 @@ namespace Babylon
         const auto onError = info[4].As<Napi::Function>();
 
         std::array<Napi::Reference<Napi::TypedArray>, 6> dataRefs;
-        std::array<arcana::task<bimg::ImageContainer*, std::exception_ptr>, 6> tasks;
+        std::array<arcana::task<ImagePtr, std::exception_ptr>, 6> tasks;
         for (uint32_t face = 0; face < data.Length(); face++)
         {
             const auto typedArray{data[face].As<Napi::TypedArray>()};
             const auto dataSpan{gsl::make_span(static_cast<uint8_t*>(typedArray.ArrayBuffer().Data()) + typedArray.ByteOffset(), typedArray.ByteLength())};
             dataRefs[face] = Napi::Persistent(typedArray);
-            tasks[face] = arcana::make_task(arcana::threadpool_scheduler, *m_cancellationSource, [this, dataSpan, generateMips]() {
-                bimg::ImageContainer* image = bimg::imageParse(&m_allocator, dataSpan.data(), static_cast<uint32_t>(dataSpan.size()));
-                // if texture is R8, it needs to be converted as luminance (r=g=b=luminance and alpha = 1)
-                // see what's done in loadTexture
-                // keeping an assert here until we find some assets to test.
-                assert(image->m_format != bimg::TextureFormat::R8);
-                if (generateMips)
-                {
-                    GenerateMips(&m_allocator, &image);
-                }
-                return image;
+            // Every face has the same size, so each one is shrunk to the same dimensions.
+            tasks[face] = arcana::make_task(m_decodeScheduler, *m_cancellationSource, [dataSpan, generateMips, textureDownscale{m_textureDownscale}, cancellationSource{m_cancellationSource}]() {
+                return MakeImagePtr(DecodeImage(GetImageAllocator(), dataSpan, false, generateMips, textureDownscale));
             });
         }
 
         arcana::when_all(gsl::make_span(tasks))
-            .then(arcana::inline_scheduler, *m_cancellationSource, [texture, generateMips, cancellationSource{m_cancellationSource}](std::vector<bimg::ImageContainer*> images) {
-                CreateCubeTextureFromImages(texture, images, generateMips);
+            .then(arcana::inline_scheduler, *m_cancellationSource, [this, generateMips, cancellationSource{m_cancellationSource}](std::vector<ImagePtr> images) {
+                return UploadCubeTextureAsync(m_graphicsImpl, cancellationSource, std::move(images), generateMips);
             })
-            .then(m_runtimeScheduler, *m_cancellationSource, [dataRefs{std::move(dataRefs)}, onSuccessRef{Napi::Persistent(onSuccess)}, onErrorRef{Napi::Persistent(onError)}, cancellationSource{m_cancellationSource}](arcana::expected<void, std::exception_ptr> result) {
+            .then(m_runtimeScheduler, *m_cancellationSource, [texture, textureCancellation{texture->Cancellation}, dataRefs{std::move(dataRefs)}, onSuccessRef{Napi::Persistent(onSuccess)}, onErrorRef{Napi::Persistent(onError)}, cancellationSource{m_cancellationSource}](arcana::expected<std::shared_ptr<UploadedTexture>, std::exception_ptr> result) {
+                if (textureCancellation->cancelled())
+                {
+                    return;
+                }
+
                 if (result.has_error())
                 {
                     onErrorRef.Call({});
                 }
                 else
                 {
+                    AssignUploadedTexture(texture, *result.value());
                     onSuccessRef.Call({});
                 }
             });
@@ -1102,7 +1827,7 @@ namespace Babylon
 
         const auto numMips{static_cast<size_t>(data.Length())};
         std::vector<Napi::Reference<Napi::TypedArray>> dataRefs(6 * numMips);
-        std::vector<arcana::task<bimg::ImageContainer*, std::exception_ptr>> tasks(6 * numMips);
+        std::vector<arcana::task<ImagePtr, std::exception_ptr>> tasks(6 * numMips);
         for (uint32_t mip = 0; mip < numMips; mip++)
         {
             const auto faceData = data[mip].As<Napi::Array>();
@@ -1111,31 +1836,137 @@ namespace Babylon
                 const auto typedArray = faceData[face].As<Napi::TypedArray>();
                 const auto dataSpan = gsl::make_span(static_cast<uint8_t*>(typedArray.ArrayBuffer().Data()) + typedArray.ByteOffset(), typedArray.ByteLength());
                 dataRefs[(face * numMips) + mip] = Napi::Persistent(typedArray);
-                tasks[(face * numMips) + mip] = arcana::make_task(arcana::threadpool_scheduler, *m_cancellationSource, [this, dataSpan, cancellationSource{m_cancellationSource}]() {
-                    bimg::ImageContainer* image = bimg::imageParse(&m_allocator, dataSpan.data(), static_cast<uint32_t>(dataSpan.size()));
-                    assert(image->m_format != bimg::TextureFormat::R8);
-                    FlipY(image);
-                    return image;
+                tasks[(face * numMips) + mip] = arcana::make_task(m_decodeScheduler, *m_cancellationSource, [dataSpan, cancellationSource{m_cancellationSource}]() {
+                    return MakeImagePtr(DecodeImage(GetImageAllocator(), dataSpan, true, false));
                 });
             }
         }
 
         arcana::when_all(gsl::make_span(tasks))
-            .then(arcana::inline_scheduler, *m_cancellationSource, [texture, cancellationSource{m_cancellationSource}](std::vector<bimg::ImageContainer*> images) {
-                CreateCubeTextureFromImages(texture, images, true);
+            .then(arcana::inline_scheduler, *m_cancellationSource, [this, cancellationSource{m_cancellationSource}](std::vector<ImagePtr> images) {
+                return UploadCubeTextureAsync(m_graphicsImpl, cancellationSource, std::move(images), true);
             })
-            .then(m_runtimeScheduler, *m_cancellationSource, [dataRefs{std::move(dataRefs)}, onSuccessRef{Napi::Persistent(onSuccess)}, onErrorRef{Napi::Persistent(onError)}, cancellationSource{m_cancellationSource}](arcana::expected<void, std::exception_ptr> result) {
+            .then(m_runtimeScheduler, *m_cancellationSource, [texture, textureCancellation{texture->Cancellation}, dataRefs{std::move(dataRefs)}, onSuccessRef{Napi::Persistent(onSuccess)}, onErrorRef{Napi::Persistent(onError)}, cancellationSource{m_cancellationSource}](arcana::expected<std::shared_ptr<UploadedTexture>, std::exception_ptr> result) {
+                if (textureCancellation->cancelled())
+                {
+                    return;
+                }
+
                 if (result.has_error())
                 {
                     onErrorRef.Call({});
                 }
                 else
                 {
+                    AssignUploadedTexture(texture, *result.value());
                     onSuccessRef.Call({});
                 }
             });
     }
 
+    void NativeEngine::EnableTextureCompression(const Napi::CallbackInfo& info)
+    {
+        // 0: fastest, 1: default, 2: highest (also allows BC7).
+        const auto quality = info.Length() > 0 ? info[0].As<Napi::Number>().Uint32Value() : 1;
+        if (quality > static_cast<uint32_t>(TextureCompression::Quality::Highest))
+        {
+            throw Napi::Error::New(info.Env(), "Invalid texture compression quality.");
+        }
+
+        m_textureCompression = static_cast<TextureCompression::Quality>(quality);
+    }
+
+    void NativeEngine::DisableTextureCompression(const Napi::CallbackInfo& /*info*/)
+    {
+        m_textureCompression.reset();
+    }
+
+    Napi::Value NativeEngine::GetTextureCompressionInfo(const Napi::CallbackInfo& info)
+    {
+        const auto texture = info[0].As<Napi::External<TextureData>>().Data();
+        if (!texture->Compression)
+        {
+            return info.Env().Null();
+        }
+
+        const auto& compression{texture->Compression.value()};
+        auto result{Napi::Object::New(info.Env())};
+        result.Set("format", static_cast<uint32_t>(compression.Format));
+        result.Set("uncompressedBytes", compression.UncompressedBytes);
+        result.Set("compressedBytes", compression.CompressedBytes);
+        result.Set("ratio", static_cast<double>(compression.UncompressedBytes) / compression.CompressedBytes);
+        result.Set("timeMs", compression.TimeMs);
+        return std::move(result);
+    }
+
+    void NativeEngine::SetMaximumTextureSize(const Napi::CallbackInfo& info)
+    {
+        // A size of 0 removes the limit. Quality - 0: fastest (box), 1: default (triangle), 2: highest (Mitchell).
+        const auto maxSize = info[0].As<Napi::Number>().Uint32Value();
+        const auto quality = info.Length() > 1 ? info[1].As<Napi::Number>().Uint32Value() : 1;
+        if (quality > static_cast<uint32_t>(TextureDownscale::Quality::Highest))
+        {
+            throw Napi::Error::New(info.Env(), "Invalid texture downscale quality.");
+        }
+
+        if (maxSize == 0)
+        {
+            m_textureDownscale.reset();
+        }
+        else
+        {
+            m_textureDownscale = TextureDownscale::Settings{maxSize, static_cast<TextureDownscale::Quality>(quality)};
+        }
+    }
+
+    Napi::Value NativeEngine::GetTextureDownscaleInfo(const Napi::CallbackInfo& info)
+    {
+        const auto texture = info[0].As<Napi::External<TextureData>>().Data();
+        if (!texture->Downscale)
+        {
+            return info.Env().Null();
+        }
+
+        const auto& downscale{texture->Downscale.value()};
+        auto result{Napi::Object::New(info.Env())};
+        result.Set("originalWidth", downscale.OriginalWidth);
+        result.Set("originalHeight", downscale.OriginalHeight);
+        result.Set("originalBytes", downscale.OriginalBytes);
+        result.Set("bytes", downscale.Bytes);
+        result.Set("timeMs", downscale.TimeMs);
+        return std::move(result);
+    }
+
+    void NativeEngine::SetTextureCacheEnabled(const Napi::CallbackInfo& info)
+    {
+        // Textures already shared stay shared; this only affects loads started afterwards.
+        m_textureCacheEnabled = info[0].As<Napi::Boolean>().Value();
+    }
+
+    Napi::Value NativeEngine::GetTextureCacheStatistics(const Napi::CallbackInfo& info)
+    {
+        const auto statistics{m_textureCache.GetStatistics()};
+        const auto lookups{statistics.Hits + statistics.Misses};
+
+        auto result{Napi::Object::New(info.Env())};
+        result.Set("hits", static_cast<double>(statistics.Hits));
+        result.Set("misses", static_cast<double>(statistics.Misses));
+        result.Set("hitRate", lookups == 0 ? 0.0 : static_cast<double>(statistics.Hits) / lookups);
+        result.Set("entries", static_cast<double>(statistics.Entries));
+        result.Set("bytesSaved", static_cast<double>(statistics.BytesSaved));
+
+        if (m_textureDiskCache)
+        {
+            const auto diskStatistics{m_textureDiskCache->GetStatistics()};
+            result.Set("diskHits", static_cast<double>(diskStatistics.Hits));
+            result.Set("diskMisses", static_cast<double>(diskStatistics.Misses));
+            result.Set("diskEntries", static_cast<double>(diskStatistics.Entries));
+            result.Set("diskBytes", static_cast<double>(diskStatistics.Bytes));
+        }
+
+        return std::move(result);
+    }
+
     Napi::Value NativeEngine::GetTextureWidth(const Napi::CallbackInfo& info)
     {
         const auto texture = info[0].As<Napi::External<TextureData>>().Data();
@@ -1249,8 +2080,8 @@ namespace Babylon
             frameBufferHandle = bgfx::createFrameBuffer(width, height, format, BGFX_TEXTURE_RT);
         }
 
-        texture->Handle = bgfx::getTexture(frameBufferHandle);
-        texture->OwnsHandle = false;
+        // The frame buffer owns the texture.
+        texture->SetHandle(bgfx::getTexture(frameBufferHandle), false);
 
         auto& frameBuffer{m_graphicsImpl.AddFrameBuffer(frameBufferHandle, width, height, false)};
         return Napi::External<FrameBuffer>::New(info.Env(), &frameBuffer);
@@ -1403,6 +2234,58 @@ namespace Babylon
         m_graphicsImpl.SetHardwareScalingLevel(level);
     }
 
+    void NativeEngine::EnableDynamicResolution(const Napi::CallbackInfo& info)
+    {
+        const auto targetFrameTimeMs = info[0].As<Napi::Number>().FloatValue();
+        const auto minLevel = info[1].IsUndefined() ? 1.0f : info[1].As<Napi::Number>().FloatValue();
+        const auto maxLevel = info[2].IsUndefined() ? 2.0f : info[2].As<Napi::Number>().FloatValue();
+
+        try
+        {
+            m_graphicsImpl.EnableDynamicResolution(targetFrameTimeMs, minLevel, maxLevel);
+        }
+        catch (const std::exception& ex)
+        {
+            throw Napi::Error::New(info.Env(), ex.what());
+        }
+    }
+
+    void NativeEngine::DisableDynamicResolution(const Napi::CallbackInfo& /*info*/)
+    {
+        m_graphicsImpl.DisableDynamicResolution();
+    }
+
+    Napi::Value NativeEngine::GetFrameStatistics(const Napi::CallbackInfo& info)
+    {
+        // An existing object can be passed in and is filled in place, so polling every frame does not allocate.
+        auto result{info.Length() > 0 && info[0].IsObject() ? info[0].As<Napi::Object>() : Napi::Object::New(info.Env())};
+
+        const auto frameStatistics{m_graphicsImpl.GetFrameStatistics()};
+        result.Set("drawCalls", frameStatistics.DrawCalls);
+        result.Set("computeCalls", frameStatistics.ComputeCalls);
+        result.Set("blitCalls", frameStatistics.BlitCalls);
+        result.Set("cpuSubmitTimeMs", frameStatistics.CpuSubmitTimeMs);
+        result.Set("gpuTimeMs", frameStatistics.GpuTimeMs);
+        result.Set("waitForRenderMs", frameStatistics.WaitForRenderMs);
+        result.Set("waitForSubmitMs", frameStatistics.WaitForSubmitMs);
+        result.Set("transientVertexBufferBytes", frameStatistics.TransientVertexBufferBytes);
+        result.Set("transientIndexBufferBytes", frameStatistics.TransientIndexBufferBytes);
+        result.Set("textures", frameStatistics.Textures);
+        result.Set("vertexBuffers", frameStatistics.VertexBuffers);
+        result.Set("indexBuffers", frameStatistics.IndexBuffers);
+        result.Set("programs", frameStatistics.Programs);
+        result.Set("shaders", frameStatistics.Shaders);
+        result.Set("frameBuffers", frameStatistics.FrameBuffers);
+        result.Set("vertexLayouts", frameStatistics.VertexLayouts);
+        result.Set("textureMemoryBytes", static_cast<double>(frameStatistics.TextureMemoryBytes));
+        result.Set("renderTargetMemoryBytes", static_cast<double>(frameStatistics.RenderTargetMemoryBytes));
+        result.Set("bufferMemoryBytes", static_cast<double>(frameStatistics.BufferMemoryBytes));
+        result.Set("pendingTextureUploads", static_cast<double>(frameStatistics.PendingTextureUploads));
+        result.Set("pendingTextureUploadBytes", static_cast<double>(frameStatistics.PendingTextureUploadBytes));
+
+        return std::move(result);
+    }
+
     Napi::Value NativeEngine::CreateImageBitmap(const Napi::CallbackInfo& info)
     {
         const Napi::Env env{info.Env()};
@@ -1417,25 +2300,13 @@ namespace Babylon
             throw Napi::Error::New(env, "CreateImageBitmap array buffer is empty.");
         }
 
-        bimg::ImageContainer* image = bimg::imageParse(&m_allocator, data.Data(), static_cast<uint32_t>(data.ByteLength()));
+        bimg::ImageContainer* image = bimg::imageParse(GetImageAllocator(), data.Data(), static_cast<uint32_t>(data.ByteLength()));
         if (image == nullptr)
         {
             throw Napi::Error::New(env, "Unable to decode image in createImageBitmap function.");
         }
 
-        Napi::Object imageBitmap = Napi::Object::New(env);
-        auto buffer = Napi::Uint8Array::New(env, image->m_size);
-        memcpy(buffer.Data(), image->m_data, image->m_size);
-
-        imageBitmap.Set("data", buffer);
-        imageBitmap.Set("width", Napi::Number::New(env, image->m_width).As<Napi::Value>());
-        imageBitmap.Set("height", Napi::Number::New(env, image->m_height).As<Napi::Value>());
-        imageBitmap.Set("depth", Napi::Number::New(env, image->m_depth).As<Napi::Value>());
-        imageBitmap.Set("numLayers", Napi::Number::New(env, image->m_numLayers).As<Napi::Value>());
-        imageBitmap.Set("format", Napi::Number::New(env, image->m_format).As<Napi::Value>());
-
-        bimg::imageFree(image);
-        return std::move(imageBitmap);
+        return CreateImageBitmapObject(env, MakeImagePtr(image));
     }
 
     Napi::Value NativeEngine::ResizeImageBitmap(const Napi::CallbackInfo& info)
@@ -1451,39 +2322,97 @@ namespace Babylon
 
         const Napi::Env env{info.Env()};
 
-        bimg::ImageContainer* image = bimg::imageAlloc(&m_allocator, format, static_cast<uint16_t>(width), static_cast<uint16_t>(height), 1, 1, false, false, data.Data());
-        if (image == nullptr)
+        try
         {
-            throw Napi::Error::New(env, "Unable to allocate image for ResizeImageBitmap.");
+            return ToUint8Array(env, MakeImagePtr(ResizeImage(GetImageAllocator(), data.Data(), format, width, height, bufferWidth, bufferHeight)));
         }
-
-        if (format != bimg::TextureFormat::RGBA8)
+        catch (const std::exception& exception)
         {
-            if (format == bimg::TextureFormat::R8)
-            {
-                image->m_format = bimg::TextureFormat::A8;
-            }
-            bimg::ImageContainer* rgba = bimg::imageConvert(&m_allocator, bimg::TextureFormat::RGBA8, *image, false);
-            if (rgba == nullptr)
-            {
-                throw Napi::Error::New(env, "Unable to convert image to RGBA pixel format for ResizeImageBitmap.");
-            }
-            bimg::imageFree(image);
-            image = rgba;
+            throw Napi::Error::New(env, exception);
         }
+    }
 
-        auto outputData = Napi::Uint8Array::New(env, bufferWidth * bufferHeight * 4);
-        if (width != bufferWidth || height != bufferHeight)
+    Napi::Value NativeEngine::CreateImageBitmapAsync(const Napi::CallbackInfo& info)
+    {
+        const Napi::Env env{info.Env()};
+        if (!info[0].IsArrayBuffer())
         {
-            stbir_resize_uint8(static_cast<unsigned char*>(image->m_data), width, height, 0,
-                outputData.Data(), bufferWidth, bufferHeight, 0, 4);
+            throw Napi::Error::New(env, "CreateImageBitmapAsync parameter is not an array buffer.");
         }
-        else
+
+        const auto data = info[0].As<Napi::ArrayBuffer>();
+        if (!data.ByteLength())
         {
-            memcpy(outputData.Data(), image->m_data, image->m_size);
+            throw Napi::Error::New(env, "CreateImageBitmapAsync array buffer is empty.");
         }
-        bimg::imageFree(image);
-        return Napi::Value::From(env, outputData);
+
+        const auto dataSpan = gsl::make_span(static_cast<const uint8_t*>(data.Data()), data.ByteLength());
+        auto deferred{Napi::Promise::Deferred::New(env)};
+
+        // The promise settles even when the engine is disposed: the image is owned by the task result, so it is
+        // freed when dropped, and the last continuation runs without the engine's cancellation to reject it.
+        arcana::make_task(m_decodeScheduler, *m_cancellationSource, [dataSpan, cancellationSource{m_cancellationSource}]() {
+            bimg::ImageContainer* image = bimg::imageParse(GetImageAllocator(), dataSpan.data(), static_cast<uint32_t>(dataSpan.size()));
+            if (image == nullptr)
+            {
+                throw std::runtime_error{"Unable to decode image in createImageBitmapAsync function."};
+            }
+
+            return MakeImagePtr(image);
+        })
+            .then(m_runtimeScheduler, arcana::cancellation::none(), [deferred, env, dataRef{Napi::Persistent(data)}, cancellationSource{m_cancellationSource}](arcana::expected<ImagePtr, std::exception_ptr> result) {
+                if (cancellationSource->cancelled())
+                {
+                    deferred.Reject(Napi::Error::New(env, "The engine was disposed before createImageBitmapAsync completed.").Value());
+                }
+                else if (result.has_error())
+                {
+                    deferred.Reject(Napi::Error::New(env, result.error()).Value());
+                }
+                else
+                {
+                    deferred.Resolve(CreateImageBitmapObject(env, result.value()));
+                }
+            });
+
+        return deferred.Promise();
+    }
+
+    Napi::Value NativeEngine::ResizeImageBitmapAsync(const Napi::CallbackInfo& info)
+    {
+        const auto imageBitmap = info[0].As<Napi::Object>();
+        const auto bufferWidth = info[1].As<Napi::Number>().Uint32Value();
+        const auto bufferHeight = info[2].As<Napi::Number>().Uint32Value();
+
+        const auto data = imageBitmap.Get("data").As<Napi::Uint8Array>();
+        const auto width = imageBitmap.Get("width").As<Napi::Number>().Uint32Value();
+        const auto height = imageBitmap.Get("height").As<Napi::Number>().Uint32Value();
+        const auto format = static_cast<bimg::TextureFormat::Enum>(imageBitmap.Get("format").As<Napi::Number>().Uint32Value());
+
+        const Napi::Env env{info.Env()};
+        auto deferred{Napi::Promise::Deferred::New(env)};
+
+        // The source pixels are read in place on the worker; the reference keeps them alive until then.
+        // Settles like createImageBitmapAsync when the engine is disposed.
+        arcana::make_task(m_decodeScheduler, *m_cancellationSource, [pixels{data.Data()}, format, width, height, bufferWidth, bufferHeight, cancellationSource{m_cancellationSource}]() {
+            return MakeImagePtr(ResizeImage(GetImageAllocator(), pixels, format, width, height, bufferWidth, bufferHeight));
+        })
+            .then(m_runtimeScheduler, arcana::cancellation::none(), [deferred, env, dataRef{Napi::Persistent(data)}, cancellationSource{m_cancellationSource}](arcana::expected<ImagePtr, std::exception_ptr> result) {
+                if (cancellationSource->cancelled())
+                {
+                    deferred.Reject(Napi::Error::New(env, "The engine was disposed before resizeImageBitmapAsync completed.").Value());
+                }
+                else if (result.has_error())
+                {
+                    deferred.Reject(Napi::Error::New(env, result.error()).Value());
+                }
+                else
+                {
+                    deferred.Resolve(ToUint8Array(env, result.value()));
+                }
+            });
+
+        return deferred.Promise();
     }
 
     void NativeEngine::GetFrameBufferData(const Napi::CallbackInfo& info)
@@ -1544,40 +2473,111 @@ namespace Babylon
             }
         }
 
-        if (!m_boundFrameBuffer->DefaultBackBuffer() && !bgfx::getCaps()->originBottomLeft)
-        {
-            // UV coordinates system are different between OpenGL and Direct3D/Metal
-            // This is not an issue with loaded textures (png/jpg...) because
-            // texel rows bytes are also using a different convention
-            // see https://www.puredevsoftware.com/blog/2018/03/17/texture-coordinates-d3d-vs-opengl/
-            // for render to texture, as the texel bytes are not reversed, sampling a RTT for
-            // post process or shadows will result in inversion on V axis (Y)
-            // to compensate for that, any matrix that is used to project onto clip-space has
-            // to be flipped.
-            // The involved matrices are determined by name and a boolean YFlip is set to true.
-            // When rendering to texture, those matrices are flipped and set as uniform datas.
-            // But because flipping clip-space coordinates also flips triangles winding,
-            // Culling also has to be flipped.
-            for (const auto& it : m_currentProgram->Uniforms)
+        CompiledProgram& compiled{*m_currentProgram->Compiled};
+        if (compiled.SharedUniformsGeneration != m_uniformBlocksGeneration)
+        {
+            ResolveSharedUniforms(compiled);
+        }
+
+        // A packed uniform shares its vec4 with uniforms of the program. Its block value goes into a copy of that vec4,
+        // under the components set on the program, so that the program's own values are left untouched.
+        m_packedSharedUniforms.clear();
+        for (const auto& shared : compiled.SharedUniforms)
+        {
+            const auto& data{shared.Uniform->Data};
+            if (shared.Info->PackedSize != 0 && !data.empty())
             {
-                const ProgramData::UniformValue& value = it.second;
-                if (value.YFlip)
+                const auto handle{shared.Info->Handle};
+                auto it{std::find_if(m_packedSharedUniforms.begin(), m_packedSharedUniforms.end(), [handle](const auto& packed) { return packed.first.idx == handle.idx; })};
+                if (it == m_packedSharedUniforms.end())
                 {
-                    float tmpMatrix[16];
-                    static const float flipMatrix[16] = {
-                        1.f, 0.f, 0.f, 0.f,
-                        0.f, -1.f, 0.f, 0.f,
-                        0.f, 0.f, 1.f, 0.f,
-                        0.f, 0.f, 0.f, 1.f};
-                    bx::mtxMul(tmpMatrix, value.Data.data(), flipMatrix);
-                    encoder->setUniform({it.first}, tmpMatrix, value.ElementLength);
+                    it = m_packedSharedUniforms.emplace(m_packedSharedUniforms.end(), handle, std::array<float, 4>{});
                 }
-                else
+
+                std::copy_n(data.begin(), std::min(static_cast<size_t>(shared.Info->PackedSize), data.size()), it->second.begin() + shared.Info->PackedOffset);
+            }
+        }
+
+        for (auto& [handle, components] : m_packedSharedUniforms)
+        {
+            const auto programValue{m_currentProgram->Uniforms.find(handle.idx)};
+            if (programValue != m_currentProgram->Uniforms.end())
+            {
+                const ProgramData::UniformValue& value{programValue->second};
+                for (size_t component = 0; component < components.size(); ++component)
                 {
-                    encoder->setUniform({it.first}, value.Data.data(), value.ElementLength);
+                    if ((value.PackedComponents & (1 << component)) != 0)
+                    {
+                        components[component] = value.Data[component];
+                    }
                 }
             }
+        }
+
+        // UV coordinates system are different between OpenGL and Direct3D/Metal
+        // This is not an issue with loaded textures (png/jpg...) because
+        // texel rows bytes are also using a different convention
+        // see https://www.puredevsoftware.com/blog/2018/03/17/texture-coordinates-d3d-vs-opengl/
+        // for render to texture, as the texel bytes are not reversed, sampling a RTT for
+        // post process or shadows will result in inversion on V axis (Y)
+        // to compensate for that, any matrix that is used to project onto clip-space has
+        // to be flipped.
+        // The involved matrices are determined by name and a boolean YFlip is set to true.
+        // When rendering to texture, those matrices are flipped and set as uniform datas.
+        // But because flipping clip-space coordinates also flips triangles winding,
+        // Culling also has to be flipped.
+        const bool flipY{!m_boundFrameBuffer->DefaultBackBuffer() && !bgfx::getCaps()->originBottomLeft};
+
+        const auto setUniform{[encoder, flipY](bgfx::UniformHandle handle, const float* data, uint16_t elementLength, bool yFlip) {
+            if (flipY && yFlip)
+            {
+                float tmpMatrix[16];
+                static const float flipMatrix[16] = {
+                    1.f, 0.f, 0.f, 0.f,
+                    0.f, -1.f, 0.f, 0.f,
+                    0.f, 0.f, 1.f, 0.f,
+                    0.f, 0.f, 0.f, 1.f};
+                bx::mtxMul(tmpMatrix, data, flipMatrix);
+                encoder->setUniform(handle, tmpMatrix, elementLength);
+            }
+            else
+            {
+                encoder->setUniform(handle, data, elementLength);
+            }
+        }};
+
+        // Block values are set first so that a value set on the program itself takes precedence.
+        for (const auto& shared : compiled.SharedUniforms)
+        {
+            const auto& data{shared.Uniform->Data};
+            const auto elementLength{std::min(data.size() / shared.FloatsPerElement, static_cast<size_t>(shared.MaxElements))};
+            if (shared.Info->PackedSize == 0 && elementLength != 0)
+            {
+                setUniform(shared.Info->Handle, data.data(), static_cast<uint16_t>(elementLength), shared.Info->YFlip);
+            }
+        }
 
+        for (const auto& it : m_currentProgram->Uniforms)
+        {
+            // Registers shared with a block are set once below, merged with the program's components.
+            const bool packedShared{std::any_of(m_packedSharedUniforms.begin(), m_packedSharedUniforms.end(), [idx{it.first}](const auto& packed) { return packed.first.idx == idx; })};
+            if (packedShared)
+            {
+                continue;
+            }
+
+            const ProgramData::UniformValue& value = it.second;
+            setUniform({it.first}, value.Data.data(), value.ElementLength, value.YFlip);
+        }
+
+        // Set last, as these vec4s already hold the program's values of the components.
+        for (const auto& [handle, components] : m_packedSharedUniforms)
+        {
+            encoder->setUniform(handle, components.data(), 1);
+        }
+
+        if (flipY)
+        {
             // We need to explicitly swap the culling state flags (instead of XOR)
             // because we would like to preserve the no culling configuration, which is 00.
             const auto cullCW = (m_engineState & BGFX_STATE_CULL_CCW) != 0 ? BGFX_STATE_CULL_CW : 0;
@@ -1591,17 +2591,11 @@ namespace Babylon
         }
         else
         {
-            for (const auto& it : m_currentProgram->Uniforms)
-            {
-                const ProgramData::UniformValue& value = it.second;
-                encoder->setUniform({it.first}, value.Data.data(), value.ElementLength);
-            }
-
             encoder->setState(m_engineState | fillModeState);
         }
 
         // Discard everything except bindings since we keep the state of everything else.
-        m_boundFrameBuffer->Submit(encoder, m_currentProgram->Handle, BGFX_DISCARD_ALL & ~BGFX_DISCARD_BINDINGS);
+        m_boundFrameBuffer->Submit(encoder, m_currentProgram->Compiled->Handle, BGFX_DISCARD_ALL & ~BGFX_DISCARD_BINDINGS);
     }
 
     Graphics::Impl::UpdateToken& NativeEngine::GetUpdateToken()
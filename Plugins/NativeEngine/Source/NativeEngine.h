@@ -2,10 +2,17 @@
 
 #include "BgfxCallback.h"
 #include "FrameBuffer.h"
+#include "ShaderCache.h"
 #include "ShaderCompiler.h"
+#include "ShaderManifest.h"
+#include "TextureCache.h"
+#include "TextureCompression.h"
+#include "TextureDiskCache.h"
+#include "TextureDownscale.h"
 
 #include <Babylon/JsRuntime.h>
 #include <Babylon/JsRuntimeScheduler.h>
+#include <Babylon/ThreadPool.h>
 
 #include <GraphicsImpl.h>
 
@@ -22,6 +29,8 @@
 
 #include <arcana/containers/weak_table.h>
 #include <arcana/threading/cancellation.h>
+#include <algorithm>
+#include <array>
 #include <unordered_map>
 
 namespace Babylon
@@ -30,18 +39,48 @@ namespace Babylon
     {
         ~TextureData()
         {
+            Cancellation->cancel();
+
             if (OwnsHandle && bgfx::isValid(Handle))
             {
                 bgfx::destroy(Handle);
             }
         }
 
+        // Replaces the handle, first destroying the previous one if the texture owned it. A handle owned by
+        // something else, such as a frame buffer or the texture cache, is not destroyed with the texture; for
+        // the texture cache, cached holds on to it for as long as the texture uses it.
+        void SetHandle(bgfx::TextureHandle handle, bool ownsHandle = true, std::shared_ptr<const TextureCache::Texture> cached = {})
+        {
+            if (OwnsHandle && bgfx::isValid(Handle) && Handle.idx != handle.idx)
+            {
+                bgfx::destroy(Handle);
+            }
+
+            Handle = handle;
+            OwnsHandle = ownsHandle;
+            Cached = std::move(cached);
+        }
+
         bgfx::TextureHandle Handle{bgfx::kInvalidHandle};
         bool OwnsHandle{true};
         uint32_t Width{0};
         uint32_t Height{0};
         uint32_t Flags{0};
         uint8_t AnisotropicLevel{0};
+
+        // Set when the texture was block-compressed at load time.
+        std::optional<TextureCompression::Result> Compression{};
+
+        // Set when the texture was shrunk at load time to fit the engine's maximum texture size.
+        std::optional<TextureDownscale::Result> Downscale{};
+
+        // Set when the handle is shared with other textures loaded from the same content; owns the handle.
+        std::shared_ptr<const TextureCache::Texture> Cached{};
+
+        // Cancelled when the texture is deleted, so that loads still in flight drop their results instead of
+        // writing to it. Loads hold on to it, as it must outlive their queued uploads.
+        std::shared_ptr<arcana::cancellation_source> Cancellation{std::make_shared<arcana::cancellation_source>()};
     };
 
     struct UniformInfo final
@@ -49,15 +88,46 @@ namespace Babylon
         uint8_t Stage{};
         bgfx::UniformHandle Handle{bgfx::kInvalidHandle};
         bool YFlip{false};
+
+        // For a uniform packed with others into a shared vec4 uniform, which Handle then refers to: the
+        // components it occupies. PackedSize is 0 for every other uniform.
+        uint8_t PackedOffset{};
+        uint8_t PackedSize{};
     };
 
-    struct ProgramData final
+    // A named set of scene-wide uniform values (view, projection, eye position, lights...) that JS updates once per
+    // frame instead of on every program. At submit, each program picks up the values of the block uniforms that its
+    // reflection has a uniform of the same name for. The JS handles of a block and of its uniforms share ownership of
+    // them, so deleting a block only detaches it from the engine; handles to it stay valid but no longer affect programs.
+    struct UniformBlock final
     {
-        ProgramData() = default;
-        ProgramData(const ProgramData&) = delete;
-        ProgramData(ProgramData&&) = delete;
+        explicit UniformBlock(std::string name)
+            : Name{std::move(name)}
+        {
+        }
+
+        UniformBlock(const UniformBlock&) = delete;
+        UniformBlock(UniformBlock&&) = delete;
+
+        struct Uniform
+        {
+            // Laid out in vec4 registers like the values set on programs: 4 floats per vector, 16 per matrix.
+            std::vector<float> Data{};
+        };
+
+        std::string Name{};
+        std::unordered_map<std::string, std::shared_ptr<Uniform>> Uniforms{};
+    };
 
-        ~ProgramData()
+    // Compiled state of a program: the bgfx handle plus its reflection data. Shared by every program
+    // object created from the same sources; only the per-instance uniform values live in ProgramData.
+    struct CompiledProgram final
+    {
+        CompiledProgram() = default;
+        CompiledProgram(const CompiledProgram&) = delete;
+        CompiledProgram(CompiledProgram&&) = delete;
+
+        ~CompiledProgram()
         {
             if (bgfx::isValid(Handle))
             {
@@ -69,23 +139,64 @@ namespace Babylon
         std::unordered_map<std::string, UniformInfo> VertexUniformInfos{};
         std::unordered_map<std::string, UniformInfo> FragmentUniformInfos{};
 
+        // The uniforms of this program whose values come from uniform blocks. Resolved again on the first submit
+        // after the engine's uniform blocks gain or lose uniforms, which SharedUniformsGeneration tracks.
+        struct SharedUniform
+        {
+            const UniformInfo* Info{};
+            const UniformBlock::Uniform* Uniform{};
+            uint16_t FloatsPerElement{};
+            uint16_t MaxElements{};
+        };
+
+        std::vector<SharedUniform> SharedUniforms{};
+        uint32_t SharedUniformsGeneration{};
+
         bgfx::ProgramHandle Handle{bgfx::kInvalidHandle};
+    };
+
+    struct ProgramData final
+    {
+        explicit ProgramData(std::shared_ptr<CompiledProgram> compiled)
+            : Compiled{std::move(compiled)}
+        {
+        }
+
+        ProgramData(const ProgramData&) = delete;
+        ProgramData(ProgramData&&) = delete;
+
+        std::shared_ptr<CompiledProgram> Compiled{};
 
         struct UniformValue
         {
             std::vector<float> Data{};
             uint16_t ElementLength{};
             bool YFlip{false};
+
+            // For a shared vec4 of packed uniforms: a bit per component that a uniform of the program was set to.
+            uint8_t PackedComponents{};
         };
 
         std::unordered_map<uint16_t, UniformValue> Uniforms{};
 
-        void SetUniform(bgfx::UniformHandle handle, gsl::span<const float> data, bool YFlip, size_t elementLength = 1)
+        void SetUniform(const UniformInfo& info, gsl::span<const float> data, size_t elementLength = 1)
         {
-            UniformValue& value = Uniforms[handle.idx];
-            value.Data.assign(data.begin(), data.end());
-            value.ElementLength = static_cast<uint16_t>(elementLength);
-            value.YFlip = YFlip;
+            UniformValue& value = Uniforms[info.Handle.idx];
+            if (info.PackedSize == 0)
+            {
+                value.Data.assign(data.begin(), data.end());
+                value.ElementLength = static_cast<uint16_t>(elementLength);
+                value.YFlip = info.YFlip;
+            }
+            else
+            {
+                // Only overwrite this uniform's components, the others belong to other uniforms.
+                value.Data.resize(4);
+                const size_t size{std::min(static_cast<size_t>(info.PackedSize), static_cast<size_t>(data.size()))};
+                std::copy_n(data.begin(), size, value.Data.begin() + info.PackedOffset);
+                value.ElementLength = 1;
+                value.PackedComponents |= static_cast<uint8_t>(((1 << size) - 1) << info.PackedOffset);
+            }
         }
     };
 
@@ -149,6 +260,8 @@ namespace Babylon
         void RecordVertexBuffer(const Napi::CallbackInfo& info);
         void UpdateDynamicVertexBuffer(const Napi::CallbackInfo& info);
         Napi::Value CreateProgram(const Napi::CallbackInfo& info);
+        Napi::Value CreateProgramAsync(const Napi::CallbackInfo& info);
+        Napi::Value GetShaderCacheStatistics(const Napi::CallbackInfo& info);
         Napi::Value GetUniforms(const Napi::CallbackInfo& info);
         Napi::Value GetAttributes(const Napi::CallbackInfo& info);
         void SetProgram(const Napi::CallbackInfo& info);
@@ -177,9 +290,29 @@ namespace Babylon
         void SetFloat2(const Napi::CallbackInfo& info);
         void SetFloat3(const Napi::CallbackInfo& info);
         void SetFloat4(const Napi::CallbackInfo& info);
+        Napi::Value CreateUniformBlock(const Napi::CallbackInfo& info);
+        void DeleteUniformBlock(const Napi::CallbackInfo& info);
+        Napi::Value GetUniformBlockUniforms(const Napi::CallbackInfo& info);
+        void SetUniformBlockMatrix(const Napi::CallbackInfo& info);
+        void SetUniformBlockFloatArray4(const Napi::CallbackInfo& info);
+        void SetUniformBlockFloat4(const Napi::CallbackInfo& info);
         Napi::Value CreateTexture(const Napi::CallbackInfo& info);
         void LoadTexture(const Napi::CallbackInfo& info);
+        // A staged upload, not a progressive decode: the whole image is decoded and its full mip chain generated
+        // (and compressed, if enabled) before the texture is created. Only the uploads are staged, smallest level
+        // first and within the per-frame upload budget, with onLevelLoaded called as each level becomes resident.
+        // The first level therefore shows up no sooner than with loadTexture; what shrinks is the frame time spent
+        // uploading a large texture at once. Goes through the texture and disk caches like loadTexture with mips;
+        // a texture served from the cache is complete, so only level 0 is reported before onSuccess.
+        void LoadTextureStreaming(const Napi::CallbackInfo& info);
         void LoadRawTexture(const Napi::CallbackInfo& info);
+        void EnableTextureCompression(const Napi::CallbackInfo& info);
+        void DisableTextureCompression(const Napi::CallbackInfo& info);
+        Napi::Value GetTextureCompressionInfo(const Napi::CallbackInfo& info);
+        void SetMaximumTextureSize(const Napi::CallbackInfo& info);
+        Napi::Value GetTextureDownscaleInfo(const Napi::CallbackInfo& info);
+        void SetTextureCacheEnabled(const Napi::CallbackInfo& info);
+        Napi::Value GetTextureCacheStatistics(const Napi::CallbackInfo& info);
         void LoadCubeTexture(const Napi::CallbackInfo& info);
         void LoadCubeTextureWithMips(const Napi::CallbackInfo& info);
         Napi::Value GetTextureWidth(const Napi::CallbackInfo& info);
@@ -201,32 +334,73 @@ namespace Babylon
         void SetViewPort(const Napi::CallbackInfo& info);
         Napi::Value GetHardwareScalingLevel(const Napi::CallbackInfo& info);
         void SetHardwareScalingLevel(const Napi::CallbackInfo& info);
+        void EnableDynamicResolution(const Napi::CallbackInfo& info);
+        void DisableDynamicResolution(const Napi::CallbackInfo& info);
+        Napi::Value GetFrameStatistics(const Napi::CallbackInfo& info);
         Napi::Value CreateImageBitmap(const Napi::CallbackInfo& info);
         Napi::Value ResizeImageBitmap(const Napi::CallbackInfo& info);
+        Napi::Value CreateImageBitmapAsync(const Napi::CallbackInfo& info);
+        Napi::Value ResizeImageBitmapAsync(const Napi::CallbackInfo& info);
         void GetFrameBufferData(const Napi::CallbackInfo& info);
 
         void Draw(bgfx::Encoder* encoder, int fillMode);
+        std::shared_ptr<CompiledProgram> FindCompiledProgram(uint64_t cacheKey);
+        std::shared_ptr<CompiledProgram> CreateCompiledProgram(uint64_t cacheKey, const ShaderCompiler::BgfxShaderInfo& shaderInfo);
+        Napi::Value CreateProgramObject(Napi::Env env, std::shared_ptr<CompiledProgram> compiled);
+        void ResolveSharedUniforms(CompiledProgram& compiled) const;
 
         Graphics::Impl::UpdateToken& GetUpdateToken();
 
         std::shared_ptr<arcana::cancellation_source> m_cancellationSource{};
 
         ShaderCompiler m_shaderCompiler{};
+        ShaderCache& m_shaderCache{ShaderCache::GetDefault()};
+        ShaderManifest& m_shaderManifest{ShaderManifest::GetDefault()};
 
         ProgramData* m_currentProgram{nullptr};
         arcana::weak_table<std::unique_ptr<ProgramData>> m_programDataCollection{};
 
+        // Compiled programs keyed by ShaderCache::ComputeKey, so that identical sources share one bgfx program.
+        // Entries expire once the last program object using them is finalized.
+        std::unordered_map<uint64_t, std::weak_ptr<CompiledProgram>> m_compiledPrograms{};
+
+        // Uniform blocks keyed by name. The generation changes whenever the set of block uniforms does, so that
+        // compiled programs know to resolve their shared uniforms again; it starts at 1 so that none are resolved.
+        std::unordered_map<std::string, std::shared_ptr<UniformBlock>> m_uniformBlocks{};
+        uint32_t m_uniformBlocksGeneration{1};
+
+        // Scratch space for Draw: the shared vec4s of the current program that block uniforms are packed into, with
+        // the components set on the program laid over the block values.
+        std::vector<std::pair<bgfx::UniformHandle, std::array<float, 4>>> m_packedSharedUniforms{};
+
         JsRuntime& m_runtime;
         Graphics::Impl& m_graphicsImpl;
 
         JsRuntimeScheduler m_runtimeScheduler;
 
+        // Background decode work, tied to m_cancellationSource so that disposal drops queued work.
+        ThreadPool::Scheduler m_decodeScheduler;
+
+        // Background shader compilation; higher priority than decoding since materials wait on it before drawing.
+        ThreadPool::Scheduler m_shaderCompileScheduler;
+
+        // Set while runtime compression of loaded textures is enabled; read when a load starts.
+        std::optional<TextureCompression::Quality> m_textureCompression{};
+
+        // Set while loaded textures are limited to a maximum size; read when a load starts.
+        std::optional<TextureDownscale::Settings> m_textureDownscale{};
+
+        TextureCache m_textureCache{};
+        bool m_textureCacheEnabled{true};
+
+        // Null unless the host enabled the disk cache before this engine was created.
+        std::shared_ptr<TextureDiskCache> m_textureDiskCache{TextureDiskCache::GetDefault()};
+
         std::optional<Graphics::Impl::UpdateToken> m_updateToken{};
 
         void ScheduleRequestAnimationFrameCallbacks();
         bool m_requestAnimationFrameCallbacksScheduled{};
 
-        bx::DefaultAllocator m_allocator{};
         uint64_t m_engineState{BGFX_STATE_DEFAULT};
 
         template<int size, typename arrayType>
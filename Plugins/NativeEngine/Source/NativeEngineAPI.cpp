@@ -1,10 +1,40 @@
 #include <Babylon/Plugins/NativeEngine.h>
 #include "NativeEngine.h"
+#include "ShaderCache.h"
+#include "ShaderManifest.h"
+#include "TextureDiskCache.h"
 
 namespace Babylon::Plugins::NativeEngine
 {
     void Initialize(Napi::Env env)
     {
         Babylon::NativeEngine::Initialize(env);
+
+        ShaderManifest::GetDefault().Prewarm(ShaderCache::GetDefault(), Graphics::Impl::GetFromJavaScript(env).GetRendererType());
+    }
+
+    void EnableTextureDiskCache(std::string directory, uint64_t maxBytes)
+    {
+        TextureDiskCache::Configure(std::move(directory), maxBytes);
+    }
+
+    void EnableShaderDiskCache(std::string directory, uint64_t maxBytes)
+    {
+        ShaderCache::GetDefault().EnableDiskCache(std::move(directory), maxBytes);
+    }
+
+    void LoadShaderPack(std::string path)
+    {
+        ShaderCache::GetDefault().AddPack(std::make_shared<ShaderPack>(std::move(path)));
+    }
+
+    void EnableShaderPackOnlyMode()
+    {
+        ShaderCache::GetDefault().SetPackOnly(true);
+    }
+
+    void EnableShaderManifest(std::string path)
+    {
+        ShaderManifest::GetDefault().Enable(std::move(path));
     }
 }
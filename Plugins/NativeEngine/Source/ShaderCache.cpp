@@ -0,0 +1,464 @@
+#include "ShaderCache.h"
+#include "ContentHash.h"
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace Babylon
+{
+    namespace
+    {
+        constexpr uint32_t MAGIC{0x4353'4E42}; // "BNSC"
+        constexpr uint32_t FORMAT_VERSION{3};
+
+        struct FileHeader
+        {
+            uint32_t Magic;
+            uint32_t FormatVersion;
+            uint32_t CompilerVersion;
+            uint32_t HeaderSize;
+            uint64_t Key;
+            uint64_t PayloadSize;
+            uint64_t PayloadHash;
+        };
+
+        static_assert(sizeof(FileHeader) == 40);
+
+        gsl::span<const uint8_t> AsBytes(std::string_view string)
+        {
+            return gsl::make_span(reinterpret_cast<const uint8_t*>(string.data()), string.size());
+        }
+
+        class Writer
+        {
+        public:
+            template<typename T>
+            void Write(T value)
+            {
+                const auto* ptr{reinterpret_cast<const uint8_t*>(&value)};
+                m_bytes.insert(m_bytes.end(), ptr, ptr + sizeof(T));
+            }
+
+            void Write(const std::vector<uint8_t>& bytes)
+            {
+                Write(static_cast<uint32_t>(bytes.size()));
+                m_bytes.insert(m_bytes.end(), bytes.begin(), bytes.end());
+            }
+
+            void Write(const std::string& string)
+            {
+                Write(static_cast<uint32_t>(string.size()));
+                m_bytes.insert(m_bytes.end(), string.begin(), string.end());
+            }
+
+            void Write(const ShaderCompiler::PackedUniform& packedUniform)
+            {
+                Write(packedUniform.Register);
+                Write(packedUniform.Offset);
+                Write(packedUniform.Size);
+            }
+
+            template<typename ValueT>
+            void Write(const std::unordered_map<std::string, ValueT>& map)
+            {
+                Write(static_cast<uint32_t>(map.size()));
+                for (const auto& [name, value] : map)
+                {
+                    Write(name);
+                    Write(value);
+                }
+            }
+
+            std::vector<uint8_t>& Bytes()
+            {
+                return m_bytes;
+            }
+
+        private:
+            std::vector<uint8_t> m_bytes{};
+        };
+
+        class Reader
+        {
+        public:
+            explicit Reader(gsl::span<const uint8_t> bytes)
+                : m_bytes{bytes}
+            {
+            }
+
+            template<typename T>
+            T Read()
+            {
+                T value;
+                std::memcpy(&value, Take(sizeof(T)), sizeof(T));
+                return value;
+            }
+
+            template<typename T>
+            void Read(T& value)
+            {
+                value = Read<T>();
+            }
+
+            void Read(ShaderCompiler::PackedUniform& packedUniform)
+            {
+                packedUniform.Register = ReadString();
+                packedUniform.Offset = Read<uint8_t>();
+                packedUniform.Size = Read<uint8_t>();
+            }
+
+            std::vector<uint8_t> ReadBytes()
+            {
+                const auto size{Read<uint32_t>()};
+                const auto* data{Take(size)};
+                return {data, data + size};
+            }
+
+            std::string ReadString()
+            {
+                const auto size{Read<uint32_t>()};
+                const auto* data{Take(size)};
+                return {reinterpret_cast<const char*>(data), size};
+            }
+
+            template<typename ValueT>
+            std::unordered_map<std::string, ValueT> ReadMap()
+            {
+                std::unordered_map<std::string, ValueT> map{};
+                const auto count{Read<uint32_t>()};
+                for (uint32_t index = 0; index < count; ++index)
+                {
+                    auto name{ReadString()};
+                    ValueT value{};
+                    Read(value);
+                    map.emplace(std::move(name), std::move(value));
+                }
+
+                return map;
+            }
+
+            bool AtEnd() const
+            {
+                return m_offset == static_cast<size_t>(m_bytes.size());
+            }
+
+        private:
+            const uint8_t* Take(size_t size)
+            {
+                if (static_cast<size_t>(m_bytes.size()) - m_offset < size)
+                {
+                    throw std::runtime_error{"Cached shader is truncated."};
+                }
+
+                const auto* data{m_bytes.data() + m_offset};
+                m_offset += size;
+                return data;
+            }
+
+            gsl::span<const uint8_t> m_bytes;
+            size_t m_offset{};
+        };
+    }
+
+    ShaderCache::ShaderCache(size_t memoryCapacity)
+        : m_memoryCapacity{memoryCapacity}
+    {
+    }
+
+    ShaderCache& ShaderCache::GetDefault()
+    {
+        static ShaderCache cache{};
+        return cache;
+    }
+
+    void ShaderCache::EnableDiskCache(std::string directory, uint64_t maxBytes)
+    {
+        auto diskCache{std::make_shared<DiskCache>(std::move(directory), ".shader", maxBytes)};
+        std::scoped_lock lock{m_mutex};
+        m_diskCache = std::move(diskCache);
+    }
+
+    void ShaderCache::AddPack(std::shared_ptr<ShaderPack> pack)
+    {
+        std::scoped_lock lock{m_mutex};
+        m_packs.push_back(std::move(pack));
+    }
+
+    uint64_t ShaderCache::ComputeKey(std::string_view vertexSource, std::string_view fragmentSource, bgfx::RendererType::Enum renderer)
+    {
+        // The lengths keep the boundary between the two sources unambiguous.
+        const std::array<uint64_t, 4> parameters{ShaderCompiler::VERSION, static_cast<uint64_t>(renderer), vertexSource.size(), fragmentSource.size()};
+        const uint64_t seed{ContentHash(gsl::make_span(reinterpret_cast<const uint8_t*>(parameters.data()), sizeof(parameters)))};
+        return ContentHash(AsBytes(fragmentSource), ContentHash(AsBytes(vertexSource), seed));
+    }
+
+    std::vector<uint8_t> ShaderCache::Serialize(uint64_t key, const ShaderCompiler::BgfxShaderInfo& shaderInfo)
+    {
+        Writer payload{};
+        payload.Write(shaderInfo.VertexBytes);
+        payload.Write(shaderInfo.VertexAttributeLocations);
+        payload.Write(shaderInfo.VertexUniformStages);
+        payload.Write(shaderInfo.FragmentBytes);
+        payload.Write(shaderInfo.FragmentUniformStages);
+        payload.Write(shaderInfo.PackedUniforms);
+
+        const FileHeader header{MAGIC, FORMAT_VERSION, ShaderCompiler::VERSION, static_cast<uint32_t>(sizeof(FileHeader)), key, payload.Bytes().size(), ContentHash(payload.Bytes())};
+
+        std::vector<uint8_t> bytes(sizeof(FileHeader));
+        std::memcpy(bytes.data(), &header, sizeof(FileHeader));
+        bytes.insert(bytes.end(), payload.Bytes().begin(), payload.Bytes().end());
+        return bytes;
+    }
+
+    ShaderCompiler::BgfxShaderInfo ShaderCache::Deserialize(uint64_t key, gsl::span<const uint8_t> bytes)
+    {
+        if (static_cast<size_t>(bytes.size()) < sizeof(FileHeader))
+        {
+            throw std::runtime_error{"Cached shader is truncated."};
+        }
+
+        FileHeader header{};
+        std::memcpy(&header, bytes.data(), sizeof(FileHeader));
+
+        const auto payload{bytes.subspan(sizeof(FileHeader))};
+        if (header.Magic != MAGIC || header.FormatVersion != FORMAT_VERSION || header.CompilerVersion != ShaderCompiler::VERSION ||
+            header.HeaderSize != sizeof(FileHeader) || header.Key != key ||
+            header.PayloadSize != static_cast<uint64_t>(payload.size()) || header.PayloadHash != ContentHash(payload))
+        {
+            throw std::runtime_error{"Cached shader failed validation."};
+        }
+
+        Reader reader{payload};
+        ShaderCompiler::BgfxShaderInfo shaderInfo{};
+        shaderInfo.VertexBytes = reader.ReadBytes();
+        shaderInfo.VertexAttributeLocations = reader.ReadMap<uint32_t>();
+        shaderInfo.VertexUniformStages = reader.ReadMap<uint8_t>();
+        shaderInfo.FragmentBytes = reader.ReadBytes();
+        shaderInfo.FragmentUniformStages = reader.ReadMap<uint8_t>();
+        shaderInfo.PackedUniforms = reader.ReadMap<ShaderCompiler::PackedUniform>();
+
+        if (!reader.AtEnd())
+        {
+            throw std::runtime_error{"Cached shader has trailing data."};
+        }
+
+        return shaderInfo;
+    }
+
+    void ShaderCache::SetPackOnly(bool packOnly)
+    {
+        std::scoped_lock lock{m_mutex};
+        m_packOnly = packOnly;
+    }
+
+    bool ShaderCache::IsPackOnly() const
+    {
+        std::scoped_lock lock{m_mutex};
+        return m_packOnly;
+    }
+
+    ShaderCache::ShaderInfoPtr ShaderCache::Find(uint64_t key)
+    {
+        std::vector<std::shared_ptr<ShaderPack>> packs{};
+        std::shared_ptr<DiskCache> diskCache{};
+        {
+            std::scoped_lock lock{m_mutex};
+            auto it{m_entryIndex.find(key)};
+            if (it != m_entryIndex.end())
+            {
+                ++m_memoryHits;
+                m_entries.splice(m_entries.begin(), m_entries, it->second);
+                return it->second->second;
+            }
+
+            packs = m_packs;
+
+            // The disk cache only holds shaders compiled on the device, which pack-only mode rules out.
+            if (!m_packOnly)
+            {
+                diskCache = m_diskCache;
+            }
+        }
+
+        for (const auto& pack : packs)
+        {
+            if (const auto bytes{pack->Read(key)})
+            {
+                try
+                {
+                    auto shaderInfo{std::make_shared<const ShaderCompiler::BgfxShaderInfo>(Deserialize(key, bytes.value()))};
+
+                    std::scoped_lock lock{m_mutex};
+                    ++m_packHits;
+                    InsertLocked(key, shaderInfo);
+                    return shaderInfo;
+                }
+                catch (const std::exception&)
+                {
+                    // A damaged entry falls through to the other layers and, at worst, to the compiler.
+                }
+            }
+        }
+
+        if (diskCache)
+        {
+            if (const auto bytes{diskCache->Read(key)})
+            {
+                try
+                {
+                    auto shaderInfo{std::make_shared<const ShaderCompiler::BgfxShaderInfo>(Deserialize(key, bytes.value()))};
+
+                    std::scoped_lock lock{m_mutex};
+                    ++m_diskHits;
+                    InsertLocked(key, shaderInfo);
+                    return shaderInfo;
+                }
+                catch (const std::exception&)
+                {
+                    diskCache->Remove(key);
+                }
+            }
+        }
+
+        std::scoped_lock lock{m_mutex};
+        ++m_misses;
+        return {};
+    }
+
+    void ShaderCache::Store(uint64_t key, ShaderInfoPtr shaderInfo)
+    {
+        std::shared_ptr<DiskCache> diskCache{};
+        {
+            std::scoped_lock lock{m_mutex};
+            InsertLocked(key, shaderInfo);
+            diskCache = m_diskCache;
+        }
+
+        if (diskCache)
+        {
+            diskCache->Write(key, Serialize(key, *shaderInfo));
+        }
+    }
+
+    ShaderCache::ShaderInfoPtr ShaderCache::FindOrCompile(uint64_t key, std::string_view vertexSource, std::string_view fragmentSource, bgfx::RendererType::Enum renderer)
+    {
+        return FindOrCompile(key, [vertexSource, fragmentSource, renderer]() {
+            thread_local ShaderCompiler compiler{};
+            return compiler.Compile(vertexSource, fragmentSource, renderer);
+        });
+    }
+
+    ShaderCache::ShaderInfoPtr ShaderCache::FindOrCompile(uint64_t key, std::string_view vertexSource, std::string_view fragmentSource, bgfx::RendererType::Enum renderer, ShaderCompiler& compiler)
+    {
+        return FindOrCompile(key, [vertexSource, fragmentSource, renderer, &compiler]() {
+            return compiler.Compile(vertexSource, fragmentSource, renderer);
+        });
+    }
+
+    ShaderCache::ShaderInfoPtr ShaderCache::FindOrCompile(uint64_t key, const std::function<ShaderCompiler::BgfxShaderInfo()>& compile)
+    {
+        if (ShaderInfoPtr shaderInfo{Find(key)})
+        {
+            return shaderInfo;
+        }
+
+        std::promise<ShaderInfoPtr> promise{};
+        std::shared_future<ShaderInfoPtr> pending{};
+        {
+            std::scoped_lock lock{m_mutex};
+            if (m_packOnly)
+            {
+                throw std::runtime_error{PACK_MISS_MESSAGE};
+            }
+
+            // A compile of the same key may have finished since the lookup above.
+            auto entry{m_entryIndex.find(key)};
+            if (entry != m_entryIndex.end())
+            {
+                return entry->second->second;
+            }
+
+            auto [it, inserted]{m_pendingCompiles.try_emplace(key)};
+            if (inserted)
+            {
+                it->second = promise.get_future().share();
+            }
+            else
+            {
+                pending = it->second;
+            }
+        }
+
+        // Rethrows the error of the compile waited on.
+        if (pending.valid())
+        {
+            return pending.get();
+        }
+
+        ShaderInfoPtr shaderInfo{};
+        try
+        {
+            shaderInfo = std::make_shared<const ShaderCompiler::BgfxShaderInfo>(compile());
+            Store(key, shaderInfo);
+        }
+        catch (...)
+        {
+            promise.set_exception(std::current_exception());
+            std::scoped_lock lock{m_mutex};
+            m_pendingCompiles.erase(key);
+            throw;
+        }
+
+        promise.set_value(shaderInfo);
+
+        std::scoped_lock lock{m_mutex};
+        m_pendingCompiles.erase(key);
+        return shaderInfo;
+    }
+
+    ShaderCache::Statistics ShaderCache::GetStatistics() const
+    {
+        std::scoped_lock lock{m_mutex};
+
+        Statistics statistics{};
+        statistics.MemoryHits = m_memoryHits;
+        statistics.PackHits = m_packHits;
+        statistics.DiskHits = m_diskHits;
+        statistics.Misses = m_misses;
+        statistics.MemoryEntries = m_entries.size();
+        for (const auto& pack : m_packs)
+        {
+            statistics.PackEntries += pack->GetEntryCount();
+        }
+
+        if (m_diskCache)
+        {
+            const auto diskStatistics{m_diskCache->GetStatistics()};
+            statistics.DiskEntries = diskStatistics.Entries;
+            statistics.DiskBytes = diskStatistics.Bytes;
+        }
+
+        return statistics;
+    }
+
+    void ShaderCache::InsertLocked(uint64_t key, ShaderInfoPtr shaderInfo)
+    {
+        auto it{m_entryIndex.find(key)};
+        if (it != m_entryIndex.end())
+        {
+            it->second->second = std::move(shaderInfo);
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            return;
+        }
+
+        m_entries.emplace_front(key, std::move(shaderInfo));
+        m_entryIndex[key] = m_entries.begin();
+
+        if (m_entries.size() > m_memoryCapacity)
+        {
+            m_entryIndex.erase(m_entries.back().first);
+            m_entries.pop_back();
+        }
+    }
+}
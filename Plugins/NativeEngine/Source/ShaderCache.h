@@ -0,0 +1,103 @@
+#pragma once
+
+#include "DiskCache.h"
+#include "ShaderPack.h"
+#include "ShaderCompiler.h"
+
+#include <bgfx/bgfx.h>
+
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Babylon
+{
+    /// Process-wide cache of compiled shaders, keyed by a hash of the vertex and fragment sources, the
+    /// renderer and the compiler version. An in-memory LRU sits in front of read-only shader packs built
+    /// offline and an optional disk cache. Serialized shaders carry a header and checksum that are
+    /// validated on load. Thread-safe.
+    class ShaderCache final
+    {
+    public:
+        using ShaderInfoPtr = std::shared_ptr<const ShaderCompiler::BgfxShaderInfo>;
+
+        struct Statistics
+        {
+            uint64_t MemoryHits{};
+            uint64_t PackHits{};
+            uint64_t DiskHits{};
+            uint64_t Misses{};
+            size_t MemoryEntries{};
+            size_t PackEntries{};
+            size_t DiskEntries{};
+            uint64_t DiskBytes{};
+        };
+
+        static constexpr size_t DEFAULT_MEMORY_CAPACITY{256};
+
+        explicit ShaderCache(size_t memoryCapacity = DEFAULT_MEMORY_CAPACITY);
+
+        ShaderCache(const ShaderCache&) = delete;
+        ShaderCache& operator=(const ShaderCache&) = delete;
+
+        static ShaderCache& GetDefault();
+
+        // Adds a disk layer in an existing directory, evicting the least recently used files beyond maxBytes.
+        void EnableDiskCache(std::string directory, uint64_t maxBytes);
+
+        // Adds a pack of shaders built offline, consulted before the disk cache.
+        void AddPack(std::shared_ptr<ShaderPack> pack);
+
+        // In pack-only mode, shaders are only served from memory and packs, and FindOrCompile throws on a miss
+        // instead of compiling. Callers that compile on their own must check IsPackOnly.
+        void SetPackOnly(bool packOnly);
+        bool IsPackOnly() const;
+
+        // The error reported for a miss in pack-only mode.
+        static constexpr const char* PACK_MISS_MESSAGE{"Shader program is not in any loaded shader pack and shader compilation is disabled."};
+
+        static uint64_t ComputeKey(std::string_view vertexSource, std::string_view fragmentSource, bgfx::RendererType::Enum renderer);
+
+        // The format of disk cache files and shader pack entries; Deserialize throws if validation fails.
+        static std::vector<uint8_t> Serialize(uint64_t key, const ShaderCompiler::BgfxShaderInfo& shaderInfo);
+        static ShaderCompiler::BgfxShaderInfo Deserialize(uint64_t key, gsl::span<const uint8_t> bytes);
+
+        // Returns nullptr on a miss.
+        ShaderInfoPtr Find(uint64_t key);
+        void Store(uint64_t key, ShaderInfoPtr shaderInfo);
+
+        // Like Find, but compiles and stores the sources on a miss using a compiler owned by the calling thread,
+        // since glslang and SPIRV-Cross state cannot be shared between threads. A miss on a key that is already
+        // being compiled waits for that compile instead of starting another. Throws if compilation fails or,
+        // in pack-only mode, on a miss.
+        ShaderInfoPtr FindOrCompile(uint64_t key, std::string_view vertexSource, std::string_view fragmentSource, bgfx::RendererType::Enum renderer);
+
+        // Same, for callers that own a compiler; it must only be used from the calling thread.
+        ShaderInfoPtr FindOrCompile(uint64_t key, std::string_view vertexSource, std::string_view fragmentSource, bgfx::RendererType::Enum renderer, ShaderCompiler& compiler);
+
+        Statistics GetStatistics() const;
+
+    private:
+        ShaderInfoPtr FindOrCompile(uint64_t key, const std::function<ShaderCompiler::BgfxShaderInfo()>& compile);
+        void InsertLocked(uint64_t key, ShaderInfoPtr shaderInfo);
+
+        const size_t m_memoryCapacity;
+
+        mutable std::mutex m_mutex{};
+        std::list<std::pair<uint64_t, ShaderInfoPtr>> m_entries{};
+        std::unordered_map<uint64_t, std::list<std::pair<uint64_t, ShaderInfoPtr>>::iterator> m_entryIndex{};
+        std::unordered_map<uint64_t, std::shared_future<ShaderInfoPtr>> m_pendingCompiles{};
+        std::vector<std::shared_ptr<ShaderPack>> m_packs{};
+        std::shared_ptr<DiskCache> m_diskCache{};
+        bool m_packOnly{};
+        uint64_t m_memoryHits{};
+        uint64_t m_packHits{};
+        uint64_t m_diskHits{};
+        uint64_t m_misses{};
+    };
+}
@@ -2,14 +2,10 @@
 
 #include <string_view>
 #include <functional>
+#include <bgfx/bgfx.h>
 #include <spirv_cross.hpp>
 #include <spirv_parser.hpp>
 
-namespace bgfx
-{
-    struct Memory;
-}
-
 namespace Babylon
 {
     /// This class is responsible for compiling the GLSL shader from Babylon.js into
@@ -17,9 +13,28 @@ namespace Babylon
     class ShaderCompiler final
     {
     public:
+#ifdef BABYLON_NATIVE_SHADER_OPTIMIZER
+        // Whether the SPIR-V is run through the SPIRV-Tools optimizer before being cross-compiled.
+        static constexpr bool OPTIMIZE_SPIRV{true};
+#else
+        static constexpr bool OPTIMIZE_SPIRV{false};
+#endif
+
+        // Identifies the output of Compile in caches; bump it whenever the bytes generated for the same sources change.
+        // Optimized and unoptimized shaders never share cache entries or packs.
+        static constexpr uint32_t VERSION{OPTIMIZE_SPIRV ? 0x8000'0003 : 3};
+
         ShaderCompiler();
         ~ShaderCompiler();
 
+        // Where a float, vec2 or vec3 uniform lives once packed with others into a shared vec4 uniform.
+        struct PackedUniform
+        {
+            std::string Register{};
+            uint8_t Offset{};
+            uint8_t Size{};
+        };
+
         struct BgfxShaderInfo
         {
             std::vector<uint8_t> VertexBytes{};
@@ -28,8 +43,56 @@ namespace Babylon
 
             std::vector<uint8_t> FragmentBytes{};
             std::unordered_map<std::string, uint8_t> FragmentUniformStages{};
+
+            // By original uniform name. Only filled by the backends that pack uniforms (OpenGL, Metal and Vulkan).
+            std::unordered_map<std::string, PackedUniform> PackedUniforms{};
+        };
+
+        // The phases of Compile, in order. Not every backend goes through every phase, and the per-stage phases
+        // are reported once per stage.
+        enum class Phase
+        {
+            Parse,
+            Link,
+            ExpandDefaultUniformBlock,
+            PackUniforms,
+            ChangeUniformTypes,
+            MoveNonSamplerUniformsIntoStruct,
+            AssignLocationsAndNamesToVertexVaryings,
+            AssignLocationsToVaryingsAndFragmentOutputs,
+            SplitSamplersIntoSamplersAndTextures,
+            InvertYDerivativeOperands,
+            GlslangToSpv,
+            OptimizeSpirv,
+            SpirvCross,
+            D3DCompile,
+            CreateBgfxShader,
+        };
+
+        static constexpr size_t PHASE_COUNT{static_cast<size_t>(Phase::CreateBgfxShader) + 1};
+
+        static const char* GetPhaseName(Phase phase);
+
+        /// Receives the boundaries of the phases of Compile, on the compiling thread, for profiling.
+        class PhaseObserver
+        {
+        public:
+            virtual ~PhaseObserver() = default;
+
+            virtual void OnPhaseStart(Phase phase) = 0;
+            virtual void OnPhaseEnd(Phase phase) = 0;
         };
 
-        BgfxShaderInfo Compile(std::string_view vertexSource, std::string_view fragmentSource);
+        /// Throws if the renderer is not one the shaders can be compiled for on this platform.
+        BgfxShaderInfo Compile(std::string_view vertexSource, std::string_view fragmentSource, bgfx::RendererType::Enum renderer, PhaseObserver* observer = nullptr);
+
+        static bool IsRendererSupported(bgfx::RendererType::Enum renderer);
+
+    private:
+        // The backends, each defined in its own ShaderCompiler<API>.cpp; only the ones built for the platform exist.
+        static BgfxShaderInfo CompileD3D(std::string_view vertexSource, std::string_view fragmentSource, PhaseObserver* observer);
+        static BgfxShaderInfo CompileMetal(std::string_view vertexSource, std::string_view fragmentSource, PhaseObserver* observer);
+        static BgfxShaderInfo CompileOpenGL(std::string_view vertexSource, std::string_view fragmentSource, PhaseObserver* observer);
+        static BgfxShaderInfo CompileVulkan(std::string_view vertexSource, std::string_view fragmentSource, PhaseObserver* observer);
     };
 }
@@ -2,6 +2,12 @@
 #include "ShaderCompiler.h"
 #include <bx/bx.h>
 #include <bgfx/bgfx.h>
+#include <glslang/Public/ShaderLang.h>
+
+#ifdef BABYLON_NATIVE_SHADER_OPTIMIZER
+#include <spirv-tools/optimizer.hpp>
+#include <stdexcept>
+#endif
 
 #define BGFX_UNIFORM_FRAGMENTBIT UINT8_C(0x10) // Copy-pasta from bgfx_p.h
 #define BGFX_UNIFORM_SAMPLERBIT UINT8_C(0x20)  // Copy-pasta from bgfx_p.h
@@ -14,6 +20,14 @@ namespace bgfx
 
 namespace Babylon::ShaderCompilerCommon
 {
+    namespace
+    {
+        bool IsOpenGL(bgfx::RendererType::Enum renderer)
+        {
+            return renderer == bgfx::RendererType::OpenGL || renderer == bgfx::RendererType::OpenGLES;
+        }
+    }
+
     void AppendUniformBuffer(std::vector<uint8_t>& bytes, const NonSamplerUniformsInfo& uniformBuffer, bool isFragment)
     {
         const uint8_t fragmentBit = (isFragment ? BGFX_UNIFORM_FRAGMENTBIT : 0);
@@ -43,29 +57,27 @@ namespace Babylon::ShaderCompilerCommon
         }
     }
 
-    void AppendSamplers(std::vector<uint8_t>& bytes, const spirv_cross::Compiler& compiler, const spirv_cross::SmallVector<spirv_cross::Resource>& samplers, std::unordered_map<std::string, uint8_t>& stages)
+    void AppendSamplers(std::vector<uint8_t>& bytes, const spirv_cross::Compiler& compiler, const spirv_cross::SmallVector<spirv_cross::Resource>& samplers, std::unordered_map<std::string, uint8_t>& stages, bgfx::RendererType::Enum renderer)
     {
-#if APIOpenGL
         uint8_t stage{0};
-#endif
 
         for (const spirv_cross::Resource& sampler : samplers)
         {
+            if (!IsOpenGL(renderer))
+            {
+                stage = static_cast<uint8_t>(compiler.get_decoration(sampler.id, spv::DecorationBinding));
+            }
+
             AppendBytes(bytes, static_cast<uint8_t>(sampler.name.size()));
             AppendBytes(bytes, sampler.name);
             AppendBytes(bytes, static_cast<uint8_t>(bgfx::UniformType::Sampler | BGFX_UNIFORM_SAMPLERBIT));
 
-            // TODO : These values (num, regIndex, regCount) are only used by Vulkan and should be set for that API
+            // The values num, regIndex and regCount are only used by Vulkan, which binds the texture of the stage at regIndex.
             AppendBytes(bytes, static_cast<uint8_t>(0));
-            AppendBytes(bytes, static_cast<uint16_t>(0));
+            AppendBytes(bytes, static_cast<uint16_t>(renderer == bgfx::RendererType::Vulkan ? VULKAN_TEXTURE_BINDING_SHIFT + stage : 0));
             AppendBytes(bytes, static_cast<uint16_t>(0));
 
-#if APIOpenGL
-            (void)compiler;
-            stages[sampler.name] = stage++;
-#else
-            stages[sampler.name] = static_cast<uint8_t>(compiler.get_decoration(sampler.id, spv::DecorationBinding));
-#endif
+            stages[sampler.name] = IsOpenGL(renderer) ? stage++ : stage;
         }
     }
 
@@ -82,10 +94,22 @@ namespace Babylon::ShaderCompilerCommon
 
             info.ByteSize = static_cast<uint16_t>(type.member_types.empty() ? 0 : compiler.get_declared_struct_size(type));
 
-            info.Uniforms.resize(type.member_types.size());
+            // Members the shader never reads keep their place in the buffer but are not reported to bgfx,
+            // so that no value is uploaded for them.
+            std::vector<bool> activeMembers(type.member_types.size());
+            for (const auto& range : compiler.get_active_buffer_ranges(uniformBuffer.id))
+            {
+                activeMembers[range.index] = true;
+            }
+
             for (uint32_t index = 0; index < type.member_types.size(); ++index)
             {
-                auto& uniform = info.Uniforms[index];
+                if (!activeMembers[index])
+                {
+                    continue;
+                }
+
+                auto& uniform = info.Uniforms.emplace_back();
 
                 uniform.Name = compiler.get_member_name(uniformBuffer.base_type_id, index);
                 uniform.Offset = compiler.get_member_decoration(uniformBuffer.base_type_id, index, spv::DecorationOffset);
@@ -115,9 +139,10 @@ namespace Babylon::ShaderCompilerCommon
         else
         {
             info.ByteSize = 0;
+            const auto activeVariables = compiler.get_active_interface_variables();
             parser.get_parsed_ir().for_each_typed_id<spirv_cross::SPIRVariable>([&](uint32_t id, spirv_cross::SPIRVariable& var) {
                 auto& type = compiler.get_type_from_variable(id);
-                if (var.storage == spv::StorageClassUniformConstant &&
+                if (var.storage == spv::StorageClassUniformConstant && activeVariables.count(id) != 0 &&
                     type.basetype != spirv_cross::SPIRType::BaseType::SampledImage &&
                     type.basetype != spirv_cross::SPIRType::BaseType::Sampler)
                 {
@@ -153,7 +178,7 @@ namespace Babylon::ShaderCompilerCommon
         return info;
     }
 
-    ShaderCompiler::BgfxShaderInfo CreateBgfxShader(ShaderInfo vertexShaderInfo, ShaderInfo fragmentShaderInfo)
+    ShaderCompiler::BgfxShaderInfo CreateBgfxShader(ShaderInfo vertexShaderInfo, ShaderInfo fragmentShaderInfo, bgfx::RendererType::Enum renderer)
     {
         ShaderCompiler::BgfxShaderInfo bgfxShaderInfo{};
 
@@ -186,7 +211,7 @@ namespace Babylon::ShaderCompilerCommon
 
             AppendBytes(vertexBytes, static_cast<uint16_t>(numUniforms));
             AppendUniformBuffer(vertexBytes, uniformsInfo, false);
-            AppendSamplers(vertexBytes, compiler, samplers, bgfxShaderInfo.VertexUniformStages);
+            AppendSamplers(vertexBytes, compiler, samplers, bgfxShaderInfo.VertexUniformStages, renderer);
 
             AppendBytes(vertexBytes, static_cast<uint32_t>(vertexShaderInfo.Bytes.size()));
             AppendBytes(vertexBytes, vertexShaderInfo.Bytes);
@@ -214,10 +239,8 @@ namespace Babylon::ShaderCompilerCommon
             const auto uniformsInfo = CollectNonSamplerUniforms(*fragmentShaderInfo.Parser, compiler);
 #if __APPLE__
             const spirv_cross::SmallVector<spirv_cross::Resource>& samplers = resources.separate_images;
-#elif APIOpenGL
-            const spirv_cross::SmallVector<spirv_cross::Resource>& samplers = resources.sampled_images;
 #else
-            const spirv_cross::SmallVector<spirv_cross::Resource>& samplers = resources.separate_samplers;
+            const spirv_cross::SmallVector<spirv_cross::Resource>& samplers = IsOpenGL(renderer) ? resources.sampled_images : resources.separate_samplers;
 #endif
             size_t numUniforms = uniformsInfo.Uniforms.size() + samplers.size();
 
@@ -227,7 +250,7 @@ namespace Babylon::ShaderCompilerCommon
 
             AppendBytes(fragmentBytes, static_cast<uint16_t>(numUniforms));
             AppendUniformBuffer(fragmentBytes, uniformsInfo, true);
-            AppendSamplers(fragmentBytes, compiler, samplers, bgfxShaderInfo.FragmentUniformStages);
+            AppendSamplers(fragmentBytes, compiler, samplers, bgfxShaderInfo.FragmentUniformStages, renderer);
 
             AppendBytes(fragmentBytes, static_cast<uint32_t>(fragmentShaderInfo.Bytes.size()));
             AppendBytes(fragmentBytes, fragmentShaderInfo.Bytes);
@@ -241,4 +264,126 @@ namespace Babylon::ShaderCompilerCommon
 
         return bgfxShaderInfo;
     }
+
+    void OptimizeSpirv([[maybe_unused]] std::vector<uint32_t>& spirv, [[maybe_unused]] ShaderCompiler::PhaseObserver* observer)
+    {
+#ifdef BABYLON_NATIVE_SHADER_OPTIMIZER
+        PhaseScope scope{observer, ShaderCompiler::Phase::OptimizeSpirv};
+
+        // Matches the SPIR-V version the backends ask glslang for.
+        spvtools::Optimizer optimizer{SPV_ENV_UNIVERSAL_1_0};
+        optimizer.RegisterPerformancePasses();
+
+        std::vector<uint32_t> optimized{};
+        if (!optimizer.Run(spirv.data(), spirv.size(), &optimized))
+        {
+            throw std::runtime_error{"Failed to optimize SPIR-V"};
+        }
+
+        spirv = std::move(optimized);
+#endif
+    }
+}
+
+namespace Babylon
+{
+    ShaderCompiler::ShaderCompiler()
+    {
+        glslang::InitializeProcess();
+    }
+
+    ShaderCompiler::~ShaderCompiler()
+    {
+        glslang::FinalizeProcess();
+    }
+
+    ShaderCompiler::BgfxShaderInfo ShaderCompiler::Compile(std::string_view vertexSource, std::string_view fragmentSource, bgfx::RendererType::Enum renderer, PhaseObserver* observer)
+    {
+        switch (renderer)
+        {
+#if APID3D
+        case bgfx::RendererType::Direct3D11:
+        case bgfx::RendererType::Direct3D12:
+            return CompileD3D(vertexSource, fragmentSource, observer);
+#endif
+#if APIMetal
+        case bgfx::RendererType::Metal:
+            return CompileMetal(vertexSource, fragmentSource, observer);
+#endif
+#if APIOpenGL
+        case bgfx::RendererType::OpenGL:
+        case bgfx::RendererType::OpenGLES:
+            return CompileOpenGL(vertexSource, fragmentSource, observer);
+#endif
+#if APIVulkan
+        case bgfx::RendererType::Vulkan:
+            return CompileVulkan(vertexSource, fragmentSource, observer);
+#endif
+        default:
+            throw std::runtime_error{std::string{"Shaders cannot be compiled for renderer "} + bgfx::getRendererName(renderer)};
+        }
+    }
+
+    bool ShaderCompiler::IsRendererSupported(bgfx::RendererType::Enum renderer)
+    {
+        switch (renderer)
+        {
+#if APID3D
+        case bgfx::RendererType::Direct3D11:
+        case bgfx::RendererType::Direct3D12:
+#endif
+#if APIMetal
+        case bgfx::RendererType::Metal:
+#endif
+#if APIOpenGL
+        case bgfx::RendererType::OpenGL:
+        case bgfx::RendererType::OpenGLES:
+#endif
+#if APIVulkan
+        case bgfx::RendererType::Vulkan:
+#endif
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    const char* ShaderCompiler::GetPhaseName(Phase phase)
+    {
+        switch (phase)
+        {
+        case Phase::Parse:
+            return "Parse";
+        case Phase::Link:
+            return "Link";
+        case Phase::ExpandDefaultUniformBlock:
+            return "ExpandDefaultUniformBlock";
+        case Phase::PackUniforms:
+            return "PackUniforms";
+        case Phase::ChangeUniformTypes:
+            return "ChangeUniformTypes";
+        case Phase::MoveNonSamplerUniformsIntoStruct:
+            return "MoveNonSamplerUniformsIntoStruct";
+        case Phase::AssignLocationsAndNamesToVertexVaryings:
+            return "AssignLocationsAndNamesToVertexVaryings";
+        case Phase::AssignLocationsToVaryingsAndFragmentOutputs:
+            return "AssignLocationsToVaryingsAndFragmentOutputs";
+        case Phase::SplitSamplersIntoSamplersAndTextures:
+            return "SplitSamplersIntoSamplersAndTextures";
+        case Phase::InvertYDerivativeOperands:
+            return "InvertYDerivativeOperands";
+        case Phase::GlslangToSpv:
+            return "GlslangToSpv";
+        case Phase::OptimizeSpirv:
+            return "OptimizeSpirv";
+        case Phase::SpirvCross:
+            return "SpirvCross";
+        case Phase::D3DCompile:
+            return "D3DCompile";
+        case Phase::CreateBgfxShader:
+            return "CreateBgfxShader";
+        }
+
+        return "Unknown";
+    }
 }
@@ -10,6 +10,43 @@
 
 namespace Babylon::ShaderCompilerCommon
 {
+    /// Reports the enclosing scope as a phase of ShaderCompiler::Compile to the observer, if there is one.
+    class PhaseScope final
+    {
+    public:
+        PhaseScope(ShaderCompiler::PhaseObserver* observer, ShaderCompiler::Phase phase)
+            : m_observer{observer}
+            , m_phase{phase}
+        {
+            if (m_observer != nullptr)
+            {
+                m_observer->OnPhaseStart(m_phase);
+            }
+        }
+
+        ~PhaseScope()
+        {
+            if (m_observer != nullptr)
+            {
+                m_observer->OnPhaseEnd(m_phase);
+            }
+        }
+
+        PhaseScope(const PhaseScope&) = delete;
+        PhaseScope& operator=(const PhaseScope&) = delete;
+
+    private:
+        ShaderCompiler::PhaseObserver* const m_observer;
+        const ShaderCompiler::Phase m_phase;
+    };
+
+    template<typename CallableT>
+    inline auto RunPhase(ShaderCompiler::PhaseObserver* observer, ShaderCompiler::Phase phase, CallableT&& callable)
+    {
+        PhaseScope scope{observer, phase};
+        return callable();
+    }
+
     template<typename AppendageT>
     inline void AppendBytes(std::vector<uint8_t>& bytes, const AppendageT appendage)
     {
@@ -54,8 +91,16 @@ namespace Babylon::ShaderCompilerCommon
         std::vector<Uniform> Uniforms{};
     };
 
+    // The resource layout bgfx's Vulkan renderer binds against: the uniform block of each stage has a fixed binding,
+    // and texture stage N is bound to the texture at VULKAN_TEXTURE_BINDING_SHIFT + N and to the sampler
+    // VULKAN_SAMPLER_BINDING_SHIFT above it.
+    constexpr uint32_t VULKAN_VERTEX_UNIFORM_BLOCK_BINDING{0};
+    constexpr uint32_t VULKAN_FRAGMENT_UNIFORM_BLOCK_BINDING{1};
+    constexpr uint32_t VULKAN_TEXTURE_BINDING_SHIFT{2};
+    constexpr uint32_t VULKAN_SAMPLER_BINDING_SHIFT{16};
+
     void AppendUniformBuffer(std::vector<uint8_t>& bytes, const NonSamplerUniformsInfo& uniformBuffer, bool isFragment);
-    void AppendSamplers(std::vector<uint8_t>& bytes, const spirv_cross::Compiler& compiler, const spirv_cross::SmallVector<spirv_cross::Resource>& samplers, std::unordered_map<std::string, uint8_t>& stages);
+    void AppendSamplers(std::vector<uint8_t>& bytes, const spirv_cross::Compiler& compiler, const spirv_cross::SmallVector<spirv_cross::Resource>& samplers, std::unordered_map<std::string, uint8_t>& stages, bgfx::RendererType::Enum renderer);
     NonSamplerUniformsInfo CollectNonSamplerUniforms(spirv_cross::Parser& parser, const spirv_cross::Compiler& compiler);
 
     struct ShaderInfo
@@ -66,5 +111,9 @@ namespace Babylon::ShaderCompilerCommon
         std::unordered_map<std::string, std::string> AttributeRenaming;
     };
 
-    ShaderCompiler::BgfxShaderInfo CreateBgfxShader(ShaderInfo vertexShaderInfo, ShaderInfo fragmentShaderInfo);
+    ShaderCompiler::BgfxShaderInfo CreateBgfxShader(ShaderInfo vertexShaderInfo, ShaderInfo fragmentShaderInfo, bgfx::RendererType::Enum renderer);
+
+    // Runs the SPIRV-Tools performance passes (inlining, constant folding, dead code elimination, ...) over the
+    // SPIR-V of one stage. Does nothing unless ShaderCompiler::OPTIMIZE_SPIRV.
+    void OptimizeSpirv(std::vector<uint32_t>& spirv, ShaderCompiler::PhaseObserver* observer);
 }
@@ -15,8 +15,10 @@ namespace Babylon
 {
     namespace
     {
-        void AddShader(glslang::TProgram& program, glslang::TShader& shader, std::string_view source)
+        void AddShader(glslang::TProgram& program, glslang::TShader& shader, std::string_view source, ShaderCompiler::PhaseObserver* observer)
         {
+            ShaderCompilerCommon::PhaseScope scope{observer, ShaderCompiler::Phase::Parse};
+
             const std::array<const char*, 1> sources{source.data()};
             shader.setStrings(sources.data(), gsl::narrow_cast<int>(sources.size()));
 
@@ -28,24 +30,38 @@ namespace Babylon
             program.addShader(&shader);
         }
 
-        std::pair<std::unique_ptr<spirv_cross::Parser>, std::unique_ptr<spirv_cross::Compiler>> CompileShader(glslang::TProgram& program, EShLanguage stage, gsl::span<const spirv_cross::HLSLVertexAttributeRemap> attributes, ID3DBlob** blob)
+        std::pair<std::unique_ptr<spirv_cross::Parser>, std::unique_ptr<spirv_cross::Compiler>> CompileShader(glslang::TProgram& program, EShLanguage stage, gsl::span<const spirv_cross::HLSLVertexAttributeRemap> attributes, ID3DBlob** blob, ShaderCompiler::PhaseObserver* observer)
         {
             std::vector<uint32_t> spirv;
-            glslang::GlslangToSpv(*program.getIntermediate(stage), spirv);
+            {
+                ShaderCompilerCommon::PhaseScope scope{observer, ShaderCompiler::Phase::GlslangToSpv};
+                glslang::GlslangToSpv(*program.getIntermediate(stage), spirv);
+            }
 
-            auto parser = std::make_unique<spirv_cross::Parser>(std::move(spirv));
-            parser->parse();
+            ShaderCompilerCommon::OptimizeSpirv(spirv, observer);
 
-            auto compiler = std::make_unique<spirv_cross::CompilerHLSL>(parser->get_parsed_ir());
+            std::unique_ptr<spirv_cross::Parser> parser{};
+            std::unique_ptr<spirv_cross::CompilerHLSL> compiler{};
+            std::string hlsl{};
+            {
+                ShaderCompilerCommon::PhaseScope scope{observer, ShaderCompiler::Phase::SpirvCross};
 
-            compiler->set_hlsl_options({40, true});
+                parser = std::make_unique<spirv_cross::Parser>(std::move(spirv));
+                parser->parse();
 
-            for (const auto& attribute : attributes)
-            {
-                compiler->add_vertex_attribute_remap(attribute);
+                compiler = std::make_unique<spirv_cross::CompilerHLSL>(parser->get_parsed_ir());
+
+                compiler->set_hlsl_options({40, true});
+
+                for (const auto& attribute : attributes)
+                {
+                    compiler->add_vertex_attribute_remap(attribute);
+                }
+
+                hlsl = compiler->compile();
             }
 
-            std::string hlsl = compiler->compile();
+            ShaderCompilerCommon::PhaseScope scope{observer, ShaderCompiler::Phase::D3DCompile};
 
             Microsoft::WRL::ComPtr<ID3DBlob> errorMsgs;
             const char* target = stage == EShLangVertex ? "vs_4_0" : "ps_4_0";
@@ -65,42 +81,34 @@ namespace Babylon
         }
     }
 
-    ShaderCompiler::ShaderCompiler()
-    {
-        glslang::InitializeProcess();
-    }
-
-    ShaderCompiler::~ShaderCompiler()
-    {
-        glslang::FinalizeProcess();
-    }
-
-    ShaderCompiler::BgfxShaderInfo ShaderCompiler::Compile(std::string_view vertexSource, std::string_view fragmentSource)
+    ShaderCompiler::BgfxShaderInfo ShaderCompiler::CompileD3D(std::string_view vertexSource, std::string_view fragmentSource, PhaseObserver* observer)
     {
         glslang::TProgram program;
 
         glslang::TShader vertexShader{EShLangVertex};
-        AddShader(program, vertexShader, vertexSource);
+        AddShader(program, vertexShader, vertexSource, observer);
 
         glslang::TShader fragmentShader{EShLangFragment};
-        AddShader(program, fragmentShader, fragmentSource);
+        AddShader(program, fragmentShader, fragmentSource, observer);
 
         glslang::SpvVersion spv{};
         spv.spv = 0x10000;
         vertexShader.getIntermediate()->setSpv(spv);
         fragmentShader.getIntermediate()->setSpv(spv);
 
-        if (!program.link(EShMsgDefault))
-        {
-            throw std::runtime_error{program.getInfoDebugLog()};
-        }
+        ShaderCompilerCommon::RunPhase(observer, Phase::Link, [&] {
+            if (!program.link(EShMsgDefault))
+            {
+                throw std::runtime_error{program.getInfoDebugLog()};
+            }
+        });
 
         ShaderCompilerTraversers::IdGenerator ids{};
-        auto utstScope = ShaderCompilerTraversers::MoveNonSamplerUniformsIntoStruct(program, ids);
+        auto utstScope = ShaderCompilerCommon::RunPhase(observer, Phase::MoveNonSamplerUniformsIntoStruct, [&] { return ShaderCompilerTraversers::MoveNonSamplerUniformsIntoStruct(program, ids); });
         std::unordered_map<std::string, std::string> vertexAttributeRenaming = {};
-        ShaderCompilerTraversers::AssignLocationsAndNamesToVertexVaryings(program, ids, vertexAttributeRenaming);
-        ShaderCompilerTraversers::SplitSamplersIntoSamplersAndTextures(program, ids);
-        ShaderCompilerTraversers::InvertYDerivativeOperands(program);
+        ShaderCompilerCommon::RunPhase(observer, Phase::AssignLocationsAndNamesToVertexVaryings, [&] { ShaderCompilerTraversers::AssignLocationsAndNamesToVertexVaryings(program, ids, vertexAttributeRenaming, bgfx::RendererType::Direct3D11); });
+        ShaderCompilerCommon::RunPhase(observer, Phase::SplitSamplersIntoSamplersAndTextures, [&] { ShaderCompilerTraversers::SplitSamplersIntoSamplersAndTextures(program, ids); });
+        ShaderCompilerCommon::RunPhase(observer, Phase::InvertYDerivativeOperands, [&] { ShaderCompilerTraversers::InvertYDerivativeOperands(program); });
 
         // clang-format off
         static const spirv_cross::HLSLVertexAttributeRemap attributes[] = {
@@ -122,7 +130,7 @@ namespace Babylon
         // clang-format on
 
         Microsoft::WRL::ComPtr<ID3DBlob> vertexBlob;
-        auto [vertexParser, vertexCompiler] = CompileShader(program, EShLangVertex, attributes, &vertexBlob);
+        auto [vertexParser, vertexCompiler] = CompileShader(program, EShLangVertex, attributes, &vertexBlob, observer);
         ShaderCompilerCommon::ShaderInfo vertexShaderInfo{
             std::move(vertexParser),
             std::move(vertexCompiler),
@@ -130,13 +138,14 @@ namespace Babylon
             std::move(vertexAttributeRenaming)};
 
         Microsoft::WRL::ComPtr<ID3DBlob> fragmentBlob;
-        auto [fragmentParser, fragmentCompiler] = CompileShader(program, EShLangFragment, {}, &fragmentBlob);
+        auto [fragmentParser, fragmentCompiler] = CompileShader(program, EShLangFragment, {}, &fragmentBlob, observer);
         ShaderCompilerCommon::ShaderInfo fragmentShaderInfo{
             std::move(fragmentParser),
             std::move(fragmentCompiler),
             gsl::make_span(static_cast<uint8_t*>(fragmentBlob->GetBufferPointer()), fragmentBlob->GetBufferSize()),
             {}};
 
-        return ShaderCompilerCommon::CreateBgfxShader(std::move(vertexShaderInfo), std::move(fragmentShaderInfo));
+        ShaderCompilerCommon::PhaseScope scope{observer, Phase::CreateBgfxShader};
+        return ShaderCompilerCommon::CreateBgfxShader(std::move(vertexShaderInfo), std::move(fragmentShaderInfo), bgfx::RendererType::Direct3D11);
     }
 }
@@ -13,8 +13,10 @@ namespace Babylon
 {
     namespace
     {
-        void AddShader(glslang::TProgram& program, glslang::TShader& shader, std::string_view source)
+        void AddShader(glslang::TProgram& program, glslang::TShader& shader, std::string_view source, ShaderCompiler::PhaseObserver* observer)
         {
+            ShaderCompilerCommon::PhaseScope scope{observer, ShaderCompiler::Phase::Parse};
+
             const std::array<const char*, 1> sources{source.data()};
             shader.setStrings(sources.data(), gsl::narrow_cast<int>(sources.size()));
 
@@ -26,10 +28,17 @@ namespace Babylon
             program.addShader(&shader);
         }
 
-        std::pair<std::unique_ptr<spirv_cross::Parser>, std::unique_ptr<spirv_cross::Compiler>> CompileShader(glslang::TProgram& program, EShLanguage stage, std::string& shaderResult)
+        std::pair<std::unique_ptr<spirv_cross::Parser>, std::unique_ptr<spirv_cross::Compiler>> CompileShader(glslang::TProgram& program, EShLanguage stage, std::string& shaderResult, ShaderCompiler::PhaseObserver* observer)
         {
             std::vector<uint32_t> spirv;
-            glslang::GlslangToSpv(*program.getIntermediate(stage), spirv);
+            {
+                ShaderCompilerCommon::PhaseScope scope{observer, ShaderCompiler::Phase::GlslangToSpv};
+                glslang::GlslangToSpv(*program.getIntermediate(stage), spirv);
+            }
+
+            ShaderCompilerCommon::OptimizeSpirv(spirv, observer);
+
+            ShaderCompilerCommon::PhaseScope scope{observer, ShaderCompiler::Phase::SpirvCross};
 
             auto parser = std::make_unique<spirv_cross::Parser>(std::move(spirv));
             parser->parse();
@@ -79,52 +88,50 @@ namespace Babylon
 
 namespace Babylon
 {
-    ShaderCompiler::ShaderCompiler()
-    {
-        glslang::InitializeProcess();
-    }
-
-    ShaderCompiler::~ShaderCompiler()
-    {
-        glslang::FinalizeProcess();
-    }
-
-    ShaderCompiler::BgfxShaderInfo ShaderCompiler::Compile(std::string_view vertexSource, std::string_view fragmentSource)
+    ShaderCompiler::BgfxShaderInfo ShaderCompiler::CompileMetal(std::string_view vertexSource, std::string_view fragmentSource, PhaseObserver* observer)
     {
         glslang::TProgram program;
 
         glslang::TShader vertexShader{EShLangVertex};
-        AddShader(program, vertexShader, vertexSource);
+        AddShader(program, vertexShader, vertexSource, observer);
 
         glslang::TShader fragmentShader{EShLangFragment};
-        AddShader(program, fragmentShader, fragmentSource);
+        AddShader(program, fragmentShader, fragmentSource, observer);
 
         glslang::SpvVersion spv{};
         spv.spv = 0x10000;
         vertexShader.getIntermediate()->setSpv(spv);
         fragmentShader.getIntermediate()->setSpv(spv);
 
-        if (!program.link(EShMsgDefault))
-        {
-            throw std::exception();//program.getInfoDebugLog());
-        }
+        ShaderCompilerCommon::RunPhase(observer, Phase::Link, [&] {
+            if (!program.link(EShMsgDefault))
+            {
+                throw std::exception();//program.getInfoDebugLog());
+            }
+        });
 
         ShaderCompilerTraversers::IdGenerator ids{};
-        auto cutScope = ShaderCompilerTraversers::ChangeUniformTypes(program, ids);
-        auto utstScope = ShaderCompilerTraversers::MoveNonSamplerUniformsIntoStruct(program, ids);
+        std::unordered_map<std::string, PackedUniform> packedUniforms{};
+        ShaderCompilerCommon::RunPhase(observer, Phase::PackUniforms, [&] { ShaderCompilerTraversers::PackUniforms(program, ids, packedUniforms); });
+        auto cutScope = ShaderCompilerCommon::RunPhase(observer, Phase::ChangeUniformTypes, [&] { return ShaderCompilerTraversers::ChangeUniformTypes(program, ids); });
+        auto utstScope = ShaderCompilerCommon::RunPhase(observer, Phase::MoveNonSamplerUniformsIntoStruct, [&] { return ShaderCompilerTraversers::MoveNonSamplerUniformsIntoStruct(program, ids); });
         std::unordered_map<std::string, std::string> vertexAttributeRenaming = {};
-        ShaderCompilerTraversers::AssignLocationsAndNamesToVertexVaryings(program, ids, vertexAttributeRenaming);
-        ShaderCompilerTraversers::SplitSamplersIntoSamplersAndTextures(program, ids);
-        ShaderCompilerTraversers::InvertYDerivativeOperands(program);
+        ShaderCompilerCommon::RunPhase(observer, Phase::AssignLocationsAndNamesToVertexVaryings, [&] { ShaderCompilerTraversers::AssignLocationsAndNamesToVertexVaryings(program, ids, vertexAttributeRenaming, bgfx::RendererType::Metal); });
+        ShaderCompilerCommon::RunPhase(observer, Phase::SplitSamplersIntoSamplersAndTextures, [&] { ShaderCompilerTraversers::SplitSamplersIntoSamplersAndTextures(program, ids); });
+        ShaderCompilerCommon::RunPhase(observer, Phase::InvertYDerivativeOperands, [&] { ShaderCompilerTraversers::InvertYDerivativeOperands(program); });
 
         std::string vertexGLSL(vertexSource.data(), vertexSource.size());
-        auto [vertexParser, vertexCompiler] = CompileShader(program, EShLangVertex, vertexGLSL);
+        auto [vertexParser, vertexCompiler] = CompileShader(program, EShLangVertex, vertexGLSL, observer);
 
         std::string fragmentGLSL(fragmentSource.data(), fragmentSource.size());
-        auto [fragmentParser, fragmentCompiler] = CompileShader(program, EShLangFragment, fragmentGLSL);
+        auto [fragmentParser, fragmentCompiler] = CompileShader(program, EShLangFragment, fragmentGLSL, observer);
 
-        return ShaderCompilerCommon::CreateBgfxShader(
+        ShaderCompilerCommon::PhaseScope scope{observer, Phase::CreateBgfxShader};
+        auto shaderInfo = ShaderCompilerCommon::CreateBgfxShader(
             {std::move(vertexParser), std::move(vertexCompiler), gsl::make_span(reinterpret_cast<uint8_t*>(vertexGLSL.data()), vertexGLSL.size()), std::move(vertexAttributeRenaming)},
-            {std::move(fragmentParser), std::move(fragmentCompiler), gsl::make_span(reinterpret_cast<uint8_t*>(fragmentGLSL.data()), fragmentGLSL.size()), {}});
+            {std::move(fragmentParser), std::move(fragmentCompiler), gsl::make_span(reinterpret_cast<uint8_t*>(fragmentGLSL.data()), fragmentGLSL.size()), {}},
+            bgfx::RendererType::Metal);
+        shaderInfo.PackedUniforms = std::move(packedUniforms);
+        return shaderInfo;
     }
 }
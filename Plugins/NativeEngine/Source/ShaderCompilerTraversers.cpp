@@ -11,6 +11,7 @@
 
 #include <gsl/gsl>
 
+#include <algorithm>
 #include <stdexcept>
 #include <arcana/macros.h>
 
@@ -21,55 +22,63 @@ namespace Babylon::ShaderCompilerTraversers
     /// The purpose of everything in this namespace is to modify the glslang abstract
     /// syntax tree generated by parsing Babylon.js shaders so that those shaders
     /// can be recompiled to target native shader languages such as DirectX, OpenGL,
-    /// and Metal.
+    /// Metal, and Vulkan.
     namespace
     {
-        /// Helper method to replace symbols in a glslang AST. This operation is done
-        /// by several of the traversers in this file.
-        /// @param nameToReplacement Map from symbol names to the node which should replace that symbol.
-        /// @param symbolToParent Vector of symbols to be replaced along with their parents in the AST.
-        void makeReplacements(
-            std::map<std::string, TIntermTyped*> nameToReplacement,
-            std::vector<std::pair<TIntermSymbol*, TIntermNode*>> symbolToParent)
+        /// Helper method to replace a node in a glslang AST.
+        /// @param node The node to be replaced.
+        /// @param parent The parent of the node in the AST.
+        /// @param replacement The node which should replace it.
+        void makeReplacement(TIntermTyped* node, TIntermNode* parent, TIntermTyped* replacement)
         {
-            for (const auto& [symbol, parent] : symbolToParent)
+            if (auto* aggregate = parent->getAsAggregate())
             {
-                auto* replacement = nameToReplacement[symbol->getName().c_str()];
-                if (auto* aggregate = parent->getAsAggregate())
+                auto& sequence = aggregate->getSequence();
+                for (size_t idx = 0; idx < sequence.size(); ++idx)
                 {
-                    auto& sequence = aggregate->getSequence();
-                    for (size_t idx = 0; idx < sequence.size(); ++idx)
+                    if (sequence[idx] == node)
                     {
-                        if (sequence[idx] == symbol)
-                        {
-                            RemoveAllTreeNodes(sequence[idx]);
-                            sequence[idx] = replacement;
-                        }
+                        RemoveAllTreeNodes(sequence[idx]);
+                        sequence[idx] = replacement;
                     }
                 }
-                else if (auto* binary = parent->getAsBinaryNode())
-                {
-                    if (binary->getLeft() == symbol)
-                    {
-                        RemoveAllTreeNodes(binary->getLeft());
-                        binary->setLeft(replacement);
-                    }
-                    else
-                    {
-                        RemoveAllTreeNodes(binary->getRight());
-                        binary->setRight(replacement);
-                    }
-                }
-                else if (auto* unary = parent->getAsUnaryNode())
+            }
+            else if (auto* binary = parent->getAsBinaryNode())
+            {
+                if (binary->getLeft() == node)
                 {
-                    RemoveAllTreeNodes(unary->getOperand());
-                    unary->setOperand(replacement);
+                    RemoveAllTreeNodes(binary->getLeft());
+                    binary->setLeft(replacement);
                 }
                 else
                 {
-                    throw std::runtime_error{"Cannot replace symbol: node type handler unimplemented"};
+                    RemoveAllTreeNodes(binary->getRight());
+                    binary->setRight(replacement);
                 }
             }
+            else if (auto* unary = parent->getAsUnaryNode())
+            {
+                RemoveAllTreeNodes(unary->getOperand());
+                unary->setOperand(replacement);
+            }
+            else
+            {
+                throw std::runtime_error{"Cannot replace symbol: node type handler unimplemented"};
+            }
+        }
+
+        /// Helper method to replace symbols in a glslang AST. This operation is done
+        /// by several of the traversers in this file.
+        /// @param nameToReplacement Map from symbol names to the node which should replace that symbol.
+        /// @param symbolToParent Vector of symbols to be replaced along with their parents in the AST.
+        void makeReplacements(
+            std::map<std::string, TIntermTyped*> nameToReplacement,
+            std::vector<std::pair<TIntermSymbol*, TIntermNode*>> symbolToParent)
+        {
+            for (const auto& [symbol, parent] : symbolToParent)
+            {
+                makeReplacement(symbol, parent, nameToReplacement[symbol->getName().c_str()]);
+            }
         }
 
         /// Helper method to determine whether an element in the AST is a linker object,
@@ -82,6 +91,80 @@ namespace Babylon::ShaderCompilerTraversers
             return agg && agg->getOp() == EOpLinkerObjects;
         }
 
+        /// Vulkan GLSL only allows non-sampler uniforms outside of a block under glslang's
+        /// relaxed Vulkan rules, which gather them into a default uniform block while parsing.
+        /// This traverser turns the members of that block back into the individual uniforms
+        /// the other traversers expect, so that Vulkan goes through the same uniform handling
+        /// as the other platforms.
+        class DefaultUniformBlockTraverser final : private TIntermTraverser
+        {
+        public:
+            static void Traverse(TProgram& program, IdGenerator& ids)
+            {
+                Traverse(program.getIntermediate(EShLangVertex), ids);
+                Traverse(program.getIntermediate(EShLangFragment), ids);
+            }
+
+        private:
+            static bool isDefaultUniformBlock(const TType& type)
+            {
+                return type.getBasicType() == EbtBlock && type.getTypeName() == DEFAULT_UNIFORM_BLOCK_NAME;
+            }
+
+            virtual bool visitBinary(TVisit, TIntermBinary* binary) override
+            {
+                // Collect every read of a member of the default uniform block.
+                auto* symbol = binary->getLeft()->getAsSymbolNode();
+                if (binary->getOp() == EOpIndexDirectStruct && symbol != nullptr && isDefaultUniformBlock(symbol->getType()))
+                {
+                    m_membersToParents.emplace_back(binary, this->getParentNode());
+                    return false;
+                }
+
+                return true;
+            }
+
+            static void Traverse(TIntermediate* intermediate, IdGenerator& ids)
+            {
+                auto* linkerObjectAggregate = intermediate->getTreeRoot()->getAsAggregate()->getSequence().back()->getAsAggregate();
+                assert(linkerObjectAggregate->getOp() == EOpLinkerObjects);
+                auto& linkerObjects = linkerObjectAggregate->getSequence();
+                const auto block = std::find_if(linkerObjects.begin(), linkerObjects.end(), [](TIntermNode* node) {
+                    auto* symbol = node->getAsSymbolNode();
+                    return symbol != nullptr && isDefaultUniformBlock(symbol->getType());
+                });
+
+                if (block == linkerObjects.end())
+                {
+                    return;
+                }
+
+                DefaultUniformBlockTraverser traverser{};
+                intermediate->getTreeRoot()->traverse(&traverser);
+
+                // One uniform per member, with the member's type and name.
+                const TType& blockType = (*block)->getAsSymbolNode()->getType();
+                std::vector<TIntermSymbol*> uniforms{};
+                for (int idx = 0; idx < gsl::narrow_cast<int>(blockType.getStruct()->size()); ++idx)
+                {
+                    TType memberType{blockType, idx};
+                    memberType.getQualifier().storage = EvqUniform;
+                    uniforms.push_back(intermediate->addSymbol(TIntermSymbol{ids.Next(), memberType.getFieldName(), memberType}));
+                }
+
+                for (const auto& [member, parent] : traverser.m_membersToParents)
+                {
+                    const int idx = member->getRight()->getAsConstantUnion()->getConstArray()[0].getIConst();
+                    makeReplacement(member, parent, intermediate->addSymbol(*uniforms[idx]));
+                }
+
+                linkerObjects.erase(block);
+                linkerObjects.insert(linkerObjects.end(), uniforms.begin(), uniforms.end());
+            }
+
+            std::vector<std::pair<TIntermBinary*, TIntermNode*>> m_membersToParents{};
+        };
+
         /// This traverser collects all non-sampler uniforms and creates a new struct
         /// called "Frame" to contain them. This is necessary to correctly transpile
         /// for DirectX and Metal.
@@ -253,6 +336,156 @@ namespace Babylon::ShaderCompilerTraversers
             std::vector<std::pair<TIntermSymbol*, TIntermNode*>> m_symbolsToParents{};
         };
 
+        /// Packs the float, vec2, and vec3 uniforms read by the shaders into shared vec4 uniforms.
+        /// The layout is computed over both stages so that a packed uniform holds the same values
+        /// whichever stage reads it.
+        class UniformPackingTraverser final : private TIntermTraverser
+        {
+        public:
+            static void Traverse(TProgram& program, IdGenerator& ids, std::unordered_map<std::string, ShaderCompiler::PackedUniform>& packedUniforms)
+            {
+                UniformPackingTraverser vertexTraverser{};
+                program.getIntermediate(EShLangVertex)->getTreeRoot()->traverse(&vertexTraverser);
+
+                UniformPackingTraverser fragmentTraverser{};
+                program.getIntermediate(EShLangFragment)->getTreeRoot()->traverse(&fragmentTraverser);
+
+                // Linking guarantees that a uniform declared by both stages has the same type in both.
+                std::map<std::string, uint8_t> sizes{vertexTraverser.m_uniformNameToSize};
+                sizes.insert(fragmentTraverser.m_uniformNameToSize.begin(), fragmentTraverser.m_uniformNameToSize.end());
+
+                packedUniforms = ComputeLayout(sizes);
+
+                vertexTraverser.Pack(program.getIntermediate(EShLangVertex), ids, packedUniforms);
+                fragmentTraverser.Pack(program.getIntermediate(EShLangFragment), ids, packedUniforms);
+            }
+
+        private:
+            virtual void visitSymbol(TIntermSymbol* symbol) override
+            {
+                // Only uniforms which are actually read are collected; the declarations of the others are left alone.
+                const auto& type = symbol->getType();
+                if (type.getQualifier().storage == EvqUniform && type.getBasicType() == EbtFloat &&
+                    !type.isMatrix() && !type.isArray() && type.getVectorSize() < 4 && !isLinkerObject(this->path))
+                {
+                    m_uniformNameToSize[symbol->getName().c_str()] = static_cast<uint8_t>(type.getVectorSize());
+                    m_uniformNameToPrecision[symbol->getName().c_str()] = type.getQualifier().precision;
+                    m_symbolsToParents.emplace_back(symbol, this->getParentNode());
+                }
+            }
+
+            /// Places the biggest uniforms first, each in the first register with enough free components,
+            /// since a uniform must not straddle two registers.
+            static std::unordered_map<std::string, ShaderCompiler::PackedUniform> ComputeLayout(const std::map<std::string, uint8_t>& sizes)
+            {
+                std::vector<std::pair<std::string, uint8_t>> uniforms{sizes.begin(), sizes.end()};
+                std::stable_sort(uniforms.begin(), uniforms.end(), [](const auto& left, const auto& right) { return left.second > right.second; });
+
+                std::unordered_map<std::string, ShaderCompiler::PackedUniform> layout{};
+                std::vector<uint8_t> registerSizes{};
+                for (const auto& [name, size] : uniforms)
+                {
+                    size_t index = 0;
+                    while (index < registerSizes.size() && registerSizes[index] + size > 4)
+                    {
+                        ++index;
+                    }
+
+                    if (index == registerSizes.size())
+                    {
+                        registerSizes.push_back(0);
+                    }
+
+                    layout[name] = {"packedUniform" + std::to_string(index), registerSizes[index], size};
+                    registerSizes[index] = static_cast<uint8_t>(registerSizes[index] + size);
+                }
+
+                return layout;
+            }
+
+            void Pack(TIntermediate* intermediate, IdGenerator& ids, const std::unordered_map<std::string, ShaderCompiler::PackedUniform>& packedUniforms)
+            {
+                if (m_symbolsToParents.empty())
+                {
+                    return;
+                }
+
+                TSourceLoc loc{};
+                loc.init();
+
+                // Create one symbol per register read by this stage. Every read gets its own copy of the
+                // symbol node, as the parser would have done, since later traversers rewrite nodes in place.
+                std::map<std::string, TIntermSymbol*> registerNameToSymbol{};
+                for (const auto& entry : m_uniformNameToSize)
+                {
+                    const auto& registerName = packedUniforms.at(entry.first).Register;
+                    if (registerNameToSymbol.find(registerName) == registerNameToSymbol.end())
+                    {
+                        TPublicType publicType{};
+                        publicType.qualifier.clearLayout();
+                        publicType.qualifier.storage = EvqUniform;
+                        publicType.qualifier.precision = EpqHigh;
+                        publicType.basicType = EbtFloat;
+                        publicType.setVector(4);
+
+                        registerNameToSymbol[registerName] = intermediate->addSymbol(TIntermSymbol{ids.Next(), registerName.c_str(), TType{publicType}});
+                    }
+                }
+
+                // Replace every read of a packed uniform with a read of its components of the register.
+                for (const auto& [symbol, parent] : m_symbolsToParents)
+                {
+                    const std::string name{symbol->getName().c_str()};
+                    const auto& packed = packedUniforms.at(name);
+                    const auto precision = m_uniformNameToPrecision[name];
+
+                    auto* base = intermediate->addSymbol(*registerNameToSymbol.at(packed.Register));
+                    TIntermTyped* replacement{};
+                    if (packed.Size == 1)
+                    {
+                        replacement = intermediate->addIndex(EOpIndexDirect, base, intermediate->addConstantUnion(static_cast<int>(packed.Offset), loc), loc);
+                        replacement->setType(TType{EbtFloat, EvqTemporary, precision});
+                    }
+                    else
+                    {
+                        TSwizzleSelectors<TVectorSelector> selectors{};
+                        for (int component = 0; component < packed.Size; ++component)
+                        {
+                            selectors.push_back(packed.Offset + component);
+                        }
+
+                        replacement = intermediate->addIndex(EOpVectorSwizzle, base, intermediate->addSwizzle(selectors, loc), loc);
+                        replacement->setType(TType{EbtFloat, EvqTemporary, precision, packed.Size});
+                    }
+
+                    makeReplacements({{name, replacement}}, {{symbol, parent}});
+                }
+
+                // Swap the linker objects of the packed uniforms for the registers.
+                auto* linkerObjectAggregate = intermediate->getTreeRoot()->getAsAggregate()->getSequence().back()->getAsAggregate();
+                assert(linkerObjectAggregate->getOp() == EOpLinkerObjects);
+                auto& sequence = linkerObjectAggregate->getSequence();
+                for (int idx = gsl::narrow_cast<int>(sequence.size()) - 1; idx >= 0; --idx)
+                {
+                    auto* symbol = sequence[idx]->getAsSymbolNode();
+                    if (symbol && m_uniformNameToSize.find(symbol->getName().c_str()) != m_uniformNameToSize.end())
+                    {
+                        RemoveAllTreeNodes(symbol);
+                        sequence.erase(sequence.begin() + idx);
+                    }
+                }
+
+                for (const auto& entry : registerNameToSymbol)
+                {
+                    sequence.insert(sequence.begin(), entry.second);
+                }
+            }
+
+            std::map<std::string, uint8_t> m_uniformNameToSize{};
+            std::map<std::string, TPrecisionQualifier> m_uniformNameToPrecision{};
+            std::vector<std::pair<TIntermSymbol*, TIntermNode*>> m_symbolsToParents{};
+        };
+
         /// Changes the types of all float, vec2, and vec3 uniforms to vec4. This is required
         /// for OpenGL and Metal.
         class UniformTypeChangeTraverser final : private TIntermTraverser
@@ -417,16 +650,21 @@ namespace Babylon::ShaderCompilerTraversers
 
         /// This traverser modifies all vertex attributes (position, UV, etc.) to conform to
         /// bgfx's expectations regarding name and location. It is currently required for
-        /// DirectX, OpenGL, and Metal.
+        /// DirectX, OpenGL, Metal, and Vulkan.
         class VertexVaryingInTraverser final : private TIntermTraverser
         {
         public:
-            static void Traverse(TProgram& program, IdGenerator& ids, std::unordered_map<std::string, std::string>& replacementToOriginalName)
+            static void Traverse(TProgram& program, IdGenerator& ids, std::unordered_map<std::string, std::string>& replacementToOriginalName, bgfx::RendererType::Enum renderer)
             {
-                Traverse(program.getIntermediate(EShLangVertex), ids, replacementToOriginalName);
+                Traverse(program.getIntermediate(EShLangVertex), ids, replacementToOriginalName, renderer);
             }
 
         private:
+            explicit VertexVaryingInTraverser(bgfx::RendererType::Enum renderer)
+                : m_packAttributes{renderer == bgfx::RendererType::OpenGL || renderer == bgfx::RendererType::OpenGLES || renderer == bgfx::RendererType::Metal}
+            {
+            }
+
             virtual void visitSymbol(TIntermSymbol* symbol) override
             {
                 // Collect all vertex attributes, described by glslang as "varyings."
@@ -448,7 +686,6 @@ namespace Babylon::ShaderCompilerTraversers
                 }
             }
 
-#if __APPLE__ || APIOpenGL
             // This table is a copy of the table bgfx uses for vertex attribute -> shader symbol association.
             // copied from renderer_gl.cpp.
             constexpr static const char* s_attribName[] =
@@ -473,22 +710,22 @@ namespace Babylon::ShaderCompilerTraversers
                 "a_texcoord7",
             };
             BX_STATIC_ASSERT(bgfx::Attrib::Count == BX_COUNTOF(s_attribName));
-#endif
 
             std::pair<unsigned int, const char*> GetVaryingLocationAndNewNameForName(const char* name)
             {
-#if __APPLE__ || APIOpenGL
-                // For OpenGL and Metal platforms, we have an issue where we have a hard limit on the number shader attributes supported.
-                // To work around this issue, instead of mapping our attributes to the most similar bgfx::attribute, instead replace
-                // the first attribute encountered with the symbol bgfx uses for attribute 0 and increment for each subsequent attribute encountered.
-                // This will cause our shader to have nonsensical naming, but will allow us to efficiently "pack" the attributes.
-                UNUSED(name);
-                m_genericAttributesRunningCount++;
-                if (m_genericAttributesRunningCount >= static_cast<unsigned int>(bgfx::Attrib::Count))
-                    throw std::runtime_error("Cannot support more than 18 vertex attributes.");
+                if (m_packAttributes)
+                {
+                    // For OpenGL and Metal platforms, we have an issue where we have a hard limit on the number shader attributes supported.
+                    // To work around this issue, instead of mapping our attributes to the most similar bgfx::attribute, instead replace
+                    // the first attribute encountered with the symbol bgfx uses for attribute 0 and increment for each subsequent attribute encountered.
+                    // This will cause our shader to have nonsensical naming, but will allow us to efficiently "pack" the attributes.
+                    m_genericAttributesRunningCount++;
+                    if (m_genericAttributesRunningCount >= static_cast<unsigned int>(bgfx::Attrib::Count))
+                        throw std::runtime_error("Cannot support more than 18 vertex attributes.");
+
+                    return {static_cast<unsigned int>(m_genericAttributesRunningCount-1), s_attribName[static_cast<unsigned int>(m_genericAttributesRunningCount-1)]};
+                }
 
-                return {static_cast<unsigned int>(m_genericAttributesRunningCount-1), s_attribName[static_cast<unsigned int>(m_genericAttributesRunningCount-1)]};
-#else
 #define IF_NAME_RETURN_ATTRIB(varyingName, attrib, newName)  \
     if (std::strcmp(name, varyingName) == 0)                 \
     {                                                        \
@@ -509,12 +746,11 @@ namespace Babylon::ShaderCompilerTraversers
                 if (attributeLocation >= static_cast<unsigned int>(bgfx::Attrib::Count))
                     throw std::runtime_error("Cannot support more than 18 vertex attributes.");
                 return {attributeLocation, name};
-#endif
             }
 
-            static void Traverse(TIntermediate* intermediate, IdGenerator& ids, std::unordered_map<std::string, std::string>& replacementToOriginalName)
+            static void Traverse(TIntermediate* intermediate, IdGenerator& ids, std::unordered_map<std::string, std::string>& replacementToOriginalName, bgfx::RendererType::Enum renderer)
             {
-                VertexVaryingInTraverser traverser{};
+                VertexVaryingInTraverser traverser{renderer};
                 intermediate->getTreeRoot()->traverse(&traverser);
 
                 std::map<std::string, TIntermTyped*> originalNameToReplacement{};
@@ -525,18 +761,20 @@ namespace Babylon::ShaderCompilerTraversers
                 TPublicType publicType{};
                 publicType.qualifier.clearLayout();
 
-#if !(__APPLE__ || APIOpenGL)
-                // UVs are effectively a special kind of generic attribute since they both use
-                // are implemented using texture coordinates, so we preprocess to pre-count the
-                // number of UV coordinate variables to prevent collisions.
-                for (const auto& [name, symbol] : traverser.m_varyingNameToSymbol)
+                if (!traverser.m_packAttributes)
                 {
-                    if (name.size() >= 2 && name[0] == 'u' && name[1] == 'v')
+                    // UVs are effectively a special kind of generic attribute since they both use
+                    // are implemented using texture coordinates, so we preprocess to pre-count the
+                    // number of UV coordinate variables to prevent collisions.
+                    for (const auto& [name, symbol] : traverser.m_varyingNameToSymbol)
                     {
-                        traverser.m_genericAttributesRunningCount++;
+                        if (name.size() >= 2 && name[0] == 'u' && name[1] == 'v')
+                        {
+                            traverser.m_genericAttributesRunningCount++;
+                        }
                     }
                 }
-#endif
+
                 // Create the new symbols with which to replace all of the original varying
                 // symbols. The primary purpose of these new symbols is to contain the required
                 // name and location.
@@ -568,14 +806,92 @@ namespace Babylon::ShaderCompilerTraversers
 
                 makeReplacements(originalNameToReplacement, traverser.m_symbolsToParents);
             }
-# if !(__APPLE__ || APIOpenGL)
             const unsigned int FIRST_GENERIC_ATTRIBUTE_LOCATION{10};
-# endif
+            const bool m_packAttributes{};
             unsigned int m_genericAttributesRunningCount{0};
             std::map<std::string, TIntermSymbol*> m_varyingNameToSymbol{};
             std::vector<std::pair<TIntermSymbol*, TIntermNode*>> m_symbolsToParents{};
         };
 
+        /// This traverser gives every vertex output, fragment input and fragment output that
+        /// does not have one an explicit location. Vulkan requires these, and matches the
+        /// outputs of one stage to the inputs of the next by location rather than by name,
+        /// so varyings are numbered in name order across both stages.
+        class VaryingLocationTraverser final : private TIntermTraverser
+        {
+        public:
+            static void Traverse(TProgram& program)
+            {
+                auto* vertexIntermediate = program.getIntermediate(EShLangVertex);
+                auto* fragmentIntermediate = program.getIntermediate(EShLangFragment);
+
+                VaryingLocationTraverser vertexOutputs{EvqVaryingOut};
+                vertexIntermediate->getTreeRoot()->traverse(&vertexOutputs);
+
+                VaryingLocationTraverser fragmentInputs{EvqVaryingIn};
+                fragmentIntermediate->getTreeRoot()->traverse(&fragmentInputs);
+
+                VaryingLocationTraverser fragmentOutputs{EvqVaryingOut};
+                fragmentIntermediate->getTreeRoot()->traverse(&fragmentOutputs);
+
+                std::map<std::string, int> varyingSizes{};
+                for (const auto& [name, symbols] : vertexOutputs.m_nameToSymbols)
+                {
+                    varyingSizes[name] = TIntermediate::computeTypeLocationSize(symbols.front()->getType(), EShLangVertex);
+                }
+                for (const auto& [name, symbols] : fragmentInputs.m_nameToSymbols)
+                {
+                    varyingSizes.emplace(name, TIntermediate::computeTypeLocationSize(symbols.front()->getType(), EShLangFragment));
+                }
+
+                int location = 0;
+                for (const auto& [name, size] : varyingSizes)
+                {
+                    vertexOutputs.SetLocation(name, location);
+                    fragmentInputs.SetLocation(name, location);
+                    location += size;
+                }
+
+                location = 0;
+                for (const auto& [name, symbols] : fragmentOutputs.m_nameToSymbols)
+                {
+                    fragmentOutputs.SetLocation(name, location);
+                    location += TIntermediate::computeTypeLocationSize(symbols.front()->getType(), EShLangFragment);
+                }
+            }
+
+        private:
+            VaryingLocationTraverser(TStorageQualifier storage)
+                : m_storage{storage}
+            {
+            }
+
+            virtual void visitSymbol(TIntermSymbol* symbol) override
+            {
+                const auto& qualifier = symbol->getType().getQualifier();
+                if (qualifier.storage == m_storage && !qualifier.hasLocation())
+                {
+                    // Every occurrence carries its own copy of the type, so all of them are collected.
+                    m_nameToSymbols[symbol->getName().c_str()].push_back(symbol);
+                }
+            }
+
+            void SetLocation(const std::string& name, int location)
+            {
+                const auto found = m_nameToSymbols.find(name);
+                if (found != m_nameToSymbols.end())
+                {
+                    for (auto* symbol : found->second)
+                    {
+                        symbol->getWritableType().getQualifier().layoutLocation = location;
+                    }
+                }
+            }
+
+            const TStorageQualifier m_storage;
+            std::map<std::string, std::vector<TIntermSymbol*>> m_nameToSymbols{};
+        };
+
         /// <summary>
         /// Split sampler symbols into separate sampler and texture symbols. This is
         /// required for DirectX, OpenGL, and Metal.
@@ -755,14 +1071,29 @@ namespace Babylon::ShaderCompilerTraversers
         return NonSamplerUniformToStructTraverser::Traverse(program, ids);
     }
 
+    void PackUniforms(TProgram& program, IdGenerator& ids, std::unordered_map<std::string, ShaderCompiler::PackedUniform>& packedUniforms)
+    {
+        UniformPackingTraverser::Traverse(program, ids, packedUniforms);
+    }
+
+    void ExpandDefaultUniformBlock(TProgram& program, IdGenerator& ids)
+    {
+        DefaultUniformBlockTraverser::Traverse(program, ids);
+    }
+
     ScopeT ChangeUniformTypes(TProgram& program, IdGenerator& ids)
     {
         return UniformTypeChangeTraverser::Traverse(program, ids);
     }
 
-    void AssignLocationsAndNamesToVertexVaryings(TProgram& program, IdGenerator& ids, std::unordered_map<std::string, std::string>& replacementToOriginalName)
+    void AssignLocationsAndNamesToVertexVaryings(TProgram& program, IdGenerator& ids, std::unordered_map<std::string, std::string>& replacementToOriginalName, bgfx::RendererType::Enum renderer)
+    {
+        VertexVaryingInTraverser::Traverse(program, ids, replacementToOriginalName, renderer);
+    }
+
+    void AssignLocationsToVaryingsAndFragmentOutputs(TProgram& program)
     {
-        VertexVaryingInTraverser::Traverse(program, ids, replacementToOriginalName);
+        VaryingLocationTraverser::Traverse(program);
     }
 
     void SplitSamplersIntoSamplersAndTextures(TProgram& program, IdGenerator& ids)
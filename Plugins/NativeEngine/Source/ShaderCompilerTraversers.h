@@ -1,5 +1,7 @@
 #pragma once
 
+#include "ShaderCompiler.h"
+
 #include <glslang/Public/ShaderLang.h>
 
 #include <memory>
@@ -60,14 +62,40 @@ namespace Babylon::ShaderCompilerTraversers
     ///     }
     ScopeT MoveNonSamplerUniformsIntoStruct(glslang::TProgram& program, IdGenerator& ids);
 
+    /// Packs the float, vec2 and vec3 uniforms read by either stage into as few shared vec4 uniforms
+    /// as possible, so that they take a register each instead of a vec4 each. Thus, if the shaders use
+    ///
+    ///     float alpha;
+    ///     vec3 color;
+    ///
+    /// then both are replaced with a single vec4 uniform, and reads of alpha and color with reads of
+    /// its w and xyz components. Both stages get the same layout, which is returned in packedUniforms.
+    /// Must run before ChangeUniformTypes.
+    void PackUniforms(glslang::TProgram& program, IdGenerator& ids, std::unordered_map<std::string, ShaderCompiler::PackedUniform>& packedUniforms);
+
+    /// The name of the block glslang gathers loose non-sampler uniforms into when parsing
+    /// with relaxed Vulkan rules.
+    constexpr const char* DEFAULT_UNIFORM_BLOCK_NAME{"gl_DefaultUniformBlock"};
+
+    /// Turns the members of the default uniform block back into individual uniforms. Needed
+    /// for Vulkan, whose shaders are parsed with relaxed Vulkan rules; must run before all
+    /// of the other uniform changes.
+    void ExpandDefaultUniformBlock(glslang::TProgram& program, IdGenerator& ids);
+
     /// Performs all changes to uniform types required by platforms that need changes.
     /// This is needed for Metal and OpenGL (not DirectX) to match bgfx's expectations
     /// that all uniforms, even scalars, are implemented as vec4 uniforms.
     ScopeT ChangeUniformTypes(glslang::TProgram& program, IdGenerator& ids);
 
     /// Changes the names and locations of varying attributes in the vertex shader to
-    /// match bgfx's expectations.
-    void AssignLocationsAndNamesToVertexVaryings(glslang::TProgram& program, IdGenerator& ids, std::unordered_map<std::string, std::string>& vertexAttributeRenaming);
+    /// match bgfx's expectations for the given renderer. OpenGL and Metal get the
+    /// attributes packed into consecutive bgfx attribute slots.
+    void AssignLocationsAndNamesToVertexVaryings(glslang::TProgram& program, IdGenerator& ids, std::unordered_map<std::string, std::string>& vertexAttributeRenaming, bgfx::RendererType::Enum renderer);
+
+    /// Gives the vertex outputs, fragment inputs and fragment outputs explicit locations,
+    /// consistent between the two stages. This is needed for Vulkan, which links stages by
+    /// location only.
+    void AssignLocationsToVaryingsAndFragmentOutputs(glslang::TProgram& program);
 
     /// WebGL (and therefore Babylon.js) treats texture samplers as a single variable.
     /// Native platforms expect them to be two separate variables -- a texture and a
@@ -0,0 +1,151 @@
+#include "ShaderCompiler.h"
+#include "ShaderCompilerCommon.h"
+#include "ShaderCompilerTraversers.h"
+#include "ResourceLimits.h"
+#include <arcana/experimental/array.h>
+#include <bgfx/bgfx.h>
+#include <glslang/Public/ShaderLang.h>
+#include <SPIRV/GlslangToSpv.h>
+#include <spirv_parser.hpp>
+#include <spirv_cross.hpp>
+
+namespace Babylon
+{
+    extern const TBuiltInResource DefaultTBuiltInResource;
+
+    namespace
+    {
+        void AddShader(glslang::TProgram& program, glslang::TShader& shader, std::string_view source, ShaderCompiler::PhaseObserver* observer)
+        {
+            ShaderCompilerCommon::PhaseScope scope{observer, ShaderCompiler::Phase::Parse};
+
+            const std::array<const char*, 1> sources{source.data()};
+            shader.setStrings(sources.data(), gsl::narrow_cast<int>(sources.size()));
+
+            // Parsing for Vulkan gives the shader the builtins and semantics of the Vulkan environment. The relaxed
+            // rules accept the loose uniforms of Babylon.js shaders, and locations and bindings are left to the
+            // traversers, which assign them after linking.
+            shader.setEnvInput(glslang::EShSourceGlsl, shader.getStage(), glslang::EShClientVulkan, 100);
+            shader.setEnvInputVulkanRulesRelaxed();
+            shader.setEnvClient(glslang::EShClientVulkan, glslang::EShTargetVulkan_1_0);
+            shader.setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_0);
+            shader.setGlobalUniformBlockName(ShaderCompilerTraversers::DEFAULT_UNIFORM_BLOCK_NAME);
+            shader.setAutoMapLocations(true);
+            shader.setAutoMapBindings(true);
+
+            if (!shader.parse(&DefaultTBuiltInResource, 310, EProfile::EEsProfile, true, true, EShMsgDefault))
+            {
+                throw std::runtime_error{shader.getInfoDebugLog()};
+            }
+
+            program.addShader(&shader);
+        }
+
+        void SetDecoration(std::vector<uint32_t>& spirv, const spirv_cross::Compiler& compiler, uint32_t id, spv::Decoration decoration, uint32_t value)
+        {
+            uint32_t wordOffset{};
+            if (!compiler.get_binary_offset_for_decoration(id, decoration, wordOffset))
+            {
+                throw std::runtime_error{"Shader resource is missing a decoration required by Vulkan."};
+            }
+
+            spirv[wordOffset] = value;
+        }
+
+        // Unlike the other backends, the SPIR-V itself is what bgfx gets, so the resources are moved to the
+        // bindings bgfx expects by patching their decorations in place. The reflection keeps the original
+        // decorations, which CreateBgfxShader turns into texture stages and attribute ids.
+        std::pair<std::unique_ptr<spirv_cross::Parser>, std::unique_ptr<spirv_cross::Compiler>> CompileShader(glslang::TProgram& program, EShLanguage stage, std::vector<uint32_t>& spirv, ShaderCompiler::PhaseObserver* observer)
+        {
+            {
+                ShaderCompilerCommon::PhaseScope scope{observer, ShaderCompiler::Phase::GlslangToSpv};
+                glslang::GlslangToSpv(*program.getIntermediate(stage), spirv);
+            }
+
+            ShaderCompilerCommon::OptimizeSpirv(spirv, observer);
+
+            ShaderCompilerCommon::PhaseScope scope{observer, ShaderCompiler::Phase::SpirvCross};
+
+            auto parser = std::make_unique<spirv_cross::Parser>(spirv);
+            parser->parse();
+
+            auto compiler = std::make_unique<spirv_cross::Compiler>(parser->get_parsed_ir());
+
+            const auto resources = compiler->get_shader_resources();
+            for (const auto& resource : resources.uniform_buffers)
+            {
+                const uint32_t binding{stage == EShLangVertex ? ShaderCompilerCommon::VULKAN_VERTEX_UNIFORM_BLOCK_BINDING : ShaderCompilerCommon::VULKAN_FRAGMENT_UNIFORM_BLOCK_BINDING};
+                SetDecoration(spirv, *compiler, resource.id, spv::DecorationBinding, binding);
+            }
+
+            for (const auto& resource : resources.separate_images)
+            {
+                const uint32_t textureStage{compiler->get_decoration(resource.id, spv::DecorationBinding)};
+                SetDecoration(spirv, *compiler, resource.id, spv::DecorationBinding, ShaderCompilerCommon::VULKAN_TEXTURE_BINDING_SHIFT + textureStage);
+            }
+
+            for (const auto& resource : resources.separate_samplers)
+            {
+                const uint32_t textureStage{compiler->get_decoration(resource.id, spv::DecorationBinding)};
+                SetDecoration(spirv, *compiler, resource.id, spv::DecorationBinding, ShaderCompilerCommon::VULKAN_TEXTURE_BINDING_SHIFT + ShaderCompilerCommon::VULKAN_SAMPLER_BINDING_SHIFT + textureStage);
+            }
+
+            // bgfx feeds the vertex attributes to the locations of their position in the attribute list of the shader,
+            // which CreateBgfxShader writes in the order of the stage inputs.
+            if (stage == EShLangVertex)
+            {
+                uint32_t location{0};
+                for (const auto& resource : resources.stage_inputs)
+                {
+                    SetDecoration(spirv, *compiler, resource.id, spv::DecorationLocation, location++);
+                }
+            }
+
+            return {std::move(parser), std::move(compiler)};
+        }
+    }
+
+    ShaderCompiler::BgfxShaderInfo ShaderCompiler::CompileVulkan(std::string_view vertexSource, std::string_view fragmentSource, PhaseObserver* observer)
+    {
+        glslang::TProgram program;
+
+        glslang::TShader vertexShader{EShLangVertex};
+        AddShader(program, vertexShader, vertexSource, observer);
+
+        glslang::TShader fragmentShader{EShLangFragment};
+        AddShader(program, fragmentShader, fragmentSource, observer);
+
+        ShaderCompilerCommon::RunPhase(observer, Phase::Link, [&] {
+            if (!program.link(EShMsgDefault))
+            {
+                throw std::runtime_error{program.getInfoDebugLog()};
+            }
+        });
+
+        ShaderCompilerTraversers::IdGenerator ids{};
+        ShaderCompilerCommon::RunPhase(observer, Phase::ExpandDefaultUniformBlock, [&] { ShaderCompilerTraversers::ExpandDefaultUniformBlock(program, ids); });
+        std::unordered_map<std::string, PackedUniform> packedUniforms{};
+        ShaderCompilerCommon::RunPhase(observer, Phase::PackUniforms, [&] { ShaderCompilerTraversers::PackUniforms(program, ids, packedUniforms); });
+        auto cutScope = ShaderCompilerCommon::RunPhase(observer, Phase::ChangeUniformTypes, [&] { return ShaderCompilerTraversers::ChangeUniformTypes(program, ids); });
+        auto utstScope = ShaderCompilerCommon::RunPhase(observer, Phase::MoveNonSamplerUniformsIntoStruct, [&] { return ShaderCompilerTraversers::MoveNonSamplerUniformsIntoStruct(program, ids); });
+        std::unordered_map<std::string, std::string> vertexAttributeRenaming = {};
+        ShaderCompilerCommon::RunPhase(observer, Phase::AssignLocationsAndNamesToVertexVaryings, [&] { ShaderCompilerTraversers::AssignLocationsAndNamesToVertexVaryings(program, ids, vertexAttributeRenaming, bgfx::RendererType::Vulkan); });
+        ShaderCompilerCommon::RunPhase(observer, Phase::AssignLocationsToVaryingsAndFragmentOutputs, [&] { ShaderCompilerTraversers::AssignLocationsToVaryingsAndFragmentOutputs(program); });
+        ShaderCompilerCommon::RunPhase(observer, Phase::SplitSamplersIntoSamplersAndTextures, [&] { ShaderCompilerTraversers::SplitSamplersIntoSamplersAndTextures(program, ids); });
+        ShaderCompilerCommon::RunPhase(observer, Phase::InvertYDerivativeOperands, [&] { ShaderCompilerTraversers::InvertYDerivativeOperands(program); });
+
+        std::vector<uint32_t> vertexSpirv{};
+        auto [vertexParser, vertexCompiler] = CompileShader(program, EShLangVertex, vertexSpirv, observer);
+
+        std::vector<uint32_t> fragmentSpirv{};
+        auto [fragmentParser, fragmentCompiler] = CompileShader(program, EShLangFragment, fragmentSpirv, observer);
+
+        ShaderCompilerCommon::PhaseScope scope{observer, Phase::CreateBgfxShader};
+        auto shaderInfo = ShaderCompilerCommon::CreateBgfxShader(
+            {std::move(vertexParser), std::move(vertexCompiler), gsl::make_span(reinterpret_cast<uint8_t*>(vertexSpirv.data()), vertexSpirv.size() * sizeof(uint32_t)), std::move(vertexAttributeRenaming)},
+            {std::move(fragmentParser), std::move(fragmentCompiler), gsl::make_span(reinterpret_cast<uint8_t*>(fragmentSpirv.data()), fragmentSpirv.size() * sizeof(uint32_t)), {}},
+            bgfx::RendererType::Vulkan);
+        shaderInfo.PackedUniforms = std::move(packedUniforms);
+        return shaderInfo;
+    }
+}
@@ -0,0 +1,181 @@
+#include "ShaderManifest.h"
+#include "ContentHash.h"
+
+#include <Babylon/ThreadPool.h>
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace Babylon
+{
+    namespace
+    {
+        constexpr uint32_t MAGIC{0x4D53'4E42}; // "BNSM"
+        constexpr uint32_t FORMAT_VERSION{1};
+
+        uint64_t GetEntryKey(std::string_view vertexSource, std::string_view fragmentSource)
+        {
+            const std::array<uint64_t, 2> sizes{vertexSource.size(), fragmentSource.size()};
+            const uint64_t seed{ContentHash(gsl::make_span(reinterpret_cast<const uint8_t*>(sizes.data()), sizeof(sizes)))};
+            const uint64_t vertexHash{ContentHash(gsl::make_span(reinterpret_cast<const uint8_t*>(vertexSource.data()), vertexSource.size()), seed)};
+            return ContentHash(gsl::make_span(reinterpret_cast<const uint8_t*>(fragmentSource.data()), fragmentSource.size()), vertexHash);
+        }
+
+        void WriteUint32(std::ostream& stream, uint32_t value)
+        {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        void WriteEntry(std::ostream& stream, std::string_view vertexSource, std::string_view fragmentSource)
+        {
+            WriteUint32(stream, static_cast<uint32_t>(vertexSource.size()));
+            stream.write(vertexSource.data(), static_cast<std::streamsize>(vertexSource.size()));
+            WriteUint32(stream, static_cast<uint32_t>(fragmentSource.size()));
+            stream.write(fragmentSource.data(), static_cast<std::streamsize>(fragmentSource.size()));
+        }
+    }
+
+    ShaderManifest& ShaderManifest::GetDefault()
+    {
+        static ShaderManifest manifest{};
+        return manifest;
+    }
+
+    std::vector<std::pair<std::string, std::string>> ShaderManifest::ReadEntries(const std::string& path)
+    {
+        std::vector<std::pair<std::string, std::string>> entries{};
+
+        std::ifstream file{path, std::ios::binary | std::ios::ate};
+        if (!file)
+        {
+            return entries;
+        }
+
+        std::vector<char> bytes(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        if (!file.read(bytes.data(), static_cast<std::streamsize>(bytes.size())))
+        {
+            return entries;
+        }
+
+        size_t offset{0};
+        auto readUint32 = [&](uint32_t& value) {
+            if (bytes.size() - offset < sizeof(value))
+            {
+                return false;
+            }
+
+            std::memcpy(&value, bytes.data() + offset, sizeof(value));
+            offset += sizeof(value);
+            return true;
+        };
+
+        auto readString = [&](std::string& value) {
+            uint32_t size{};
+            if (!readUint32(size) || bytes.size() - offset < size)
+            {
+                return false;
+            }
+
+            value.assign(bytes.data() + offset, size);
+            offset += size;
+            return true;
+        };
+
+        uint32_t magic{};
+        uint32_t formatVersion{};
+        if (!readUint32(magic) || !readUint32(formatVersion) || magic != MAGIC || formatVersion != FORMAT_VERSION)
+        {
+            return entries;
+        }
+
+        std::string vertexSource{};
+        std::string fragmentSource{};
+        while (readString(vertexSource) && readString(fragmentSource))
+        {
+            entries.emplace_back(std::move(vertexSource), std::move(fragmentSource));
+        }
+
+        return entries;
+    }
+
+    void ShaderManifest::Enable(std::string path)
+    {
+        auto entries{ReadEntries(path)};
+
+        std::scoped_lock lock{m_mutex};
+
+        m_entries.clear();
+        m_entryKeys.clear();
+        for (auto& [vertexSource, fragmentSource] : entries)
+        {
+            if (m_entryKeys.insert(GetEntryKey(vertexSource, fragmentSource)).second)
+            {
+                m_entries.emplace_back(std::move(vertexSource), std::move(fragmentSource));
+            }
+        }
+
+        // Rewriting the file drops any truncated tail, so that later entries can simply be appended.
+        m_file = std::ofstream{path, std::ios::binary | std::ios::trunc};
+        if (!m_file)
+        {
+            throw std::runtime_error{"Unable to open shader manifest " + path};
+        }
+
+        WriteUint32(m_file, MAGIC);
+        WriteUint32(m_file, FORMAT_VERSION);
+        for (const auto& [vertexSource, fragmentSource] : m_entries)
+        {
+            WriteEntry(m_file, vertexSource, fragmentSource);
+        }
+
+        m_file.flush();
+    }
+
+    void ShaderManifest::Record(std::string_view vertexSource, std::string_view fragmentSource)
+    {
+        std::scoped_lock lock{m_mutex};
+
+        if (!m_file.is_open() || !m_entryKeys.insert(GetEntryKey(vertexSource, fragmentSource)).second)
+        {
+            return;
+        }
+
+        m_entries.emplace_back(vertexSource, fragmentSource);
+
+        // Flushed right away so that the entry survives the process being killed.
+        WriteEntry(m_file, vertexSource, fragmentSource);
+        m_file.flush();
+    }
+
+    void ShaderManifest::Prewarm(ShaderCache& cache, bgfx::RendererType::Enum renderer) const
+    {
+        // Nothing may be compiled in pack-only mode, and packs are read on demand.
+        if (cache.IsPackOnly())
+        {
+            return;
+        }
+
+        std::vector<std::pair<std::string, std::string>> entries{};
+        {
+            std::scoped_lock lock{m_mutex};
+            entries = m_entries;
+        }
+
+        // One task per program, so that programs the scene asks for meanwhile are not stuck behind the whole manifest.
+        for (auto& entry : entries)
+        {
+            ThreadPool::GetDefault().Enqueue([&cache, renderer, vertexSource{std::move(entry.first)}, fragmentSource{std::move(entry.second)}]() {
+                try
+                {
+                    cache.FindOrCompile(ShaderCache::ComputeKey(vertexSource, fragmentSource, renderer), vertexSource, fragmentSource, renderer);
+                }
+                catch (const std::exception&)
+                {
+                    // Sources that no longer compile are reported when the scene creates the program.
+                }
+            });
+        }
+    }
+}
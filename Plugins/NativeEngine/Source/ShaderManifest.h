@@ -0,0 +1,48 @@
+#pragma once
+
+#include "ShaderCache.h"
+
+#include <bgfx/bgfx.h>
+
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace Babylon
+{
+    /// Records the vertex and fragment source pairs of the programs created by the engine into a file,
+    /// so that a later run can compile them on the thread pool before any scene asks for them. Thread-safe.
+    class ShaderManifest final
+    {
+    public:
+        ShaderManifest() = default;
+
+        ShaderManifest(const ShaderManifest&) = delete;
+        ShaderManifest& operator=(const ShaderManifest&) = delete;
+
+        static ShaderManifest& GetDefault();
+
+        // Returns the vertex and fragment sources recorded in a manifest file. A missing or foreign file yields
+        // no entries, and an entry cut short by a crash while it was being appended ends the list.
+        static std::vector<std::pair<std::string, std::string>> ReadEntries(const std::string& path);
+
+        // Loads the pairs already recorded in the file, if any, and appends new pairs to it from now on.
+        void Enable(std::string path);
+
+        void Record(std::string_view vertexSource, std::string_view fragmentSource);
+
+        // Queues the compilation of every recorded pair that is not in the cache yet on the default thread
+        // pool. Results land in the cache, where the engine finds them when the programs are created.
+        void Prewarm(ShaderCache& cache, bgfx::RendererType::Enum renderer) const;
+
+    private:
+        mutable std::mutex m_mutex{};
+        std::ofstream m_file{};
+        std::vector<std::pair<std::string, std::string>> m_entries{};
+        std::unordered_set<uint64_t> m_entryKeys{};
+    };
+}
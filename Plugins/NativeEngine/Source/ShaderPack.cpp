@@ -0,0 +1,126 @@
+#include "ShaderPack.h"
+#include "ShaderCompiler.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Babylon
+{
+    namespace
+    {
+        constexpr uint32_t MAGIC{0x5053'4E42}; // "BNSP"
+        constexpr uint32_t FORMAT_VERSION{1};
+
+        struct FileHeader
+        {
+            uint32_t Magic;
+            uint32_t FormatVersion;
+            uint32_t CompilerVersion;
+            uint32_t EntryCount;
+        };
+
+        static_assert(sizeof(FileHeader) == 16);
+    }
+
+    ShaderPack::ShaderPack(std::string path)
+        : m_path{std::move(path)}
+        , m_file{m_path, std::ios::binary | std::ios::ate}
+    {
+        if (!m_file)
+        {
+            throw std::runtime_error{"Unable to open shader pack " + m_path};
+        }
+
+        const auto fileSize{static_cast<uint64_t>(m_file.tellg())};
+        m_file.seekg(0);
+
+        FileHeader header{};
+        if (!m_file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.Magic != MAGIC || header.FormatVersion != FORMAT_VERSION)
+        {
+            throw std::runtime_error{"Invalid shader pack " + m_path};
+        }
+
+        if (header.CompilerVersion != ShaderCompiler::VERSION)
+        {
+            throw std::runtime_error{"Shader pack " + m_path + " was built by another version of the shader compiler"};
+        }
+
+        const uint64_t dataOffset{sizeof(FileHeader) + uint64_t{header.EntryCount} * sizeof(IndexEntry)};
+        if (dataOffset > fileSize)
+        {
+            throw std::runtime_error{"Shader pack " + m_path + " is truncated"};
+        }
+
+        m_index.resize(header.EntryCount);
+        if (!m_file.read(reinterpret_cast<char*>(m_index.data()), static_cast<std::streamsize>(m_index.size() * sizeof(IndexEntry))))
+        {
+            throw std::runtime_error{"Shader pack " + m_path + " is truncated"};
+        }
+
+        for (size_t index = 0; index < m_index.size(); ++index)
+        {
+            const auto& entry{m_index[index]};
+            if (entry.Offset < dataOffset || entry.Offset > fileSize || entry.Size > fileSize - entry.Offset ||
+                (index > 0 && m_index[index - 1].Key >= entry.Key))
+            {
+                throw std::runtime_error{"Shader pack " + m_path + " has an invalid index"};
+            }
+        }
+    }
+
+    void ShaderPack::Write(const std::string& path, std::vector<Entry> entries)
+    {
+        std::sort(entries.begin(), entries.end(), [](const Entry& left, const Entry& right) { return left.Key < right.Key; });
+        entries.erase(std::unique(entries.begin(), entries.end(), [](const Entry& left, const Entry& right) { return left.Key == right.Key; }), entries.end());
+
+        const FileHeader header{MAGIC, FORMAT_VERSION, ShaderCompiler::VERSION, static_cast<uint32_t>(entries.size())};
+
+        std::vector<IndexEntry> index{};
+        index.reserve(entries.size());
+        uint64_t offset{sizeof(FileHeader) + entries.size() * sizeof(IndexEntry)};
+        for (const auto& entry : entries)
+        {
+            index.push_back({entry.Key, offset, entry.Bytes.size()});
+            offset += entry.Bytes.size();
+        }
+
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size() * sizeof(IndexEntry)));
+        for (const auto& entry : entries)
+        {
+            file.write(reinterpret_cast<const char*>(entry.Bytes.data()), static_cast<std::streamsize>(entry.Bytes.size()));
+        }
+
+        if (!file.flush())
+        {
+            throw std::runtime_error{"Unable to write shader pack " + path};
+        }
+    }
+
+    std::optional<std::vector<uint8_t>> ShaderPack::Read(uint64_t key)
+    {
+        const auto it{std::lower_bound(m_index.begin(), m_index.end(), key, [](const IndexEntry& entry, uint64_t value) { return entry.Key < value; })};
+        if (it == m_index.end() || it->Key != key)
+        {
+            return {};
+        }
+
+        std::vector<uint8_t> bytes(static_cast<size_t>(it->Size));
+
+        std::scoped_lock lock{m_mutex};
+        m_file.clear();
+        m_file.seekg(static_cast<std::streamoff>(it->Offset));
+        if (!m_file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+        {
+            return {};
+        }
+
+        return bytes;
+    }
+
+    size_t ShaderPack::GetEntryCount() const
+    {
+        return m_index.size();
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <gsl/gsl>
+
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Babylon
+{
+    /// A file of shaders compiled offline by the ShaderPacker tool: a header, an index sorted by cache key,
+    /// and the shaders as serialized by ShaderCache. Only the index is loaded when the pack is opened; each
+    /// shader is read from the file the first time it is looked up. Thread-safe.
+    class ShaderPack final
+    {
+    public:
+        struct Entry
+        {
+            uint64_t Key{};
+            std::vector<uint8_t> Bytes{};
+        };
+
+        // Throws if the file is missing, was produced by another compiler version or has an invalid index.
+        explicit ShaderPack(std::string path);
+
+        ShaderPack(const ShaderPack&) = delete;
+        ShaderPack& operator=(const ShaderPack&) = delete;
+
+        static void Write(const std::string& path, std::vector<Entry> entries);
+
+        std::optional<std::vector<uint8_t>> Read(uint64_t key);
+
+        size_t GetEntryCount() const;
+
+    private:
+        struct IndexEntry
+        {
+            uint64_t Key;
+            uint64_t Offset;
+            uint64_t Size;
+        };
+
+        const std::string m_path;
+
+        std::mutex m_mutex{};
+        std::ifstream m_file{};
+        std::vector<IndexEntry> m_index{};
+    };
+}
@@ -0,0 +1,98 @@
+#include "TextureCache.h"
+
+#include <algorithm>
+
+namespace Babylon
+{
+    bool TextureCache::TryAcquire(const Key& key, Callback callback)
+    {
+        auto it{m_entries.find(key)};
+        if (it != m_entries.end())
+        {
+            Entry& entry{it->second};
+            if (entry.Pending)
+            {
+                ++m_hits;
+                entry.Waiters.push_back(std::move(callback));
+                return true;
+            }
+
+            if (auto texture{entry.Shared.lock()})
+            {
+                ++m_hits;
+                m_bytesSaved += texture->Bytes;
+                callback(std::move(texture));
+                return true;
+            }
+
+            m_entries.erase(it);
+        }
+
+        ++m_misses;
+
+        if (m_entries.size() >= m_pruneThreshold)
+        {
+            PruneExpired();
+        }
+
+        m_entries[key].Pending = true;
+        return false;
+    }
+
+    void TextureCache::Complete(const Key& key, std::shared_ptr<const Texture> texture)
+    {
+        auto it{m_entries.find(key)};
+        if (it == m_entries.end())
+        {
+            return;
+        }
+
+        auto waiters{std::move(it->second.Waiters)};
+        if (texture)
+        {
+            it->second.Shared = texture;
+            it->second.Pending = false;
+            it->second.Waiters.clear();
+            m_bytesSaved += static_cast<uint64_t>(texture->Bytes) * waiters.size();
+        }
+        else
+        {
+            m_entries.erase(it);
+        }
+
+        for (auto& waiter : waiters)
+        {
+            waiter(texture);
+        }
+    }
+
+    TextureCache::Statistics TextureCache::GetStatistics() const
+    {
+        Statistics statistics{};
+        statistics.Hits = m_hits;
+        statistics.Misses = m_misses;
+        statistics.BytesSaved = m_bytesSaved;
+        statistics.Entries = static_cast<size_t>(std::count_if(m_entries.begin(), m_entries.end(), [](const auto& entry) {
+            return entry.second.Pending || !entry.second.Shared.expired();
+        }));
+        return statistics;
+    }
+
+    void TextureCache::PruneExpired()
+    {
+        for (auto it{m_entries.begin()}; it != m_entries.end();)
+        {
+            if (!it->second.Pending && it->second.Shared.expired())
+            {
+                it = m_entries.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        // Grow the threshold with the live entry count so pruning stays amortized.
+        m_pruneThreshold = std::max(MIN_PRUNE_THRESHOLD, m_entries.size() * 2);
+    }
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "TextureCompression.h"
+#include "TextureDownscale.h"
+
+#include <bgfx/bgfx.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+namespace Babylon
+{
+    /// Deduplicates textures loaded from identical encoded bytes with identical load options. Textures are
+    /// shared between every TextureData that loaded them and destroyed with the last one; the cache only
+    /// holds weak references. Loads of the same content that overlap wait for the first one instead of
+    /// decoding again. Only used from the JavaScript thread.
+    class TextureCache final
+    {
+    public:
+        struct Key
+        {
+            uint64_t Hash{};
+            size_t Size{};
+            bool GenerateMips{};
+            bool InvertY{};
+            std::optional<TextureCompression::Quality> Compression{};
+            uint32_t MaxSize{};
+            TextureDownscale::Quality DownscaleQuality{};
+
+            bool operator<(const Key& other) const
+            {
+                return std::tie(Hash, Size, GenerateMips, InvertY, Compression, MaxSize, DownscaleQuality) <
+                       std::tie(other.Hash, other.Size, other.GenerateMips, other.InvertY, other.Compression, other.MaxSize, other.DownscaleQuality);
+            }
+        };
+
+        struct Texture
+        {
+            Texture(bgfx::TextureHandle handle, uint32_t width, uint32_t height, uint32_t bytes)
+                : Handle{handle}
+                , Width{width}
+                , Height{height}
+                , Bytes{bytes}
+            {
+            }
+
+            ~Texture()
+            {
+                if (bgfx::isValid(Handle))
+                {
+                    bgfx::destroy(Handle);
+                }
+            }
+
+            Texture(const Texture&) = delete;
+            Texture& operator=(const Texture&) = delete;
+
+            const bgfx::TextureHandle Handle;
+            const uint32_t Width;
+            const uint32_t Height;
+            const uint32_t Bytes;
+            std::optional<TextureCompression::Result> Compression{};
+            std::optional<TextureDownscale::Result> Downscale{};
+        };
+
+        struct Statistics
+        {
+            uint64_t Hits{};
+            uint64_t Misses{};
+            size_t Entries{};
+            uint64_t BytesSaved{};
+        };
+
+        // Receives the shared texture, or nullptr if the load it waited on failed.
+        using Callback = std::function<void(std::shared_ptr<const Texture>)>;
+
+        /// Returns true if the key is served by the cache, in which case callback is invoked, either
+        /// immediately or once the pending load of the same key completes. Returns false on a miss, in which
+        /// case the caller must load the texture and report it through Complete.
+        bool TryAcquire(const Key& key, Callback callback);
+
+        /// Publishes the result of a load that missed; texture is nullptr if the load failed.
+        void Complete(const Key& key, std::shared_ptr<const Texture> texture);
+
+        Statistics GetStatistics() const;
+
+    private:
+        struct Entry
+        {
+            std::weak_ptr<const Texture> Shared{};
+            bool Pending{};
+            std::vector<Callback> Waiters{};
+        };
+
+        void PruneExpired();
+
+        static constexpr size_t MIN_PRUNE_THRESHOLD{64};
+
+        std::map<Key, Entry> m_entries{};
+        size_t m_pruneThreshold{MIN_PRUNE_THRESHOLD};
+        uint64_t m_hits{};
+        uint64_t m_misses{};
+        uint64_t m_bytesSaved{};
+    };
+}
@@ -0,0 +1,128 @@
+#include "TextureCompression.h"
+
+#include <bimg/encode.h>
+#include <bx/error.h>
+
+#include <array>
+#include <chrono>
+
+namespace Babylon::TextureCompression
+{
+    namespace
+    {
+        constexpr uint32_t BLOCK_SIZE{4};
+
+        bimg::Quality::Enum ToBimgQuality(Quality quality)
+        {
+            switch (quality)
+            {
+                case Quality::Fastest: return bimg::Quality::Fastest;
+                case Quality::Highest: return bimg::Quality::Highest;
+                default: return bimg::Quality::Default;
+            }
+        }
+
+        bool UsesAlpha(const bimg::ImageContainer& rgba)
+        {
+            const auto* pixels{static_cast<const uint8_t*>(rgba.m_data)};
+            for (uint32_t offset = 3; offset < rgba.m_size; offset += 4)
+            {
+                if (pixels[offset] != 0xFF)
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        std::optional<bimg::TextureFormat::Enum> SelectFormat(bool alpha, Quality quality, const std::function<bool(bimg::TextureFormat::Enum)>& isFormatSupported)
+        {
+            // BC7 is much slower to encode than BC1/BC3, so it is only considered when quality is preferred over speed.
+            const std::array<bimg::TextureFormat::Enum, 3> candidates{
+                bimg::TextureFormat::BC7,
+                alpha ? bimg::TextureFormat::BC3 : bimg::TextureFormat::BC1,
+                alpha ? bimg::TextureFormat::ETC2A : bimg::TextureFormat::ETC2};
+
+            for (const auto format : candidates)
+            {
+                if (format == bimg::TextureFormat::BC7 && quality != Quality::Highest)
+                {
+                    continue;
+                }
+
+                if (isFormatSupported(format))
+                {
+                    return format;
+                }
+            }
+
+            return {};
+        }
+    }
+
+    std::optional<Result> Compress(bx::AllocatorI* allocator, bimg::ImageContainer** image, Quality quality, const std::function<bool(bimg::TextureFormat::Enum)>& isFormatSupported)
+    {
+        bimg::ImageContainer* input{*image};
+        if (bimg::isCompressed(input->m_format) || input->m_width % BLOCK_SIZE != 0 || input->m_height % BLOCK_SIZE != 0 || input->m_depth > 1 || input->m_numLayers > 1 || input->m_cubeMap)
+        {
+            return {};
+        }
+
+        const auto startTime{std::chrono::steady_clock::now()};
+
+        // The encoders take RGBA8 input.
+        bimg::ImageContainer* rgba{input->m_format == bimg::TextureFormat::RGBA8 ? input : bimg::imageConvert(allocator, bimg::TextureFormat::RGBA8, *input)};
+        if (rgba == nullptr)
+        {
+            return {};
+        }
+
+        const auto format{SelectFormat(UsesAlpha(*rgba), quality, isFormatSupported)};
+        if (!format)
+        {
+            if (rgba != input)
+            {
+                bimg::imageFree(rgba);
+            }
+
+            return {};
+        }
+
+        bimg::ImageContainer* output{bimg::imageAlloc(allocator, format.value(), static_cast<uint16_t>(rgba->m_width), static_cast<uint16_t>(rgba->m_height), 1, 1, false, rgba->m_numMips > 1)};
+
+        bx::Error error{};
+        for (uint8_t level = 0; level < rgba->m_numMips && error.isOk(); ++level)
+        {
+            bimg::ImageMip source{};
+            bimg::imageGetRawData(*rgba, 0, level, rgba->m_data, rgba->m_size, source);
+
+            bimg::ImageMip destination{};
+            bimg::imageGetRawData(*output, 0, level, output->m_data, output->m_size, destination);
+
+            bimg::imageEncodeFromRgba8(allocator, const_cast<uint8_t*>(destination.m_data), source.m_data, source.m_width, source.m_height, 1, format.value(), ToBimgQuality(quality), &error);
+        }
+
+        if (rgba != input)
+        {
+            bimg::imageFree(rgba);
+        }
+
+        if (!error.isOk())
+        {
+            bimg::imageFree(output);
+            return {};
+        }
+
+        Result result{};
+        result.Format = format.value();
+        result.UncompressedBytes = input->m_size;
+        result.CompressedBytes = output->m_size;
+        result.TimeMs = std::chrono::duration<double, std::milli>{std::chrono::steady_clock::now() - startTime}.count();
+
+        bimg::imageFree(input);
+        *image = output;
+
+        return result;
+    }
+}
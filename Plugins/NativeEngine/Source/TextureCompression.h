@@ -0,0 +1,31 @@
+#pragma once
+
+#include <bimg/bimg.h>
+#include <bx/allocator.h>
+
+#include <functional>
+#include <optional>
+
+namespace Babylon::TextureCompression
+{
+    enum class Quality
+    {
+        Fastest,
+        Default,
+        Highest,
+    };
+
+    struct Result
+    {
+        bimg::TextureFormat::Enum Format{};
+        uint32_t UncompressedBytes{};
+        uint32_t CompressedBytes{};
+        double TimeMs{};
+    };
+
+    // Block-compresses an uncompressed image (including its mip chain) into the best format for which
+    // isFormatSupported returns true: BC7 (highest quality only), then BC3/BC1, then ETC2A/ETC2, picked by
+    // whether the image uses alpha. Returns nothing and leaves the image untouched when the image is
+    // already compressed, its dimensions are not multiples of the 4x4 block size, or no format is supported.
+    std::optional<Result> Compress(bx::AllocatorI* allocator, bimg::ImageContainer** image, Quality quality, const std::function<bool(bimg::TextureFormat::Enum)>& isFormatSupported);
+}
@@ -0,0 +1,204 @@
+#include "TextureDecoder.h"
+#include "Ktx2.h"
+#include "MipGenerator.h"
+
+#include <bimg/decode.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace Babylon::TextureDecoder
+{
+    namespace
+    {
+        // Copies the first mip of a single-mip image into the first mip of another image of the same size,
+        // optionally flipping rows and expanding R8 luminance to RGB8 on the way, so each texel is written once.
+        void CopyFirstMip(const bimg::ImageContainer& source, bimg::ImageContainer& destination, bool invertY)
+        {
+            bimg::ImageMip sourceMip{};
+            bimg::imageGetRawData(source, 0, 0, source.m_data, source.m_size, sourceMip);
+
+            bimg::ImageMip destinationMip{};
+            bimg::imageGetRawData(destination, 0, 0, destination.m_data, destination.m_size, destinationMip);
+
+            const bool expandLuminance = source.m_format == bimg::TextureFormat::R8 && destination.m_format == bimg::TextureFormat::RGB8;
+            const uint32_t rowCount = sourceMip.m_height;
+            const uint32_t sourcePitch = sourceMip.m_size / rowCount;
+            const uint32_t destinationPitch = destinationMip.m_size / rowCount;
+
+            for (uint32_t row = 0; row < rowCount; row++)
+            {
+                const uint8_t* sourceRow = sourceMip.m_data + (invertY ? rowCount - row - 1 : row) * sourcePitch;
+                uint8_t* destinationRow = const_cast<uint8_t*>(destinationMip.m_data) + row * destinationPitch;
+
+                if (expandLuminance)
+                {
+                    for (uint32_t x = 0; x < sourcePitch; x++)
+                    {
+                        destinationRow[x * 3 + 0] = sourceRow[x];
+                        destinationRow[x * 3 + 1] = sourceRow[x];
+                        destinationRow[x * 3 + 2] = sourceRow[x];
+                    }
+                }
+                else
+                {
+                    std::memcpy(destinationRow, sourceRow, destinationPitch);
+                }
+            }
+        }
+    }
+
+    void FlipY(bimg::ImageContainer* image)
+    {
+        // Block-compressed images are used as authored, as WebGL does for compressed uploads: reordering their block
+        // rows would still leave the texels inside each block upside down.
+        if (bimg::isCompressed(image->m_format))
+        {
+            return;
+        }
+
+        std::vector<uint8_t> buffer{};
+
+        const uint32_t sides = static_cast<uint32_t>(image->m_numLayers) * (image->m_cubeMap ? 6 : 1);
+        for (uint32_t side = 0; side < sides; side++)
+        {
+            for (uint8_t lod = 0; lod < image->m_numMips; lod++)
+            {
+                bimg::ImageMip mip{};
+                bimg::imageGetRawData(*image, static_cast<uint16_t>(side), lod, image->m_data, image->m_size, mip);
+
+                const uint32_t sliceSize = mip.m_size / mip.m_depth;
+                const uint32_t rowCount = mip.m_height;
+                const uint32_t rowPitch = sliceSize / rowCount;
+                buffer.resize(rowPitch);
+
+                for (uint32_t slice = 0; slice < mip.m_depth; slice++)
+                {
+                    uint8_t* bytes = const_cast<uint8_t*>(mip.m_data) + slice * sliceSize;
+
+                    for (size_t row = 0; row < rowCount / 2; row++)
+                    {
+                        auto frontPtr = bytes + (row * rowPitch);
+                        auto backPtr = bytes + ((rowCount - row - 1) * rowPitch);
+
+                        std::memcpy(buffer.data(), frontPtr, rowPitch);
+                        std::memcpy(frontPtr, backPtr, rowPitch);
+                        std::memcpy(backPtr, buffer.data(), rowPitch);
+                    }
+                }
+            }
+        }
+    }
+
+    void GenerateMips(bx::AllocatorI* allocator, bimg::ImageContainer** image)
+    {
+        bimg::ImageContainer* input = *image;
+
+        // Formats the native generator handles are filtered in place without converting to RGBA8.
+        bimg::ImageContainer* output = MipGenerator::Generate(allocator, *input);
+        if (output == nullptr)
+        {
+            output = bimg::imageGenerateMips(allocator, *input);
+        }
+
+        if (output == nullptr)
+        {
+            bimg::TextureFormat::Enum format = input->m_format;
+            bimg::ImageContainer* rgba = bimg::imageConvert(allocator, bimg::TextureFormat::RGBA8, *input, false);
+            bimg::imageFree(input);
+            bimg::ImageContainer* mips = bimg::imageGenerateMips(allocator, *rgba);
+            bimg::imageFree(rgba);
+            output = bimg::imageConvert(allocator, format, *mips);
+            bimg::imageFree(mips);
+        }
+        else
+        {
+            bimg::imageFree(input);
+        }
+
+        *image = output;
+    }
+
+    bimg::ImageContainer* Decode(bx::AllocatorI* allocator, gsl::span<const uint8_t> data, bool invertY, bool generateMips, const std::function<bool(bimg::TextureFormat::Enum)>& isFormatSupported,
+        const std::optional<TextureDownscale::Settings>& downscale, std::optional<TextureDownscale::Result>* downscaleResult)
+    {
+        bimg::ImageContainer* image = Ktx2::IsKtx2(data) ? Ktx2::Parse(allocator, data, isFormatSupported) : bimg::imageParse(allocator, data.data(), static_cast<uint32_t>(data.size()));
+        if (image == nullptr)
+        {
+            throw std::runtime_error("Unable to decode image."); // exception will be forwarded to JS
+        }
+
+        if (!isFormatSupported(image->m_format))
+        {
+            // Typically a GPU compressed format the backend cannot sample; decode it to RGBA8 instead.
+            bimg::ImageContainer* rgba = bimg::imageConvert(allocator, bimg::TextureFormat::RGBA8, *image);
+            if (rgba == nullptr)
+            {
+                bimg::imageFree(image);
+                throw std::runtime_error("Image format is not supported by the renderer.");
+            }
+
+            bimg::imageFree(image);
+            image = rgba;
+        }
+
+        // Shrink before any other processing so that conversion and mip generation work on the reduced size.
+        if (downscale)
+        {
+            auto result = TextureDownscale::Downscale(allocator, &image, downscale.value());
+            if (downscaleResult != nullptr)
+            {
+                *downscaleResult = result;
+            }
+        }
+
+        // Images with only 1 channel are interpreted as luminance textures with RGB containing the same value as R and alpha as 255.
+        const bool expandLuminance = image->m_format == bimg::TextureFormat::R8;
+        const bimg::TextureFormat::Enum format = expandLuminance ? bimg::TextureFormat::RGB8 : image->m_format;
+
+        // Compressed images cannot be mipmapped without re-encoding, so they are used as authored.
+        const bool needsMips = generateMips && image->m_numMips <= 1 && !bimg::isCompressed(format);
+
+        const bool singleImage = image->m_numMips == 1 && image->m_numLayers == 1 && image->m_depth == 1 && !image->m_cubeMap;
+
+        if (singleImage && (expandLuminance || (needsMips && MipGenerator::IsSupported(format))))
+        {
+            // Copy the decoded pixels once into the final buffer (with room for the mip chain), flipping and
+            // expanding as needed, then fill in the mips in place.
+            bimg::ImageContainer* output = bimg::imageAlloc(allocator, format, static_cast<uint16_t>(image->m_width), static_cast<uint16_t>(image->m_height), 1, 1, false, needsMips);
+            CopyFirstMip(*image, *output, invertY);
+            bimg::imageFree(image);
+            image = output;
+
+            if (needsMips)
+            {
+                MipGenerator::GenerateInPlace(*image);
+            }
+
+            return image;
+        }
+
+        if (expandLuminance)
+        {
+            // To emulate luminance, the format is switched to alpha8 and converted to RGB8 when packing and unpacking take care of
+            // component swizzling.
+            image->m_format = bimg::TextureFormat::A8;
+            bimg::ImageContainer* rgb = bimg::imageConvert(allocator, bimg::TextureFormat::RGB8, *image, false);
+            bimg::imageFree(image);
+            image = rgb;
+        }
+
+        if (invertY)
+        {
+            FlipY(image);
+        }
+
+        if (needsMips)
+        {
+            GenerateMips(allocator, &image);
+        }
+
+        return image;
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "TextureDownscale.h"
+
+#include <bimg/bimg.h>
+#include <bx/allocator.h>
+#include <gsl/gsl>
+
+#include <functional>
+#include <optional>
+
+namespace Babylon::TextureDecoder
+{
+    // Flips the rows of every mip, layer, face and slice of an image in place. Block-compressed images are left
+    // as they are, since flipping them would need their blocks decoded.
+    void FlipY(bimg::ImageContainer* image);
+
+    // Replaces a single-mip image with one that has a full mip chain, in the same format.
+    void GenerateMips(bx::AllocatorI* allocator, bimg::ImageContainer** image);
+
+    // Decodes an encoded image (anything bimg parses, or KTX2) into the image a texture is created from:
+    // decoded to RGBA8 if isFormatSupported rejects its format, shrunk to the downscale settings, R8 expanded
+    // to RGB8 luminance, flipped if invertY is set (unless block-compressed) and given a mip chain if generateMips is set and it has
+    // none. Throws if the data cannot be decoded.
+    bimg::ImageContainer* Decode(bx::AllocatorI* allocator, gsl::span<const uint8_t> data, bool invertY, bool generateMips, const std::function<bool(bimg::TextureFormat::Enum)>& isFormatSupported,
+        const std::optional<TextureDownscale::Settings>& downscale = {}, std::optional<TextureDownscale::Result>* downscaleResult = nullptr);
+}
@@ -0,0 +1,136 @@
+#include "TextureDiskCache.h"
+#include "Ktx2.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+
+namespace Babylon
+{
+    namespace
+    {
+        std::mutex s_defaultMutex{};
+        std::shared_ptr<TextureDiskCache> s_default{};
+
+        // KTX2 key/value entries holding the metadata. Keys without the "KTX" prefix are application defined.
+        constexpr const char* COMPRESSION_KEY{"BabylonNative.Compression"};
+        constexpr const char* DOWNSCALE_KEY{"BabylonNative.Downscale"};
+
+        // The results are stored as raw bytes; they are only read back by the same build, since the cache
+        // key changes with the pipeline version.
+        template<typename T>
+        void StoreValue(Ktx2::KeyValues& keyValues, const char* key, const std::optional<T>& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            if (value)
+            {
+                auto& bytes{keyValues[key]};
+                bytes.resize(sizeof(T));
+                std::memcpy(bytes.data(), &value.value(), sizeof(T));
+            }
+        }
+
+        template<typename T>
+        std::optional<T> LoadValue(const Ktx2::KeyValues& keyValues, const char* key)
+        {
+            const auto it{keyValues.find(key)};
+            if (it == keyValues.end())
+            {
+                return {};
+            }
+
+            if (it->second.size() != sizeof(T))
+            {
+                throw std::runtime_error{"Texture disk cache metadata is malformed."};
+            }
+
+            T value{};
+            std::memcpy(&value, it->second.data(), sizeof(T));
+            return value;
+        }
+    }
+
+    TextureDiskCache::TextureDiskCache(std::string directory, uint64_t maxBytes)
+        : m_cache{std::move(directory), ".ktx2", maxBytes}
+    {
+    }
+
+    void TextureDiskCache::Configure(std::string directory, uint64_t maxBytes)
+    {
+        auto cache{std::make_shared<TextureDiskCache>(std::move(directory), maxBytes)};
+        std::scoped_lock lock{s_defaultMutex};
+        s_default = std::move(cache);
+    }
+
+    std::shared_ptr<TextureDiskCache> TextureDiskCache::GetDefault()
+    {
+        std::scoped_lock lock{s_defaultMutex};
+        return s_default;
+    }
+
+    bimg::ImageContainer* TextureDiskCache::Load(bx::AllocatorI* allocator, uint64_t key, Metadata& metadata)
+    {
+        const auto data{m_cache.Read(key)};
+        if (!data)
+        {
+            return nullptr;
+        }
+
+        try
+        {
+            Ktx2::KeyValues keyValues{};
+            bimg::ImageContainer* image{Ktx2::Parse(allocator, data.value(), {}, &keyValues)};
+            try
+            {
+                metadata.Compression = LoadValue<TextureCompression::Result>(keyValues, COMPRESSION_KEY);
+                metadata.Downscale = LoadValue<TextureDownscale::Result>(keyValues, DOWNSCALE_KEY);
+            }
+            catch (...)
+            {
+                bimg::imageFree(image);
+                throw;
+            }
+
+            return image;
+        }
+        catch (const std::exception&)
+        {
+            // Corrupt; drop it so the texture gets decoded and stored again.
+            m_cache.Remove(key);
+            return nullptr;
+        }
+    }
+
+    void TextureDiskCache::Store(uint64_t key, const bimg::ImageContainer& image, const Metadata& metadata)
+    {
+        if (!Ktx2::CanWrite(image.m_format) || image.m_depth > 1 || image.m_numLayers > 1 || image.m_cubeMap)
+        {
+            return;
+        }
+
+        // Ktx2::Parse only accepts complete mip chains.
+        uint32_t fullMipCount{1};
+        for (uint32_t size = std::max(image.m_width, image.m_height); size > 1; size /= 2)
+        {
+            ++fullMipCount;
+        }
+
+        if (image.m_numMips > 1 && image.m_numMips != fullMipCount)
+        {
+            return;
+        }
+
+        Ktx2::KeyValues keyValues{};
+        StoreValue(keyValues, COMPRESSION_KEY, metadata.Compression);
+        StoreValue(keyValues, DOWNSCALE_KEY, metadata.Downscale);
+
+        m_cache.Write(key, Ktx2::Write(image, keyValues));
+    }
+
+    TextureDiskCache::Statistics TextureDiskCache::GetStatistics() const
+    {
+        return m_cache.GetStatistics();
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "DiskCache.h"
+#include "TextureCompression.h"
+#include "TextureDownscale.h"
+
+#include <bimg/bimg.h>
+#include <bx/allocator.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace Babylon
+{
+    /// Persistent cache of decoded, upload-ready textures (already flipped, converted, mipmapped and
+    /// optionally compressed), stored as KTX2 files keyed by a hash of the encoded content and load options.
+    /// Thread-safe.
+    class TextureDiskCache final
+    {
+    public:
+        using Statistics = DiskCache::Statistics;
+
+        // What the decode pipeline did to produce a cached image, stored alongside it so that hits report
+        // the same results as the original load.
+        struct Metadata
+        {
+            std::optional<TextureCompression::Result> Compression{};
+            std::optional<TextureDownscale::Result> Downscale{};
+        };
+
+        TextureDiskCache(std::string directory, uint64_t maxBytes);
+
+        // Sets the process-wide cache used by engines created afterwards. The directory must exist.
+        static void Configure(std::string directory, uint64_t maxBytes);
+        static std::shared_ptr<TextureDiskCache> GetDefault();
+
+        // Returns the cached image for the key and fills in its metadata, or returns nullptr on a miss.
+        bimg::ImageContainer* Load(bx::AllocatorI* allocator, uint64_t key, Metadata& metadata);
+
+        // Stores the image unless its format or mip chain cannot be written; failures are ignored.
+        void Store(uint64_t key, const bimg::ImageContainer& image, const Metadata& metadata);
+
+        Statistics GetStatistics() const;
+
+    private:
+        DiskCache m_cache;
+    };
+}
@@ -0,0 +1,171 @@
+#include "TextureDownscale.h"
+#include "MipGenerator.h"
+
+#include <stb/stb_image_resize.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace Babylon::TextureDownscale
+{
+    namespace
+    {
+        stbir_filter ToFilter(Quality quality)
+        {
+            switch (quality)
+            {
+                case Quality::Fastest: return STBIR_FILTER_BOX;
+                case Quality::Highest: return STBIR_FILTER_MITCHELL;
+                default: return STBIR_FILTER_TRIANGLE;
+            }
+        }
+
+        bool Fits(uint32_t width, uint32_t height, uint32_t maxSize)
+        {
+            return width <= maxSize && height <= maxSize;
+        }
+
+        bimg::ImageContainer* DropMips(bx::AllocatorI* allocator, const bimg::ImageContainer& input, uint32_t maxSize)
+        {
+            uint8_t firstLod{0};
+            bimg::ImageMip mip{};
+            do
+            {
+                bimg::imageGetRawData(input, 0, firstLod, input.m_data, input.m_size, mip);
+            } while (!Fits(mip.m_width, mip.m_height, maxSize) && ++firstLod < input.m_numMips);
+
+            if (firstLod == input.m_numMips)
+            {
+                return nullptr;
+            }
+
+            // Textures are created with either one level or a full chain, so a source chain that stops before 1x1
+            // has its missing levels generated. Where they cannot be, only the first level is kept.
+            const uint8_t sourceLods{static_cast<uint8_t>(input.m_numMips - firstLod)};
+            bimg::ImageContainer* output{bimg::imageAlloc(allocator, input.m_format, static_cast<uint16_t>(mip.m_width), static_cast<uint16_t>(mip.m_height), 1, 1, false, sourceLods > 1)};
+            const bool generateTail{sourceLods < output->m_numMips && MipGenerator::IsSupported(output->m_format)};
+            if (sourceLods < output->m_numMips && !generateTail)
+            {
+                bimg::imageFree(output);
+                output = bimg::imageAlloc(allocator, input.m_format, static_cast<uint16_t>(mip.m_width), static_cast<uint16_t>(mip.m_height), 1, 1, false, false);
+            }
+
+            for (uint8_t lod = 0; lod < std::min(sourceLods, output->m_numMips); ++lod)
+            {
+                bimg::ImageMip source{};
+                bimg::imageGetRawData(input, 0, static_cast<uint8_t>(firstLod + lod), input.m_data, input.m_size, source);
+
+                bimg::ImageMip destination{};
+                bimg::imageGetRawData(*output, 0, lod, output->m_data, output->m_size, destination);
+                std::memcpy(const_cast<uint8_t*>(destination.m_data), source.m_data, std::min(source.m_size, destination.m_size));
+            }
+
+            if (generateTail)
+            {
+                MipGenerator::GenerateInPlace(*output, sourceLods);
+            }
+
+            return output;
+        }
+
+        bool ResizeUnorm8(const bimg::ImageContainer& input, bimg::ImageContainer& output, int channels, int alphaChannel, stbir_filter filter)
+        {
+            return stbir_resize_uint8_generic(static_cast<const unsigned char*>(input.m_data), static_cast<int>(input.m_width), static_cast<int>(input.m_height), 0,
+                       static_cast<unsigned char*>(output.m_data), static_cast<int>(output.m_width), static_cast<int>(output.m_height), 0,
+                       channels, alphaChannel, 0, STBIR_EDGE_CLAMP, filter, STBIR_COLORSPACE_LINEAR, nullptr) != 0;
+        }
+
+        bool ResizeFloat(const bimg::ImageContainer& input, bimg::ImageContainer& output, int channels, int alphaChannel, stbir_filter filter)
+        {
+            return stbir_resize_float_generic(static_cast<const float*>(input.m_data), static_cast<int>(input.m_width), static_cast<int>(input.m_height), 0,
+                       static_cast<float*>(output.m_data), static_cast<int>(output.m_width), static_cast<int>(output.m_height), 0,
+                       channels, alphaChannel, 0, STBIR_EDGE_CLAMP, filter, STBIR_COLORSPACE_LINEAR, nullptr) != 0;
+        }
+
+        bimg::ImageContainer* Resample(bx::AllocatorI* allocator, const bimg::ImageContainer& input, uint32_t maxSize, Quality quality)
+        {
+            const uint32_t largest{std::max(input.m_width, input.m_height)};
+            const uint32_t width{std::max<uint32_t>(1, static_cast<uint32_t>(uint64_t{input.m_width} * maxSize / largest))};
+            const uint32_t height{std::max<uint32_t>(1, static_cast<uint32_t>(uint64_t{input.m_height} * maxSize / largest))};
+            const stbir_filter filter{ToFilter(quality)};
+
+            bimg::ImageContainer* output{bimg::imageAlloc(allocator, input.m_format, static_cast<uint16_t>(width), static_cast<uint16_t>(height), 1, 1, false, false)};
+
+            bool resized{false};
+            switch (input.m_format)
+            {
+                case bimg::TextureFormat::R8:
+                case bimg::TextureFormat::A8: resized = ResizeUnorm8(input, *output, 1, STBIR_ALPHA_CHANNEL_NONE, filter); break;
+                case bimg::TextureFormat::RG8: resized = ResizeUnorm8(input, *output, 2, STBIR_ALPHA_CHANNEL_NONE, filter); break;
+                case bimg::TextureFormat::RGB8: resized = ResizeUnorm8(input, *output, 3, STBIR_ALPHA_CHANNEL_NONE, filter); break;
+                case bimg::TextureFormat::RGBA8:
+                case bimg::TextureFormat::BGRA8: resized = ResizeUnorm8(input, *output, 4, 3, filter); break;
+                case bimg::TextureFormat::R32F: resized = ResizeFloat(input, *output, 1, STBIR_ALPHA_CHANNEL_NONE, filter); break;
+                case bimg::TextureFormat::RGBA32F: resized = ResizeFloat(input, *output, 4, 3, filter); break;
+                default:
+                {
+                    // Any other uncompressed format goes through RGBA32F so that HDR content keeps its range.
+                    bimg::ImageContainer* rgba{bimg::imageConvert(allocator, bimg::TextureFormat::RGBA32F, input)};
+                    if (rgba != nullptr)
+                    {
+                        bimg::ImageContainer* resizedRgba{bimg::imageAlloc(allocator, bimg::TextureFormat::RGBA32F, static_cast<uint16_t>(width), static_cast<uint16_t>(height), 1, 1, false, false)};
+                        if (ResizeFloat(*rgba, *resizedRgba, 4, 3, filter))
+                        {
+                            resized = bimg::imageConvert(allocator, output->m_data, output->m_format, resizedRgba->m_data, bimg::TextureFormat::RGBA32F, width, height, 1);
+                        }
+
+                        bimg::imageFree(resizedRgba);
+                        bimg::imageFree(rgba);
+                    }
+                    break;
+                }
+            }
+
+            if (!resized)
+            {
+                bimg::imageFree(output);
+                return nullptr;
+            }
+
+            return output;
+        }
+    }
+
+    std::optional<Result> Downscale(bx::AllocatorI* allocator, bimg::ImageContainer** image, const Settings& settings)
+    {
+        bimg::ImageContainer* input{*image};
+        if (settings.MaxSize == 0 || Fits(input->m_width, input->m_height, settings.MaxSize) || input->m_depth > 1 || input->m_numLayers > 1 || input->m_cubeMap)
+        {
+            return {};
+        }
+
+        const auto startTime{std::chrono::steady_clock::now()};
+
+        bimg::ImageContainer* output{nullptr};
+        if (input->m_numMips > 1)
+        {
+            output = DropMips(allocator, *input, settings.MaxSize);
+        }
+        else if (!bimg::isCompressed(input->m_format))
+        {
+            output = Resample(allocator, *input, settings.MaxSize, settings.ResampleQuality);
+        }
+
+        if (output == nullptr)
+        {
+            return {};
+        }
+
+        Result result{};
+        result.OriginalWidth = input->m_width;
+        result.OriginalHeight = input->m_height;
+        result.OriginalBytes = input->m_size;
+        result.Bytes = output->m_size;
+        result.TimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+        bimg::imageFree(input);
+        *image = output;
+        return result;
+    }
+}
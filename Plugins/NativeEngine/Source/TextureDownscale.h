@@ -0,0 +1,38 @@
+#pragma once
+
+#include <bimg/bimg.h>
+#include <bx/allocator.h>
+
+#include <optional>
+
+namespace Babylon::TextureDownscale
+{
+    enum class Quality
+    {
+        Fastest,
+        Default,
+        Highest,
+    };
+
+    struct Settings
+    {
+        uint32_t MaxSize{};
+        Quality ResampleQuality{Quality::Default};
+    };
+
+    struct Result
+    {
+        uint32_t OriginalWidth{};
+        uint32_t OriginalHeight{};
+        uint32_t OriginalBytes{};
+        uint32_t Bytes{};
+        double TimeMs{};
+    };
+
+    // Shrinks a 2D image so that neither dimension exceeds settings.MaxSize, keeping its aspect ratio.
+    // Images that already have a mip chain (including compressed ones) drop their largest mips instead of
+    // being resampled. Uncompressed single-mip images are resampled with a box (fastest), triangle (default)
+    // or Mitchell (highest) filter. Returns nothing and leaves the image untouched when it already fits or
+    // cannot be shrunk, such as compressed images without mips.
+    std::optional<Result> Downscale(bx::AllocatorI* allocator, bimg::ImageContainer** image, const Settings& settings);
+}